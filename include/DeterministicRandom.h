@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+// Seeded random number generator with a fixed, platform independent sequence
+// (xorshift64*). Used by the simulation instead of rand()/GetRandomValue so
+// that deterministic runs and replays produce identical results.
+class DeterministicRandom {
+public:
+    explicit DeterministicRandom(std::uint64_t seed = 1) { setSeed(seed); }
+
+    void setSeed(std::uint64_t seed) {
+        // splitmix64 scramble so small seeds still give a well mixed state
+        std::uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        state = z ^ (z >> 31);
+        if (state == 0) state = 0x9E3779B97F4A7C15ull;
+    }
+
+    std::uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    // Uniform float in [0, 1)
+    float nextFloat() {
+        return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f);
+    }
+
+    // Uniform integer in [min, max]
+    int range(int min, int max) {
+        if (max <= min) return min;
+        std::uint64_t span = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min) + 1;
+        return static_cast<int>(min + static_cast<std::int64_t>(next() % span));
+    }
+
+    std::uint64_t getState() const { return state; }
+    void setState(std::uint64_t value) { state = value; }
+
+private:
+    std::uint64_t state;
+};
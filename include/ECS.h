@@ -2,10 +2,25 @@
 
 #include <entt/entt.hpp>
 #include "raylib.h"
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
-// Component definitions
+class FrameArena;
+class Prefab;
+struct RenderFrame;
+class SnapshotRing;
+class SpriteAtlas;
+class WorldSerializer;
+
+// Component definitions. Hot components are read by the per-tick and
+// per-frame loops: they stay small and trivially copyable (checked below), so
+// those loops touch few cache lines and snapshots and world files copy their
+// pools with memcpy. Strings and GPU resources live in cold components or in
+// the ECSSystem's side storage.
 struct ECSTransform {
     Vector2 position = {0.0f, 0.0f};
     float rotation = 0.0f;
@@ -17,17 +32,24 @@ struct Velocity {
     float angular = 0.0f;
 };
 
+// 2D fill colour; the entity's CircleShape or BoxShape pool decides what is drawn
 struct Renderable {
     Color color = WHITE;
-    float radius = 20.0f;  // For circles
-    bool isCircle = true;
-    Rectangle rect = {0, 0, 40, 40};  // For rectangles
 };
 
+struct CircleShape {
+    float radius = 20.0f;
+};
+
+// Axis-aligned rectangle centred on the transform
+struct BoxShape {
+    Vector2 size = {40.0f, 40.0f};
+};
+
+// Handle into the ECSSystem's model table, which owns the raylib Model and its path
 struct Model3D {
-    Model model;
-    bool isLoaded = false;
-    std::string modelPath = "";
+    static constexpr std::uint32_t InvalidModel = 0xFFFFFFFFu;
+    std::uint32_t model = InvalidModel;
     float scale = 1.0f;
 };
 
@@ -39,12 +61,51 @@ struct Alien3D {
 
 struct Player {
     float speed = 200.0f;
+};
+
+// Cold: only read by tools and world files
+struct PlayerName {
     std::string name = "Player";
 };
 
+// Position captured by updateNetworkSync; the message is formatted when sent
 struct Networked {
     bool needsSync = false;
-    std::string lastSyncData = "";
+    Vector2 syncPosition = {0.0f, 0.0f};
+};
+
+// Collision shape centred on the transform; boxes stay axis-aligned
+struct Collider {
+    bool isCircle = true;
+    float radius = 20.0f;
+    Vector2 halfExtents = {20.0f, 20.0f};
+    float restitution = 0.2f;
+};
+
+// Makes a collider dynamic; colliders without a body are never pushed, though
+// one with a Velocity still moves and pushes bodies out of its way. The sleep
+// state lives here so snapshots and world files capture it.
+struct RigidBody {
+    float inverseMass = 1.0f;
+    float sleepTime = 0.0f;  // seconds spent below the sleep speed
+    bool sleeping = false;
+};
+
+// Steered by the NavigationSystem, which writes Velocity each tick along the
+// flow field of the goal and away from nearby agents
+struct NavAgent {
+    std::uint32_t goal = 0;
+    float speed = 60.0f;
+    float radius = 12.0f;
+};
+
+// Textured quad from a SpriteAtlas region, centred on the entity's transform.
+// Drawn in screen space after the 3D pass, back to front by layer.
+struct Sprite {
+    std::uint32_t region = 0;
+    std::int16_t layer = 0;
+    Color tint = WHITE;
+    float scale = 1.0f;
 };
 
 struct CameraFollow {
@@ -54,6 +115,60 @@ struct CameraFollow {
     float smoothness = 5.0f;  // Camera follow smoothness
 };
 
+template<typename Component>
+constexpr bool IsHotComponent = std::is_trivially_copyable_v<Component> && sizeof(Component) <= 32;
+
+static_assert(IsHotComponent<ECSTransform>, "ECSTransform must stay small and trivially copyable");
+static_assert(IsHotComponent<Velocity>, "Velocity must stay small and trivially copyable");
+static_assert(IsHotComponent<Renderable>, "Renderable must stay small and trivially copyable");
+static_assert(IsHotComponent<CircleShape>, "CircleShape must stay small and trivially copyable");
+static_assert(IsHotComponent<BoxShape>, "BoxShape must stay small and trivially copyable");
+static_assert(IsHotComponent<Model3D>, "Model3D must stay small and trivially copyable");
+static_assert(IsHotComponent<Alien3D>, "Alien3D must stay small and trivially copyable");
+static_assert(IsHotComponent<Player>, "Player must stay small and trivially copyable");
+static_assert(IsHotComponent<Networked>, "Networked must stay small and trivially copyable");
+static_assert(IsHotComponent<Collider>, "Collider must stay small and trivially copyable");
+static_assert(IsHotComponent<RigidBody>, "RigidBody must stay small and trivially copyable");
+static_assert(IsHotComponent<NavAgent>, "NavAgent must stay small and trivially copyable");
+static_assert(IsHotComponent<Sprite>, "Sprite must stay small and trivially copyable");
+static_assert(IsHotComponent<CameraFollow>, "CameraFollow must stay small and trivially copyable");
+
+// Every component type the game stores, with its world file chunk id. Memory
+// stats, compaction, snapshots, world files and zone handoffs all walk this
+// list, so a new component is added here once. Chunk ids must not change:
+// saved worlds refer to them. NavAgent goal ids and Sprite region ids are
+// stored as is and only mean something with the same navigation goals and
+// sprite atlas.
+#define ECS_COMPONENTS(X) \
+    X(ECSTransform, "XFRM") \
+    X(Velocity, "VELO") \
+    X(Renderable, "REND") \
+    X(CircleShape, "CIRC") \
+    X(BoxShape, "BOXS") \
+    X(Model3D, "MODL") \
+    X(Alien3D, "ALIN") \
+    X(Player, "PLYR") \
+    X(PlayerName, "PNAM") \
+    X(Networked, "NETW") \
+    X(CameraFollow, "CAMF") \
+    X(Sprite, "SPRT") \
+    X(Collider, "COLL") \
+    X(RigidBody, "RIGB") \
+    X(NavAgent, "NAVA")
+
+template<typename Component>
+struct ComponentTag {
+    using type = Component;
+};
+
+// Calls visitor(ComponentTag<Component>{}, name, chunkId) for each entry of ECS_COMPONENTS
+template<typename Visitor>
+void forEachComponentType(Visitor&& visitor) {
+#define ECS_VISIT_COMPONENT(Component, chunkId) visitor(ComponentTag<Component>{}, #Component, chunkId);
+    ECS_COMPONENTS(ECS_VISIT_COMPONENT)
+#undef ECS_VISIT_COMPONENT
+}
+
 // ECS System class
 class ECSSystem {
 public:
@@ -79,12 +194,43 @@ public:
 
     // System updates
     void updateMovement(float deltaTime);
-    void updateRendering();
+    // Records circles, boxes, models and aliens into the frame without
+    // touching raylib, so it may run off the render thread
+    void buildRenderCommands(RenderFrame& frame);
     void updateNetworkSync();
     void updateCamera(float deltaTime);
     
-    // Model loading
+    // Sprites are culled to frame.screenSize and sorted by layer, atlas page
+    // and y; RenderFrame::drawSprites submits one quad batch per page run
+    struct SpriteStats {
+        std::size_t drawn = 0;
+        std::size_t culled = 0;
+        std::size_t batches = 0;
+    };
+    void setSpriteAtlas(const SpriteAtlas* atlas) { spriteAtlas = atlas; }
+    void buildSpriteCommands(RenderFrame& frame);
+    const SpriteStats& getSpriteStats() const { return spriteStats; }
+    
+    // Prefab spawning: one entity, or count entities appended to out with
+    // entity and component storage reserved up front
+    entt::entity spawnPrefab(const Prefab& prefab);
+    void spawnPrefab(const Prefab& prefab, std::size_t count, std::vector<entt::entity>& out);
+    
+    // Model loading. Models are shared per path: Model3D holds an index into
+    // the model table, which keeps each path and its GPU model.
     bool loadModel3D(entt::entity entity, const std::string& modelPath, float scale = 1.0f);
+    // Table index for a path, added unloaded if new
+    std::uint32_t addModel(const std::string& modelPath);
+    const std::string& getModelPath(std::uint32_t model) const;
+    bool isModelLoaded(std::uint32_t model) const;
+    // GPU models do not survive a world save; unload before replacing the
+    // registry and reload from the stored paths afterwards
+    void unloadModels();
+    std::size_t reloadModels();
+    // Unloads GPU models no Model3D refers to any more; paths stay in the
+    // table so handles remain valid. Returns the number unloaded.
+    std::size_t releaseUnusedModels();
+    std::size_t getLoadedModelCount() const;
 
     // Query helpers
     template<typename... Components>
@@ -95,10 +241,66 @@ public:
     
     // Camera helpers
     Vector2 getCameraOffset() const { return cameraOffset; }
+    void setCameraOffset(Vector2 offset) { cameraOffset = offset; }
     void setCameraTarget(entt::entity targetEntity);
+    
+    // Verbose per-frame debug output (camera tracking)
+    void setDebugLogging(bool enabled) { debugLogging = enabled; }
+    
+    // FNV-1a hash of entity ids, transforms and velocities in iteration
+    // order; equal hashes mean two runs reached bit-identical states
+    std::uint64_t computeStateHash();
+    
+    // Registers every component type used by the game with a snapshot ring
+    void registerSnapshotComponents(SnapshotRing& snapshots) const;
+    // Model3D is written as its path, so the codecs refer back to this system
+    void registerWorldComponents(WorldSerializer& serializer);
+    
+    // Memory held by one pool. Component data and the packed entity array are
+    // counted at capacity; the sparse array is counted as if every page in
+    // its extent were allocated, so it is an upper bound.
+    struct PoolMemory {
+        std::string_view name;
+        std::size_t count = 0;
+        std::size_t capacity = 0;
+        std::size_t componentBytes = 0;
+        std::size_t packedBytes = 0;
+        std::size_t sparseBytes = 0;
+        std::size_t heapBytes = 0;    // strings owned by the components
+        std::size_t unusedBytes = 0;  // capacity beyond count that compaction can return
+        std::size_t totalBytes() const { return componentBytes + packedBytes + sparseBytes + heapBytes; }
+    };
+    struct MemoryStats {
+        std::vector<PoolMemory> pools;
+        std::size_t totalBytes = 0;
+        std::size_t unusedBytes = 0;
+    };
+    // One entry per registered component type, then any other pools in the
+    // registry (data size unknown), then the entity pool
+    void collectMemoryStats(MemoryStats& stats);
+    // Releases unused pool capacity and sorts every component pool by entity,
+    // so views walk their pools in the same order; returns the bytes released.
+    // Changes iteration order, so it must not run in deterministic mode.
+    std::size_t compactStorage(bool sortByEntity = true);
+    
+    // Per-frame scratch memory (the sprite sort), reset by the owner at the end
+    // of each frame; falls back to the default resource without an arena
+    void setFrameArena(FrameArena* arena) { frameArena = arena; }
+    std::pmr::memory_resource* getFrameResource() const;
 
 private:
+    struct ModelAsset {
+        std::string path;
+        Model model = {};
+        bool loaded = false;
+    };
+    
     entt::registry registry;
+    std::vector<ModelAsset> models;
+    FrameArena* frameArena = nullptr;
+    const SpriteAtlas* spriteAtlas = nullptr;
+    SpriteStats spriteStats;
+    bool debugLogging = false;
     Vector2 cameraOffset = {0.0f, 0.0f};
     entt::entity cameraTarget = entt::null;
 };
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+// Frame-scoped bump allocator for transient data (scratch buffers, message
+// lists, serialization output). Allocation is a pointer bump, deallocation is
+// a no-op and Reset() rewinds the whole arena at the end of the frame.
+//
+// If a frame needs more than the current block, overflow blocks are taken from
+// the upstream resource and Reset() folds them into a single larger block, so
+// after a few frames of warm-up a steady-state frame never touches the heap.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(std::size_t initialCapacity = 256 * 1024,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Invalidates everything allocated since the last reset
+    void Reset();
+
+    std::size_t GetBytesUsed() const { return bytesUsed; }
+    std::size_t GetPeakBytesUsed() const { return peakBytesUsed; }
+    std::size_t GetCapacity() const { return capacity; }
+    std::size_t GetOverflowCount() const { return overflowCount; }
+
+    // Process-wide counters of global operator new/delete calls. ENet and
+    // raylib allocate through malloc and are not included.
+    static std::size_t GetHeapAllocationCount();
+    static std::size_t GetHeapFreeCount();
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    // Overflow blocks are chained through a header at the start of each block
+    struct OverflowBlock {
+        OverflowBlock* next;
+        std::size_t size;
+    };
+
+    std::pmr::memory_resource* upstream;
+    std::byte* block;
+    std::size_t capacity;
+    std::size_t offset;
+
+    OverflowBlock* overflowHead;
+    std::byte* overflowCursor;
+    std::byte* overflowEnd;
+    std::size_t overflowBytes;
+
+    std::size_t bytesUsed;
+    std::size_t peakBytesUsed;
+    std::size_t overflowCount;
+
+    void* AllocateOverflow(std::size_t bytes, std::size_t alignment);
+    void ReleaseOverflow();
+};
@@ -1,8 +1,15 @@
 #pragma once
 
 #include "raylib.h"
+#include "DeterministicRandom.h"
 #include <entt/entt.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
 // Boost includes for demonstration
 #include <boost/filesystem.hpp>
@@ -12,8 +19,103 @@
 #include <boost/regex.hpp>
 #include <boost/program_options.hpp>
 
+class NavigationSystem;
 class NetworkManager;
+class ParticleSystem;
+class PhysicsWorld;
 class ECSSystem;
+class FrameArena;
+class PrefabLibrary;
+struct RenderFrame;
+class ReplayRecorder;
+class ReplayPlayer;
+class SnapshotRing;
+class SoakTest;
+class SpriteAtlas;
+class TileMap;
+class WorldSerializer;
+class ZoneManager;
+struct InputFrame;
+struct NetworkMessage;
+
+struct GameOptions {
+    bool isServer = false;
+    int port = 12345;
+    int maxClients = 32;
+    std::string host = "127.0.0.1";
+    int width = 800;
+    int height = 600;
+    bool fullscreen = false;
+    bool verbose = false;
+    
+    // Periodic network telemetry dumps to <netStatsPath>.csv/.json (empty = off)
+    std::string netStatsPath;
+    double netStatsInterval = 5.0;
+    
+    // Adaptive per-channel packet compression, and ENet's range coder on top
+    // (the range coder must match between server and clients)
+    bool compression = true;
+    bool rangeCoder = false;
+    
+    // Server: split the world into this many zones, each simulated on its own
+    // thread (1 = a single registry; not available in deterministic mode)
+    int zones = 1;
+    float zoneWidth = 500.0f;
+    
+    // Collisions and rigid bodies (replays must use the setting they were recorded
+    // with); physicsThreads counts the narrowphase threads, 0 = all hardware threads
+    bool physics = true;
+    int physicsThreads = 0;
+    
+    // Flow-field steering for NavAgent entities; navigationThreads counts the
+    // threads for field builds and steering, 0 = all hardware threads
+    bool navigation = true;
+    int navigationThreads = 0;
+    
+    // Visual particle effects (windowed runs only); particleCapacity sizes the
+    // fountain emitter's pool, which dominates the particle count
+    bool particles = true;
+    int particleCapacity = 100000;
+    
+    // No window, audio or rendering (dedicated server, replays)
+    bool headless = false;
+    
+    // Fixed tick, seeded RNG and ordered system execution
+    bool deterministic = false;
+    float tickRate = 60.0f;
+    std::uint64_t seed = 1;
+    
+    // Record per-tick inputs to a file, or replay them (implies deterministic + headless)
+    std::string recordPath;
+    std::string replayPath;
+    
+    // Ticks of world snapshots kept for rollback (0 = disabled, needs deterministic)
+    int rollbackWindow = 0;
+    
+    // World file for quick save/load (F5/F9); loadWorld replaces the demo world at startup
+    std::string worldPath = "world.sav";
+    bool loadWorld = false;
+    
+    // Seconds between checks for unused ECS pool capacity; pools are compacted
+    // in a tick that used under a quarter of its budget (0 = never, skipped in
+    // deterministic mode since compaction reorders pools)
+    float compactInterval = 10.0f;
+    
+    // Simulate the next frame on a worker thread while the main thread draws
+    // the previous one (one frame of latency); windowed native builds only
+    bool renderThread = true;
+    
+    // Sprite atlas cache (<atlasPath>.atlas and <atlasPath>_<page>.png), built
+    // from assets/Side and assets/Isometric when missing
+    std::string atlasPath = "sprites";
+    
+    // Scripted leak and frame-time soak test (server mode, hidden window unless
+    // headless); the run fails when a tracked metric trends upward
+    bool soak = false;
+    double soakDuration = 3600.0;
+    double soakInterval = 30.0;
+    std::string soakReportPath;
+};
 
 class Game {
 public:
@@ -22,17 +124,114 @@ public:
     
     void Initialize(bool isServer = false, int port = 12345, const std::string& host = "127.0.0.1", 
                    int width = 800, int height = 600, bool fullscreen = false);
+    void Initialize(const GameOptions& options);
     void Update();
     void Render();
     void Shutdown();
     
     bool IsRunning() const { return running; }
+    // Thread-safe: ends the game loop at the start of the next Update()
+    void RequestStop() { stopRequested = true; }
+    // Exit status for main: non-zero if a replay did not reproduce its recording
+    // or a soak test found a regression
+    int GetExitCode() const { return exitCode; }
     
 private:
     bool running;
+    std::atomic<bool> stopRequested;
+    bool windowCreated;
+    int exitCode;
+    GameOptions options;
     std::unique_ptr<NetworkManager> networkManager;
     std::unique_ptr<ECSSystem> ecsSystem;
     
+    // Archetypes used for bulk spawning
+    std::unique_ptr<PrefabLibrary> prefabLibrary;
+    
+    // Transient per-frame memory, reset after each simulated frame
+    std::unique_ptr<FrameArena> frameArena;
+    std::size_t heapAllocationsAtFrameStart;
+    std::size_t heapAllocationsLastFrame;
+    
+    // Deterministic simulation
+    float fixedTimestep;
+    float tickAccumulator;
+    std::uint64_t tickCount;
+    double lastTickMicroseconds;
+    DeterministicRandom random;
+    std::chrono::steady_clock::time_point lastFrameTime;
+    
+    // ECS storage compaction in idle ticks
+    std::chrono::steady_clock::time_point lastCompactionCheck;
+    std::size_t lastCompactionBytes;
+    double lastCompactionMicroseconds;
+    bool showMemoryOverlay;
+    
+    // Rollback: per-tick world snapshots and the inputs that followed them
+    std::unique_ptr<SnapshotRing> snapshots;
+    std::vector<InputFrame> inputHistory;
+    std::uint32_t lastRollbackTicks;
+    double lastRollbackMicroseconds;
+    bool lastRollbackMatched;
+    
+    // Network telemetry overlay (F3)
+    bool showNetworkOverlay;
+    
+    // Binary world persistence
+    std::unique_ptr<WorldSerializer> worldSerializer;
+    
+    // Server world sharded into zones; the local player stays in ecsSystem
+    std::unique_ptr<ZoneManager> zoneManager;
+    
+    // Collision response for the local registry; zones run their own
+    std::unique_ptr<PhysicsWorld> physicsWorld;
+    
+    // Steers the local registry's agents; goal playerGoal follows the player
+    std::unique_ptr<NavigationSystem> navigationSystem;
+    std::uint32_t playerGoal;
+    
+    // Render-only effects; the trail and the wave sparks follow the player
+    std::unique_ptr<ParticleSystem> particleSystem;
+    std::uint32_t playerTrailEmitter;
+    std::uint32_t waveSparkEmitter;
+    
+    // Soak scenario, stepped between frames while the world is idle
+    std::unique_ptr<SoakTest> soakTest;
+    
+    // Packed sprite pages drawn by the ECS sprite pass
+    std::unique_ptr<SpriteAtlas> spriteAtlas;
+    // Chunked static terrain drawn under the scene
+    std::unique_ptr<TileMap> tileMap;
+    
+    // Render command lists: the simulation records into one while the main
+    // thread draws the other, so nothing is drawn from the registry directly
+    std::unique_ptr<RenderFrame> renderFrames[2];
+    int readyFrame;
+    bool frameInFlight;
+    double lastDrawMilliseconds;
+    double lastWaitMilliseconds;
+    double lastSimulateMilliseconds;  // written by whichever thread simulates
+    
+    // Simulation thread for the render thread mode. The main thread owns the
+    // window, GL and input; it posts one FrameInput per frame and waits for the
+    // previous frame before touching the world again.
+    struct FrameInput;
+    std::unique_ptr<FrameInput> pendingFrame;
+    boost::thread simulationThread;
+    boost::mutex simulationMutex;
+    boost::condition_variable simulationWake;
+    boost::condition_variable simulationDone;
+    bool simulationPending;
+    bool simulationStopping;
+    
+    // Input recording and replay
+    std::unique_ptr<ReplayRecorder> replayRecorder;
+    std::unique_ptr<ReplayPlayer> replayPlayer;
+    std::chrono::steady_clock::time_point replayStartTime;
+    // Set by SimulateFrame when the recording runs out; replays run headless,
+    // so this is always on the main thread
+    bool replayFinished;
+    
     // Game state
     Vector2 playerPosition;
     float playerSpeed;
@@ -46,11 +245,45 @@ private:
     
     // Boost utilities for demonstration
     boost::filesystem::path assetsPath;
+    std::string assetsPathText;
+    bool assetsPathExists;
     boost::chrono::steady_clock::time_point lastBoostUpdate;
     boost::regex versionRegex;
     
-    void HandleInput();
-    void UpdatePlayer();
+    float GetFrameDelta();
+    InputFrame SampleInput();
+    // Ticks, idle-time work and the render commands for one frame; runs on the
+    // simulation thread in render thread mode, otherwise inline in Update()
+    void SimulateFrame(const FrameInput& frame, RenderFrame* target);
+    void SimulationLoop();
+    // Waits for the frame being simulated and makes it the one to draw
+    void FinishSimulation();
+    void StopSimulationThread();
+    // Runs one simulation step; false when a replay has run out of ticks
+    bool Tick(float deltaTime, InputFrame input);
+    // The deterministic part of a tick: input and ECS systems, no I/O
+    void Simulate(float deltaTime, const InputFrame& input);
+    void SaveSnapshot(std::uint64_t tick);
+    // Restores the state from ticks ago and re-simulates up to the current tick
+    bool Rollback(std::uint32_t ticks);
+    void DebugRollback();
+    void FinishReplay();
+    // Records the scene, sprites and HUD; reads simulation state only
+    void BuildRenderFrame(RenderFrame& frame, const FrameInput& input);
+    void RecordNetworkOverlay(RenderFrame& frame);
+    void RecordMemoryOverlay(RenderFrame& frame);
+    // Compacts registries with enough unused capacity if the last tick was cheap
+    void CompactStorageIfIdle();
+    bool SaveWorld(const std::string& path);
+    bool LoadWorld(const std::string& path);
+    void HandleInput(const InputFrame& input);
+    void UpdatePlayer(const std::pmr::vector<NetworkMessage>& messages);
+    void SpawnWave(Vector2 center);
+    void InitializeSprites();
+    void InitializeTileMap();
+    void InitializeParticles();
+    // Left click paints a crater, right click restores the ground
+    void EditTileMap();
     void InitializeBoostFeatures();
     void UpdateBoostFeatures();
 };
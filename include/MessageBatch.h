@@ -0,0 +1,91 @@
+#pragma once
+
+#include "MessageChannel.h"
+#include "PacketCompressor.h"
+#include <enet/enet.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Packs the messages queued for one destination and channel into as few
+// packets as possible. Wire format: messages back to back, each prefixed by
+// its length as a little endian u16. A packet is closed before it would grow
+// past the byte budget, so each one fits a single MTU-sized datagram.
+class MessageBatch {
+public:
+    static constexpr std::size_t LengthPrefixBytes = 2;
+    static constexpr std::size_t MaxMessageBytes = 0xFFFF;
+    // ENet protocol, command and checksum headers inside one datagram
+    static constexpr std::size_t PacketOverheadBytes = 48;
+    static constexpr std::size_t DefaultMaxPacketBytes = 1392 - PacketOverheadBytes - PacketCompressor::MaxHeaderBytes;
+
+    MessageBatch() = default;
+    explicit MessageBatch(std::size_t maxPacketBytes) : maxPacketBytes(maxPacketBytes) {}
+
+    // False if the message is longer than MaxMessageBytes
+    bool Append(std::string_view message);
+    void Clear();
+
+    bool IsEmpty() const { return buffer.empty(); }
+    std::size_t GetMessageCount() const { return messageCount; }
+    std::size_t GetPacketCount() const { return buffer.empty() ? 0 : packetEnds.size() + 1; }
+    void SetMaxPacketBytes(std::size_t bytes) { maxPacketBytes = bytes; }
+
+    // Encodes each batch segment through the compressor, hands the resulting
+    // packet to send(ENetPacket*) and clears the batch. Returns the number of
+    // packets created.
+    template<typename SendFunction>
+    std::size_t Flush(MessageChannel channel, PacketCompressor& compressor, SendFunction send);
+
+    // Calls visit(std::string_view) for each message in a received packet;
+    // false if the packet is truncated or malformed
+    template<typename Visitor>
+    static bool ForEachMessage(const enet_uint8* data, std::size_t length, Visitor visit);
+
+private:
+    std::vector<char> buffer;
+    std::vector<std::size_t> packetEnds;  // end offsets of closed packets
+    std::size_t packetStart = 0;
+    std::size_t messageCount = 0;
+    std::size_t maxPacketBytes = DefaultMaxPacketBytes;
+    std::vector<enet_uint8> encoded;
+};
+
+// Template implementations
+template<typename SendFunction>
+std::size_t MessageBatch::Flush(MessageChannel channel, PacketCompressor& compressor, SendFunction send) {
+    if (buffer.empty()) return 0;
+
+    enet_uint32 flags = GetChannelPacketFlags(channel);
+    packetEnds.push_back(buffer.size());
+    std::size_t packets = 0;
+    std::size_t start = 0;
+    for (std::size_t end : packetEnds) {
+        compressor.Encode(channel, buffer.data() + start, end - start, encoded);
+        ENetPacket* packet = enet_packet_create(encoded.data(), encoded.size(), flags);
+        if (packet != nullptr) {
+            send(packet);
+            packets++;
+        }
+        start = end;
+    }
+
+    Clear();
+    return packets;
+}
+
+template<typename Visitor>
+bool MessageBatch::ForEachMessage(const enet_uint8* data, std::size_t length, Visitor visit) {
+    std::size_t offset = 0;
+    while (offset < length) {
+        if (length - offset < LengthPrefixBytes) return false;
+        std::size_t messageLength = static_cast<std::size_t>(data[offset]) | static_cast<std::size_t>(data[offset + 1]) << 8;
+        offset += LengthPrefixBytes;
+        if (length - offset < messageLength) return false;
+
+        visit(std::string_view(reinterpret_cast<const char*>(data + offset), messageLength));
+        offset += messageLength;
+    }
+    return true;
+}
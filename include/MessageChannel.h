@@ -0,0 +1,17 @@
+#pragma once
+
+#include <enet/enet.h>
+#include <cstddef>
+
+// Channel 0 carries reliable, ordered events. Channel 1 carries state updates
+// unreliably; ENet drops a state packet that arrives after a newer one.
+enum class MessageChannel : enet_uint8 {
+    Reliable = 0,
+    State = 1
+};
+
+constexpr std::size_t MessageChannelCount = 2;
+
+inline enet_uint32 GetChannelPacketFlags(MessageChannel channel) {
+    return channel == MessageChannel::Reliable ? ENET_PACKET_FLAG_RELIABLE : 0;
+}
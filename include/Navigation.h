@@ -0,0 +1,143 @@
+#pragma once
+
+#include "ECS.h"
+#include "Physics.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+struct NavigationConfig {
+    // Grid over the navigable area; agents outside it head straight for their goal
+    Vector2 origin = {-1000.0f, -1000.0f};
+    int width = 128;
+    int height = 96;
+    float cellSize = 25.0f;
+    // Cells a goal's field build expands per update (0 = whole field at once,
+    // which keeps fields a function of the current state for rollback)
+    std::size_t buildBudget = 4096;
+    // Agents slow down within this distance of their goal
+    float arrivalDistance = 40.0f;
+    // Agents closer than their radii plus this push each other apart
+    float avoidanceDistance = 8.0f;
+    float avoidanceWeight = 1.5f;
+    // Share of the gap to the steered velocity closed per second
+    float responsiveness = 8.0f;
+    // Threads for field builds and steering, including the caller (0 = all hardware threads)
+    std::size_t threadCount = 0;
+    std::size_t steeringGrain = 2048;
+};
+
+// Flow-field navigation for entities with an ECSTransform, a Velocity and a
+// NavAgent. Every goal owns one field over a grid of cells blocked by static
+// colliders: a Dijkstra pass from the goal's cell gives each cell its cost,
+// and each cell points at its cheapest neighbour. Fields are rebuilt when
+// their goal changes cell, a budgeted slice per update and goals in parallel,
+// while agents keep following the previous field. Steering samples the field
+// for every agent, adds separation from neighbours found with a SpatialGrid
+// and writes Velocity, so path cost grows with goals rather than agents.
+// Results do not depend on the thread count.
+class NavigationSystem {
+public:
+    static constexpr std::uint32_t InvalidGoal = 0xFFFFFFFFu;
+
+    struct Stats {
+        std::size_t agents = 0;
+        std::size_t goals = 0;
+        std::size_t building = 0;
+        std::size_t cellsExpanded = 0;
+        std::size_t fieldsBuilt = 0;  // since startup
+        std::size_t blockedCells = 0;
+        std::size_t avoidancePairs = 0;
+        std::size_t threads = 1;
+        double buildMicroseconds = 0.0;
+        double steerMicroseconds = 0.0;
+    };
+
+    explicit NavigationSystem(const NavigationConfig& config = NavigationConfig());
+    ~NavigationSystem();
+
+    NavigationSystem(const NavigationSystem&) = delete;
+    NavigationSystem& operator=(const NavigationSystem&) = delete;
+
+    // Goals are shared by every agent whose NavAgent names them
+    std::uint32_t addGoal(Vector2 position);
+    void setGoalPosition(std::uint32_t goal, Vector2 position);
+    // The goal follows the entity's ECSTransform; entt::null stops following
+    void setGoalTarget(std::uint32_t goal, entt::entity target);
+    // Static colliders are read into the grid on the first update and after this
+    void markObstaclesDirty() { obstaclesDirty = true; }
+
+    // Moves goals, advances field builds and steers every agent
+    void update(entt::registry& registry, float deltaTime);
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Field {
+        std::vector<float> cost;
+        std::vector<float> directionX;
+        std::vector<float> directionY;
+    };
+
+    struct OpenCell {
+        float cost;
+        std::uint32_t cell;
+    };
+
+    struct Goal {
+        Vector2 position = {0.0f, 0.0f};
+        entt::entity target = entt::null;
+        int cell = -1;       // cell the active field leads to
+        int buildCell = -1;  // cell being built, -1 when idle
+        bool hasField = false;
+        Field active;
+        Field building;
+        std::vector<OpenCell> open;  // min-heap on cost
+        std::size_t expanded = 0;    // cells expanded by the last update
+    };
+
+    void rebuildObstacles(entt::registry& registry);
+    void updateGoals(entt::registry& registry);
+    void startBuild(Goal& goal, int cell);
+    // Returns the cells expanded; finishes and swaps in the field when the open list empties
+    std::size_t advanceBuild(Goal& goal, std::size_t budget);
+    void finishBuild(Goal& goal);
+    void gatherAgents(entt::registry& registry);
+    void sampleFields(std::size_t begin, std::size_t end);
+    void findNeighbours();
+    void steer(float deltaTime);
+    void writeBack(entt::registry& registry);
+
+    int cellAt(Vector2 position) const;
+    int clampedCellAt(Vector2 position) const;
+
+    NavigationConfig config;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<std::uint8_t> blocked;  // by cell
+    bool obstaclesDirty = true;
+    std::vector<Goal> goals;
+    std::vector<std::uint32_t> buildingGoals;
+
+    // Agents in structure-of-arrays form, reused every update
+    std::vector<entt::entity> agentEntities;
+    std::vector<std::uint32_t> agentGoals;
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> speeds;
+    std::vector<float> radii;
+    std::vector<float> goalDistance;
+    std::vector<float> directionX;
+    std::vector<float> directionY;
+    std::vector<float> avoidX;
+    std::vector<float> avoidY;
+
+    SpatialGrid neighbourGrid;
+    std::vector<std::uint64_t> pairs;
+
+    Stats stats;
+};
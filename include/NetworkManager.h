@@ -1,12 +1,32 @@
 #pragma once
 
+#include "MessageBatch.h"
+#include "NetworkTelemetry.h"
+#include <array>
 #include <enet/enet.h>
+#include <cstddef>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Allocator-aware so message lists can live in a per-frame arena
 struct NetworkMessage {
-    std::string data;
-    ENetPeer* peer;
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    std::pmr::string data;
+    ENetPeer* peer = nullptr;
+
+    NetworkMessage() = default;
+    explicit NetworkMessage(const allocator_type& alloc) : data(alloc) {}
+    NetworkMessage(const NetworkMessage& other, const allocator_type& alloc)
+        : data(other.data, alloc), peer(other.peer) {}
+    NetworkMessage(NetworkMessage&& other, const allocator_type& alloc)
+        : data(std::move(other.data), alloc), peer(other.peer) {}
+    NetworkMessage(const NetworkMessage&) = default;
+    NetworkMessage(NetworkMessage&&) = default;
+    NetworkMessage& operator=(const NetworkMessage&) = default;
+    NetworkMessage& operator=(NetworkMessage&&) = default;
 };
 
 class NetworkManager {
@@ -17,30 +37,74 @@ public:
     bool Initialize();
     void Shutdown();
     
+    // ENet addresses peers with 12-bit ids
+    static constexpr std::size_t MaxClientsLimit = ENET_PROTOCOL_MAXIMUM_PEER_ID;
+    
     // Server functions
-    bool StartServer(int port = 12345);
+    bool StartServer(int port = 12345, std::size_t maxClients = 32);
     void StopServer();
     
     // Client functions
     bool ConnectToServer(const std::string& address, int port = 12345);
     void Disconnect();
     
-    // Message handling
-    void SendMessage(const std::string& message);
-    std::vector<NetworkMessage> GetMessages();
+    // Message handling. Messages are queued per destination and channel and
+    // go out packed into MTU-sized packets on the next Flush()
+    void SendMessage(std::string_view message, MessageChannel channel = MessageChannel::Reliable);
+    // Server: reply to one peer instead of broadcasting
+    void SendMessageTo(ENetPeer* target, std::string_view message, MessageChannel channel = MessageChannel::Reliable);
+    // Packs and sends everything queued since the last flush; call once per tick
+    void Flush();
+    // Returned list and payloads are allocated from the given resource
+    std::pmr::vector<NetworkMessage> GetMessages(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     
     // Update function to be called each frame
     void Update();
     
     bool IsServer() const { return isServer; }
     bool IsConnected() const { return isConnected; }
+    std::size_t GetConnectedPeerCount() const { return host ? host->connectedPeers : 0; }
+    
+    // Adaptive per-channel payload compression (on by default) and ENet's
+    // host-wide range coder; call before StartServer/ConnectToServer
+    void SetCompression(bool adaptive, bool rangeCoder);
+    const PacketCompressor& GetCompressor() const { return compressor; }
+    
+    // Per-peer and per-message-type statistics, sampled every Update()
+    NetworkTelemetry& GetTelemetry() { return telemetry; }
+    const NetworkTelemetry& GetTelemetry() const { return telemetry; }
     
 private:
     ENetHost* host;
     ENetPeer* peer;
     bool isServer;
     bool isConnected;
-    std::vector<NetworkMessage> messageQueue;
     
+    // Received payloads are appended to one buffer that keeps its capacity
+    // between frames; GetMessages copies them out to the caller's resource
+    struct PendingMessage {
+        std::size_t offset;
+        std::size_t length;
+        ENetPeer* peer;
+    };
+    std::vector<char> receiveBuffer;
+    std::vector<PendingMessage> messageQueue;
+    
+    // Outgoing batches: server broadcasts, and one pair per peer (indexed by
+    // ENet peer id) for replies and for the client's connection to the server
+    using ChannelBatches = std::array<MessageBatch, MessageChannelCount>;
+    ChannelBatches broadcastBatches;
+    std::vector<ChannelBatches> peerBatches;
+    std::vector<std::uint16_t> peersWithQueuedMessages;
+    
+    PacketCompressor compressor;
+    bool useRangeCoder;
+    std::vector<enet_uint8> dictionaryPacket;
+    
+    NetworkTelemetry telemetry;
+    
+    void ConfigureCompression();
+    void CreateBatches();
+    void QueueForPeer(ENetPeer* target, std::string_view message, MessageChannel channel);
     void ProcessEvents();
 };
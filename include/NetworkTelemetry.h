@@ -0,0 +1,151 @@
+#pragma once
+
+#include <enet/enet.h>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class PacketCompressor;
+
+// Histogram over a sliding time window: samples go into the current one
+// second slice, and the oldest slice is dropped as time moves on
+class RollingHistogram {
+public:
+    static constexpr std::size_t BucketCount = 12;
+    static constexpr std::size_t SliceCount = 10;
+
+    // Upper bounds of the buckets; the last bucket is open ended
+    explicit RollingHistogram(const std::array<double, BucketCount - 1>& bounds);
+
+    void Add(double value);
+    // Starts a new slice for every whole second since the last call
+    void Advance(std::uint64_t second);
+    void Clear();
+
+    std::uint64_t GetCount() const;
+    // Upper bound of the bucket holding the given fraction of samples
+    double GetPercentile(double fraction) const;
+    double GetMax() const;
+    std::array<std::uint64_t, BucketCount> GetBuckets() const;
+    const std::array<double, BucketCount - 1>& GetBounds() const { return bounds; }
+
+private:
+    struct Slice {
+        std::array<std::uint32_t, BucketCount> buckets{};
+        double max = 0.0;
+    };
+
+    std::array<double, BucketCount - 1> bounds;
+    std::array<Slice, SliceCount> slices;
+    std::uint64_t currentSecond = 0;
+};
+
+// Samples ENet's per-peer connection state every update and counts traffic
+// per message type (the text before the first ':'), so bandwidth can be
+// attributed to message types and degrading clients can be spotted.
+class NetworkTelemetry {
+public:
+    struct PeerStats {
+        bool connected = false;
+        std::uint16_t peerId = 0;
+        std::uint32_t connectId = 0;
+        std::string address;
+        double connectedSeconds = 0.0;
+
+        // Straight from ENetPeer
+        std::uint32_t roundTripTime = 0;          // ms, smoothed
+        std::uint32_t roundTripTimeVariance = 0;  // ms, jitter
+        float packetLoss = 0.0f;                  // 0..1
+        float packetThrottle = 0.0f;              // 0..1, 1 = no throttling
+        std::uint32_t reliableInFlight = 0;       // commands awaiting acknowledgement
+        std::uint32_t outgoingQueued = 0;         // commands not yet sent
+        std::uint32_t reliableBytesInTransit = 0;
+
+        // Accumulated from ENet's data totals (which ENet resets every second)
+        std::uint64_t bytesSent = 0;
+        std::uint64_t bytesReceived = 0;
+        double sendBytesPerSecond = 0.0;
+        double receiveBytesPerSecond = 0.0;
+
+        RollingHistogram rttHistogram;
+
+        // Sampling state
+        std::uint32_t lastOutgoingDataTotal = 0;
+        std::uint32_t lastIncomingDataTotal = 0;
+        std::uint64_t windowBytesSent = 0;
+        std::uint64_t windowBytesReceived = 0;
+
+        PeerStats();
+    };
+
+    struct MessageTypeStats {
+        std::string type;
+        std::uint64_t sentCount = 0;
+        std::uint64_t sentBytes = 0;
+        std::uint64_t receivedCount = 0;
+        std::uint64_t receivedBytes = 0;
+        double sendBytesPerSecond = 0.0;
+        double receiveBytesPerSecond = 0.0;
+
+        // Totals at the start of the current rate window
+        std::uint64_t windowSentBytes = 0;
+        std::uint64_t windowReceivedBytes = 0;
+    };
+
+    NetworkTelemetry();
+
+    // Traffic accounting; copies counts a message once per receiving peer
+    void RecordSent(std::string_view message, std::size_t copies = 1);
+    void RecordReceived(std::string_view message);
+    // Batched packets handed to ENet, counted once per receiving peer
+    void RecordPacketsSent(std::size_t packets) { packetsSent += packets; }
+
+    // Reads per-peer state from the host and adds one RTT sample per peer;
+    // call once per network update
+    void Sample(ENetHost* host);
+    void Reset();
+
+    // Periodic dumps to <basePath>.csv and <basePath>.json (0 s disables)
+    void SetDumpTarget(const std::string& basePath, double intervalSeconds);
+    // Per-channel compression savings are included in dumps when set
+    void SetCompressor(const PacketCompressor* compressor) { this->compressor = compressor; }
+    bool WriteCsv(const std::string& path) const;
+    bool WriteJson(const std::string& path) const;
+
+    // Indexed by ENet peer id; only entries with connected == true are live
+    const std::vector<PeerStats>& GetPeers() const { return peers; }
+    const std::vector<MessageTypeStats>& GetMessageTypes() const { return messageTypes; }
+    const RollingHistogram& GetRttHistogram() const { return rttHistogram; }
+    std::size_t GetConnectedPeerCount() const { return connectedPeers; }
+    std::uint64_t GetPacketsSent() const { return packetsSent; }
+    std::uint64_t GetMessagesSent() const;
+    // Connected peers ordered worst first (packet loss, then round-trip time)
+    std::vector<const PeerStats*> GetWorstPeers(std::size_t count) const;
+
+private:
+    // Message types beyond this share one "(other)" entry
+    static constexpr std::size_t MaxMessageTypes = 32;
+
+    MessageTypeStats& FindMessageType(std::string_view message);
+    void UpdateRates(double seconds);
+    void Dump();
+
+    std::vector<PeerStats> peers;
+    std::vector<MessageTypeStats> messageTypes;
+    RollingHistogram rttHistogram;
+    std::size_t connectedPeers = 0;
+    std::uint64_t packetsSent = 0;
+    const PacketCompressor* compressor = nullptr;
+
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point lastSampleTime;
+    std::chrono::steady_clock::time_point rateWindowStart;
+
+    std::string dumpBasePath;
+    double dumpIntervalSeconds = 0.0;
+    std::chrono::steady_clock::time_point lastDumpTime;
+};
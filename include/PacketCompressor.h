@@ -0,0 +1,134 @@
+#pragma once
+
+#include "MessageChannel.h"
+#include <enet/enet.h>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compresses batch packet payloads, choosing a codec per channel from
+// measured ratio and CPU cost.
+//
+// Packet layout: u8 codec, then
+//   Raw            the payload
+//   Lz             u32 raw size, LZ block
+//   LzDictionary   u8 dictionary id, u32 raw size, LZ block over dictionary + payload
+//   Dictionary     u8 dictionary id, dictionary bytes (control packet, no messages)
+//
+// The LZ block is LZ4-like: a token with literal and match length nibbles,
+// the literals, a u16 match offset and length extension bytes. The sender
+// trains a dictionary from its own state packets and announces it on the
+// reliable channel; state packets start using it a second after the
+// announcement, and a receiver drops packets for a dictionary it lacks.
+// Only the server sends dictionaries, so a server's compressor refuses them:
+// one shared table must not be replaceable by any connected client.
+class PacketCompressor {
+public:
+    enum class Codec : std::uint8_t {
+        Raw = 0,
+        Lz = 1,
+        LzDictionary = 2,
+        Dictionary = 0xFF
+    };
+    static constexpr std::size_t CodecCount = 3;
+
+    struct ChannelStats {
+        std::uint64_t packets = 0;
+        std::uint64_t rawBytes = 0;
+        std::uint64_t wireBytes = 0;
+        std::array<std::uint64_t, CodecCount> packetsByCodec{};
+        double encodeMicroseconds = 0.0;
+        Codec selected = Codec::Raw;
+        // Smoothed measurements per codec: output/input size and encode cost
+        std::array<double, CodecCount> ratio{};
+        std::array<double, CodecCount> nanosecondsPerByte{};
+    };
+
+    static constexpr std::size_t DictionaryCapacity = 2048;
+    // Worst case bytes Encode adds in front of a payload; batch budgets
+    // leave this much room so encoded packets still fit one datagram
+    static constexpr std::size_t MaxHeaderBytes = 6;
+
+    PacketCompressor();
+
+    // Adaptive selection on or off (off sends every packet raw)
+    void SetEnabled(bool enabled) { this->enabled = enabled; }
+    bool IsEnabled() const { return enabled; }
+    // Trains and announces a dictionary from outgoing state packets
+    void SetDictionaryTraining(bool enabled) { trainDictionary = enabled; }
+    // Whether received dictionary packets are absorbed or dropped as malformed
+    void SetAcceptDictionaries(bool accept) { acceptDictionaries = accept; }
+    // Compressed bytes one nanosecond of encoding per byte is worth, as a
+    // fraction of packet size; higher values favour cheaper codecs
+    void SetCpuWeight(double weight) { cpuWeight = weight; }
+
+    // Forgets dictionaries, samples, measurements and stats from an earlier
+    // session; the settings above are kept
+    void Reset();
+
+    // Encodes one packet payload for the given channel into out
+    void Encode(MessageChannel channel, const char* data, std::size_t length, std::vector<enet_uint8>& out);
+    // Decodes a received packet. Returns false for malformed packets or unknown
+    // dictionaries; dictionary packets are absorbed and yield an empty payload.
+    bool Decode(const enet_uint8* data, std::size_t length, const enet_uint8*& payload, std::size_t& payloadLength);
+
+    // Dictionary announcement to send on the reliable channel, if one is due
+    bool TakeDictionaryAnnouncement(std::vector<enet_uint8>& out);
+    // Current dictionary packet for peers that connect later (empty if none)
+    bool BuildDictionaryPacket(std::vector<enet_uint8>& out) const;
+
+    const ChannelStats& GetStats(MessageChannel channel) const { return channels[static_cast<std::size_t>(channel)]; }
+    std::uint64_t GetDecodeFailures() const { return decodeFailures; }
+    double GetDecodeMicroseconds() const { return decodeMicroseconds; }
+
+    // Greedy segment selection over sample packets (a simplified COVER):
+    // picks the segments whose 8-byte substrings recur most across samples
+    static std::vector<enet_uint8> TrainDictionary(const std::vector<std::vector<enet_uint8>>& samples, std::size_t capacity);
+
+    static const char* GetCodecName(Codec codec);
+
+private:
+    // Packets between measuring every codec; the rest use the current choice
+    static constexpr std::uint32_t ProbeInterval = 32;
+    static constexpr std::size_t MinCompressBytes = 48;
+    static constexpr std::size_t TrainingSampleCount = 256;
+    // Largest payload a received packet may claim to decode to
+    static constexpr std::size_t MaxDecodedBytes = 1 << 20;
+
+    std::size_t EncodeWith(Codec codec, const char* data, std::size_t length, std::vector<enet_uint8>& out);
+    void CollectSample(const char* data, std::size_t length);
+
+    // LZ block over window[start, end); matches may reach back before start
+    static std::size_t CompressBlock(const enet_uint8* window, std::size_t start, std::size_t end,
+                                     std::vector<enet_uint8>& out, std::vector<std::uint32_t>& hashTable);
+    static bool DecompressBlock(const enet_uint8* data, std::size_t length, std::vector<enet_uint8>& out,
+                                std::size_t expectedEnd);
+
+    bool enabled = true;
+    bool trainDictionary = false;
+    bool acceptDictionaries = true;
+    double cpuWeight = 0.002;
+
+    std::array<ChannelStats, MessageChannelCount> channels;
+    std::array<std::uint32_t, MessageChannelCount> packetsSinceProbe{};
+
+    // Outgoing dictionary
+    std::vector<std::vector<enet_uint8>> samples;
+    std::vector<enet_uint8> dictionary;
+    std::uint8_t dictionaryId = 0;
+    bool announcementPending = false;
+    std::chrono::steady_clock::time_point dictionaryUsableAt;
+
+    // Dictionaries announced by the other side, by id
+    std::array<std::vector<enet_uint8>, 256> remoteDictionaries;
+
+    std::vector<enet_uint8> window;
+    std::vector<enet_uint8> candidate;
+    std::vector<enet_uint8> decoded;
+    std::vector<std::uint32_t> hashTable;
+
+    std::uint64_t decodeFailures = 0;
+    double decodeMicroseconds = 0.0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "raylib.h"
+#include <entt/entt.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct RenderFrame;
+
+struct EmitterConfig {
+    // Live particles never exceed this; spawns beyond it are dropped
+    std::size_t capacity = 4096;
+    float rate = 200.0f;  // particles per second
+    float lifeMin = 0.5f;
+    float lifeMax = 1.0f;
+    // Launch direction in radians (0 = +x, -PI/2 = up the screen) and the
+    // width of the cone around it
+    float direction = -PI / 2;
+    float spread = 2 * PI;
+    float speedMin = 20.0f;
+    float speedMax = 60.0f;
+    float sizeMin = 2.0f;
+    float sizeMax = 4.0f;
+    float endScale = 0.0f;  // size multiplier at the end of a particle's life
+    Vector2 gravity = {0.0f, 0.0f};
+    float drag = 0.0f;  // share of the velocity lost per second
+    Color startColor = WHITE;
+    Color endColor = {255, 255, 255, 0};
+    // Material: additive or alpha blending, soft round sprite or solid square.
+    // Emitters sharing a material are drawn in one batch.
+    bool additive = false;
+    bool soft = true;
+};
+
+// Visual-only particles, kept out of the registry. Each emitter owns a
+// fixed-capacity pool in structure-of-arrays form; update integrates four
+// particles per SSE2 instruction (scalar elsewhere) and removes expired ones
+// by moving the last live particle into their slot, so nothing is allocated
+// or freed after creation. Emitters can follow an entity's ECSTransform.
+class ParticleSystem {
+public:
+    struct Stats {
+        std::size_t emitters = 0;
+        std::size_t alive = 0;
+        std::size_t capacity = 0;
+        std::size_t spawned = 0;  // by the last update
+        std::size_t dropped = 0;  // spawns that found their pool full, last update
+        std::size_t drawn = 0;
+        std::size_t batches = 0;
+        double updateMicroseconds = 0.0;
+        double recordMicroseconds = 0.0;
+    };
+
+    ParticleSystem() = default;
+    ~ParticleSystem();
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // Whether update uses the SSE2 kernel
+    static bool usesSimd();
+
+    std::uint32_t createEmitter(const EmitterConfig& config, Vector2 position);
+    void setPosition(std::uint32_t emitter, Vector2 position);
+    // The emitter spawns at the entity's position plus offset; it stops
+    // spawning once the entity or its transform is gone
+    void attach(std::uint32_t emitter, entt::entity entity, Vector2 offset = {0.0f, 0.0f});
+    void setActive(std::uint32_t emitter, bool active);
+    // Spawns count particles at once, on top of the rate
+    void burst(std::uint32_t emitter, std::size_t count);
+
+    void update(entt::registry& registry, float deltaTime);
+    // Appends the visible particles, grouped into one batch per material
+    void buildRenderCommands(RenderFrame& frame);
+
+    // The soft particle texture needs a GL context
+    bool uploadTextures();
+    void unloadTextures();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Emitter {
+        EmitterConfig config;
+        Vector2 position = {0.0f, 0.0f};
+        entt::entity attached = entt::null;
+        Vector2 offset = {0.0f, 0.0f};
+        bool active = true;
+        float spawnAccumulator = 0.0f;
+        std::size_t pendingBurst = 0;
+        std::uint32_t randomState = 1;
+
+        // Pool, padded to a multiple of four so the SIMD loop needs no tail
+        std::size_t count = 0;
+        std::vector<float> positionX;
+        std::vector<float> positionY;
+        std::vector<float> velocityX;
+        std::vector<float> velocityY;
+        std::vector<float> remaining;    // seconds left
+        std::vector<float> inverseLife;  // 1 / total lifetime
+        std::vector<float> size;
+    };
+
+    void spawn(Emitter& emitter, std::size_t count);
+    // Returns true if a particle may have expired
+    static bool integrate(Emitter& emitter, float deltaTime);
+    static void compact(Emitter& emitter);
+
+    std::vector<Emitter> emitters;
+    Texture2D softTexture = {};
+    Stats stats;
+};
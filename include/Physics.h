@@ -0,0 +1,195 @@
+#pragma once
+
+#include "ECS.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+// Colliders matching what buildRenderCommands draws for each shape
+Collider makeCollider(const CircleShape& circle);
+Collider makeCollider(const BoxShape& box);
+
+// Headless measurement behind --physics-bench: bodyCount dynamic circles in
+// a walled square, stirred up and swept by a kinematic box, stepped at 60 Hz.
+// Prints step time percentiles and the last step's stats.
+void runPhysicsBenchmark(std::size_t bodyCount, std::size_t threadCount, int steps);
+
+// Uniform grid broadphase. Bodies are inserted into every cell their bounds
+// touch, the cell list is sorted, and each overlapping pair is reported once,
+// from the cell holding the top-left corner of the two bounds' intersection.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 64.0f);
+
+    void setCellSize(float size) { cellSize = size; }
+    void clear();
+    void insert(std::uint32_t id, Rectangle bounds);
+
+    // Appends (a, b) with a < b for every pair of overlapping bounds, in a
+    // deterministic order; pairs where accept(a, b) is false are skipped
+    template<typename Accept>
+    void findPairs(std::vector<std::uint64_t>& pairs, Accept&& accept);
+
+    std::size_t getEntryCount() const { return entries.size(); }
+
+private:
+    struct Entry {
+        std::uint64_t cell;
+        std::uint32_t id;
+    };
+
+    static std::uint64_t cellKey(int x, int y) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+    }
+
+    float cellSize;
+    std::vector<Entry> entries;
+    std::vector<Rectangle> bounds;  // by id
+};
+
+struct PhysicsConfig {
+    float cellSize = 64.0f;
+    int iterations = 4;
+    // Penetration left alone, and the share of the rest removed per step
+    float slop = 0.5f;
+    float correction = 0.8f;
+    // Bodies slower than this for timeToSleep seconds may sleep, once their
+    // whole island is at rest and no contact in it is still deeply overlapping
+    float sleepSpeed = 4.0f;
+    float timeToSleep = 0.5f;
+    float sleepPenetration = 2.0f;
+    // Threads for the narrowphase, including the caller (0 = all hardware threads)
+    std::size_t threadCount = 0;
+    std::size_t narrowphaseGrain = 1024;
+};
+
+// Collision detection and response for entities with an ECSTransform and a
+// Collider. Runs after updateMovement: broadphase pairs from a SpatialGrid,
+// narrowphase circle/box tests split across a ThreadPool, then sequential
+// impulses and positional correction on the calling thread. Connected groups
+// of bodies at rest fall asleep and are skipped until something touches them
+// (including a moving collider without a RigidBody) or their velocity is set. Results do not depend on the thread count.
+class PhysicsWorld {
+public:
+    struct Stats {
+        std::size_t bodies = 0;
+        std::size_t awake = 0;
+        std::size_t sleeping = 0;
+        std::size_t pairs = 0;
+        std::size_t contacts = 0;
+        std::size_t islands = 0;
+        std::size_t threads = 1;
+        double broadphaseMicroseconds = 0.0;
+        double narrowphaseMicroseconds = 0.0;
+        double solveMicroseconds = 0.0;
+        double totalMicroseconds = 0.0;
+    };
+
+    explicit PhysicsWorld(const PhysicsConfig& config = PhysicsConfig());
+    ~PhysicsWorld();
+
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+    void step(entt::registry& registry, float deltaTime);
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Body {
+        entt::entity entity;
+        Vector2 position;
+        Vector2 velocity;
+        Vector2 halfExtents;
+        float radius;
+        float inverseMass;
+        float restitution;
+        float sleepTime;
+        bool isCircle;
+        bool dynamic;
+        bool sleeping;
+        bool hasVelocity;
+        bool kinematic;  // no RigidBody but a non-zero Velocity: pushes, is never pushed
+    };
+
+    struct Contact {
+        std::uint32_t a;
+        std::uint32_t b;
+        Vector2 normal;  // from a towards b
+        float penetration;
+        float targetSpeed;  // separating speed restitution asks for
+        float impulse;      // accumulated over the solver iterations
+    };
+
+    void gatherBodies(entt::registry& registry);
+    void findPairs();
+    void findContacts();
+    void buildIslands();
+    void wakeIslands();
+    void solve();
+    void sleepIslands(float deltaTime);
+    void writeBack(entt::registry& registry);
+
+    std::uint32_t findRoot(std::uint32_t body);
+    static bool collide(const Body& a, const Body& b, Contact& contact);
+
+    PhysicsConfig config;
+    std::unique_ptr<ThreadPool> pool;
+    SpatialGrid grid;
+
+    // Reused every step so a steady-state step does not allocate
+    std::vector<Body> bodies;
+    std::vector<std::uint64_t> pairs;
+    std::vector<std::vector<Contact>> rangeContacts;
+    std::vector<Contact> contacts;
+    std::vector<std::uint32_t> islandParent;
+    std::vector<std::uint8_t> islandFlags;
+
+    Stats stats;
+};
+
+// Template implementations
+template<typename Accept>
+void SpatialGrid::findPairs(std::vector<std::uint64_t>& pairs, Accept&& accept) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.cell != b.cell ? a.cell < b.cell : a.id < b.id;
+    });
+
+    for (std::size_t runStart = 0; runStart < entries.size();) {
+        std::size_t runEnd = runStart + 1;
+        while (runEnd < entries.size() && entries[runEnd].cell == entries[runStart].cell) {
+            runEnd++;
+        }
+
+        for (std::size_t i = runStart; i < runEnd; i++) {
+            std::uint32_t a = entries[i].id;
+            const Rectangle& boundsA = bounds[a];
+            for (std::size_t j = i + 1; j < runEnd; j++) {
+                std::uint32_t b = entries[j].id;
+                const Rectangle& boundsB = bounds[b];
+                if (boundsA.x > boundsB.x + boundsB.width || boundsB.x > boundsA.x + boundsA.width ||
+                    boundsA.y > boundsB.y + boundsB.height || boundsB.y > boundsA.y + boundsA.height) {
+                    continue;
+                }
+
+                // Both bounds share every cell their intersection touches; report
+                // the pair only from the first of them
+                float left = std::max(boundsA.x, boundsB.x);
+                float top = std::max(boundsA.y, boundsB.y);
+                if (cellKey(static_cast<int>(std::floor(left / cellSize)), static_cast<int>(std::floor(top / cellSize))) !=
+                    entries[runStart].cell) {
+                    continue;
+                }
+                if (accept(a, b)) {
+                    pairs.push_back((static_cast<std::uint64_t>(a) << 32) | b);
+                }
+            }
+        }
+        runStart = runEnd;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// An archetype: a set of components with default values that can be spawned
+// many times. Spawning goes through one batched insert per component pool
+// rather than one emplace per entity and component.
+class Prefab {
+public:
+    Prefab() = default;
+    explicit Prefab(const std::string& name) : name(name) {}
+
+    Prefab(const Prefab& other);
+    Prefab& operator=(const Prefab& other);
+    Prefab(Prefab&&) = default;
+    Prefab& operator=(Prefab&&) = default;
+
+    // Add a component (or replace its defaults if already present)
+    template<typename Component>
+    Prefab& with(const Component& defaults = Component{});
+
+    template<typename Component>
+    bool has() const;
+
+    // Mutable access to the stored defaults, nullptr if not part of the prefab
+    template<typename Component>
+    Component* get();
+
+    const std::string& getName() const { return name; }
+    std::size_t getComponentCount() const { return components.size(); }
+
+    // Reserve pool storage and insert every component on [first, last)
+    void instantiate(entt::registry& registry, const entt::entity* first, const entt::entity* last) const;
+
+private:
+    struct ComponentSlot {
+        virtual ~ComponentSlot() = default;
+        virtual entt::id_type type() const = 0;
+        virtual std::unique_ptr<ComponentSlot> clone() const = 0;
+        virtual void insert(entt::registry& registry, const entt::entity* first, const entt::entity* last) const = 0;
+    };
+
+    template<typename Component>
+    struct TypedSlot : ComponentSlot {
+        Component value;
+
+        explicit TypedSlot(const Component& value) : value(value) {}
+
+        entt::id_type type() const override { return entt::type_hash<Component>::value(); }
+
+        std::unique_ptr<ComponentSlot> clone() const override {
+            return std::make_unique<TypedSlot<Component>>(value);
+        }
+
+        void insert(entt::registry& registry, const entt::entity* first, const entt::entity* last) const override {
+            auto& storage = registry.storage<Component>();
+            storage.reserve(storage.size() + static_cast<std::size_t>(last - first));
+            registry.insert<Component>(first, last, value);
+        }
+    };
+
+    ComponentSlot* find(entt::id_type type) const;
+
+    std::string name;
+    std::vector<std::unique_ptr<ComponentSlot>> components;
+};
+
+// Named prefabs, defined in code or loaded from an INI-style file:
+//
+//   [enemy]
+//   transform.x = 200
+//   velocity.x = 50
+//   renderable.color = 230,41,55,255
+//   renderable.radius = 15
+//   collider = true
+//   rigidbody.mass = 2
+//   networked = true
+class PrefabLibrary {
+public:
+    Prefab& define(const std::string& name);
+    const Prefab* find(const std::string& name) const;
+    bool contains(const std::string& name) const { return prefabs.count(name) > 0; }
+    std::size_t size() const { return prefabs.size(); }
+
+    // Adds (or replaces) every prefab found in the file
+    bool loadFromFile(const std::string& path);
+
+private:
+    std::map<std::string, Prefab> prefabs;
+};
+
+// Template implementations
+template<typename Component>
+Prefab& Prefab::with(const Component& defaults) {
+    if (auto* slot = find(entt::type_hash<Component>::value())) {
+        static_cast<TypedSlot<Component>*>(slot)->value = defaults;
+    } else {
+        components.push_back(std::make_unique<TypedSlot<Component>>(defaults));
+    }
+    return *this;
+}
+
+template<typename Component>
+bool Prefab::has() const {
+    return find(entt::type_hash<Component>::value()) != nullptr;
+}
+
+template<typename Component>
+Component* Prefab::get() {
+    if (auto* slot = find(entt::type_hash<Component>::value())) {
+        return &static_cast<TypedSlot<Component>*>(slot)->value;
+    }
+    return nullptr;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SpriteAtlas;
+
+// Everything drawn in one frame, as plain data. The simulation fills it
+// (ECSSystem::buildRenderCommands, the HUD) without calling raylib; the
+// renderer submits it afterwards, possibly on the main thread while the
+// simulation already builds the next frame into another RenderFrame.
+// Buffers keep their capacity, so a steady-state frame does not allocate.
+struct RenderFrame {
+    struct Circle {
+        Vector2 position;
+        float radius;
+        Color color;
+    };
+
+    struct Box {
+        Rectangle rect;
+        Color color;
+    };
+
+    // raylib's Model is a handle (mesh and material pointers), so it is copied;
+    // the GPU data must stay loaded until the frame has been drawn
+    struct ModelDraw {
+        Model model;
+        Vector3 position;
+        float scale;
+        bool loaded;  // false draws a placeholder sphere
+    };
+
+    struct Alien {
+        Vector3 position;
+        float size;
+        Color color;
+    };
+
+    // Screen-space quad, already culled and sorted by layer, page and y
+    struct SpriteQuad {
+        std::int16_t layer;
+        std::uint16_t page;
+        Rectangle destination;
+        Rectangle source;
+        Color tint;
+    };
+
+    // Screen-space particle quad with its interpolated size and colour
+    struct ParticleQuad {
+        Vector2 position;
+        float halfSize;
+        Color color;
+    };
+
+    // Consecutive particles sharing a texture (0 = solid) and blend mode
+    struct ParticleBatch {
+        unsigned int texture;
+        bool additive;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    // UI items are drawn in the order they were added
+    struct OverlayItem {
+        enum Kind : std::uint8_t { Text, Panel };
+        Kind kind;
+        Color color;
+        int fontSize;
+        Rectangle rect;  // text: x and y only
+        std::uint32_t textOffset;
+        std::uint32_t textLength;
+    };
+
+    Vector2 cameraOffset = {0.0f, 0.0f};
+    // Screen size when the frame was started, for culling off the render thread
+    Vector2 screenSize = {0.0f, 0.0f};
+
+    std::vector<Circle> circles;
+    std::vector<Box> boxes;
+    std::vector<ModelDraw> models;
+    std::vector<Alien> aliens;
+    std::vector<SpriteQuad> sprites;
+    std::vector<ParticleQuad> particles;
+    std::vector<ParticleBatch> particleBatches;
+    std::vector<OverlayItem> overlay;
+    std::vector<char> textBuffer;
+
+    void clear();
+
+    // printf-style text, formatted into textBuffer (raylib's TextFormat keeps
+    // shared static buffers, so it is not safe off the render thread)
+    void text(int x, int y, int fontSize, Color color, const char* format, ...);
+    void panel(Rectangle rect, Color color);
+
+    // Submission; call on the thread that owns the GL context
+    void drawScene() const;  // inside BeginMode3D
+    void drawSprites(const SpriteAtlas& atlas) const;
+    void drawParticles() const;
+    void drawOverlay() const;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "NetworkManager.h"
+#include <cstdint>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Player input for one simulation tick, stored as a small bitmask
+struct InputFrame {
+    enum Buttons : std::uint8_t {
+        MoveUp    = 1 << 0,
+        MoveDown  = 1 << 1,
+        MoveLeft  = 1 << 2,
+        MoveRight = 1 << 3,
+        SpawnWave = 1 << 4
+    };
+
+    std::uint8_t buttons = 0;
+
+    bool isDown(Buttons button) const { return (buttons & button) != 0; }
+};
+
+// Replay file layout (little endian):
+//   header   "GERP", u32 version, u64 seed, u32 tick duration (seconds, float bits)
+//   per tick u8 flags (input buttons, bit 7 = has messages)
+//            [u16 message count, { u16 peer id, u16 length, bytes }...]
+//   footer   u8 0xFF, u32 tick count, u64 final state hash
+class ReplayRecorder {
+public:
+    ReplayRecorder() = default;
+    ~ReplayRecorder();
+
+    // The tick length is stored bit for bit, so a replay steps with exactly
+    // the timestep it was recorded with
+    bool Open(const std::string& path, std::uint64_t seed, float tickSeconds);
+    void RecordTick(const InputFrame& input, const std::pmr::vector<NetworkMessage>& messages);
+    // Writes the footer; the hash lets a replay verify it reproduced the run
+    void Close(std::uint64_t finalStateHash);
+
+    bool IsOpen() const { return file.is_open(); }
+    std::uint32_t GetTickCount() const { return tickCount; }
+
+private:
+    std::ofstream file;
+    std::uint32_t tickCount = 0;
+};
+
+class ReplayPlayer {
+public:
+    bool Open(const std::string& path);
+
+    // Reads the next tick; returns false at the end of the recording
+    bool ReadTick(InputFrame& input, std::pmr::vector<NetworkMessage>& messages);
+
+    std::uint64_t GetSeed() const { return seed; }
+    float GetTickSeconds() const { return tickSeconds; }
+    std::uint32_t GetTicksRead() const { return ticksRead; }
+
+    // Valid once ReadTick has returned false
+    bool HasFooter() const { return hasFooter; }
+    std::uint32_t GetRecordedTicks() const { return recordedTicks; }
+    std::uint64_t GetFinalStateHash() const { return finalStateHash; }
+
+private:
+    std::ifstream file;
+    std::uint64_t seed = 0;
+    float tickSeconds = 0.0f;
+    std::uint32_t ticksRead = 0;
+    bool hasFooter = false;
+    std::uint32_t recordedTicks = 0;
+    std::uint64_t finalStateHash = 0;
+};
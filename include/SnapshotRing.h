@@ -0,0 +1,191 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Ring of whole-world registry snapshots for rollback and re-simulation.
+//
+// Every slot owns one preallocated memory block. Trivially copyable component
+// pools are copied into it with memcpy (packed entity array plus component
+// pages); other components are copied element-wise into per-slot buffers
+// that keep their capacity. Restoring rebuilds the entity pool and then each
+// component pool in its original packed order, so iteration order (and thus
+// re-simulation) is identical to the original run.
+//
+// Every pool in the registry must be registered before save() is called.
+class SnapshotRing {
+public:
+    explicit SnapshotRing(std::size_t slotCount = 16, std::size_t bytesPerSlot = 256 * 1024);
+
+    template<typename Component>
+    void registerComponent();
+
+    // Extra state outside the registry (RNG, camera, ...) stored with the snapshot
+    template<typename Extra>
+    void save(const entt::registry& registry, std::uint64_t tick, const Extra& extra);
+    void save(const entt::registry& registry, std::uint64_t tick) { saveSlot(registry, tick, nullptr, 0); }
+
+    template<typename Extra>
+    bool restore(entt::registry& registry, std::uint64_t tick, Extra& extra) const;
+    bool restore(entt::registry& registry, std::uint64_t tick) const { return restoreSlot(registry, tick, nullptr, 0); }
+
+    bool contains(std::uint64_t tick) const;
+    void clear();
+
+    std::size_t getSlotCount() const { return slots.size(); }
+    std::size_t getLastSnapshotBytes() const { return lastSnapshotBytes; }
+    double getLastSaveMicroseconds() const { return lastSaveMicroseconds; }
+    double getLastRestoreMicroseconds() const { return lastRestoreMicroseconds; }
+
+private:
+    struct ObjectBuffer {
+        virtual ~ObjectBuffer() = default;
+    };
+
+    template<typename Component>
+    struct TypedObjectBuffer : ObjectBuffer {
+        std::vector<entt::entity> entities;
+        std::vector<Component> components;
+    };
+
+    struct PoolRecord {
+        std::size_t entityOffset = 0;
+        std::size_t componentOffset = 0;
+        std::size_t count = 0;
+    };
+
+    struct Slot {
+        std::uint64_t tick = 0;
+        bool valid = false;
+
+        std::vector<std::byte> block;
+        std::size_t used = 0;
+
+        std::size_t entityOffset = 0;
+        std::size_t entityCount = 0;
+        std::size_t entitiesInUse = 0;
+        std::size_t extraOffset = 0;
+        std::size_t extraBytes = 0;
+
+        std::vector<PoolRecord> pools;
+        std::vector<std::unique_ptr<ObjectBuffer>> objects;
+
+        // Reserves aligned space in the block, growing it if a snapshot does not fit
+        std::size_t allocate(std::size_t bytes);
+    };
+
+    struct PoolHandler {
+        entt::id_type id;
+        void (*save)(const entt::registry& registry, Slot& slot, std::size_t index);
+        void (*clear)(entt::registry& registry);
+        void (*restore)(entt::registry& registry, const Slot& slot, std::size_t index);
+    };
+
+    template<typename Component>
+    static void savePool(const entt::registry& registry, Slot& slot, std::size_t index);
+    template<typename Component>
+    static void clearPool(entt::registry& registry);
+    template<typename Component>
+    static void restorePool(entt::registry& registry, const Slot& slot, std::size_t index);
+
+    void saveSlot(const entt::registry& registry, std::uint64_t tick, const void* extra, std::size_t extraBytes);
+    bool restoreSlot(entt::registry& registry, std::uint64_t tick, void* extra, std::size_t extraBytes) const;
+    bool checkRegistered(const entt::registry& registry) const;
+
+    std::vector<Slot> slots;
+    std::vector<PoolHandler> handlers;
+
+    std::size_t lastSnapshotBytes = 0;
+    double lastSaveMicroseconds = 0.0;
+    mutable double lastRestoreMicroseconds = 0.0;
+};
+
+// Template implementations
+template<typename Component>
+void SnapshotRing::registerComponent() {
+    entt::id_type id = entt::type_hash<Component>::value();
+    for (const auto& handler : handlers) {
+        if (handler.id == id) return;
+    }
+    handlers.push_back({id, &savePool<Component>, &clearPool<Component>, &restorePool<Component>});
+}
+
+template<typename Extra>
+void SnapshotRing::save(const entt::registry& registry, std::uint64_t tick, const Extra& extra) {
+    static_assert(std::is_trivially_copyable_v<Extra>, "Snapshot extra state must be trivially copyable");
+    saveSlot(registry, tick, &extra, sizeof(Extra));
+}
+
+template<typename Extra>
+bool SnapshotRing::restore(entt::registry& registry, std::uint64_t tick, Extra& extra) const {
+    static_assert(std::is_trivially_copyable_v<Extra>, "Snapshot extra state must be trivially copyable");
+    return restoreSlot(registry, tick, &extra, sizeof(Extra));
+}
+
+template<typename Component>
+void SnapshotRing::savePool(const entt::registry& registry, Slot& slot, std::size_t index) {
+    PoolRecord& record = slot.pools[index];
+    const auto* storage = registry.storage<Component>();
+    record.count = storage ? storage->size() : 0;
+    if (record.count == 0) return;
+
+    if constexpr (std::is_trivially_copyable_v<Component>) {
+        record.entityOffset = slot.allocate(record.count * sizeof(entt::entity));
+        std::memcpy(slot.block.data() + record.entityOffset, storage->data(), record.count * sizeof(entt::entity));
+
+        if constexpr (!std::is_empty_v<Component>) {
+            // Components live in fixed-size pages; copy page by page
+            constexpr std::size_t pageSize = entt::component_traits<Component>::page_size;
+            record.componentOffset = slot.allocate(record.count * sizeof(Component));
+            std::byte* out = slot.block.data() + record.componentOffset;
+            auto pages = storage->raw();
+            for (std::size_t first = 0; first < record.count; first += pageSize) {
+                std::size_t length = std::min(pageSize, record.count - first);
+                std::memcpy(out + first * sizeof(Component), pages[first / pageSize], length * sizeof(Component));
+            }
+        }
+    } else {
+        if (!slot.objects[index]) {
+            slot.objects[index] = std::make_unique<TypedObjectBuffer<Component>>();
+        }
+        auto& buffer = static_cast<TypedObjectBuffer<Component>&>(*slot.objects[index]);
+        buffer.entities.assign(storage->data(), storage->data() + record.count);
+        buffer.components.resize(record.count);
+        for (std::size_t i = 0; i < record.count; i++) {
+            buffer.components[i] = storage->get(buffer.entities[i]);
+        }
+    }
+}
+
+template<typename Component>
+void SnapshotRing::clearPool(entt::registry& registry) {
+    registry.storage<Component>().clear();
+}
+
+template<typename Component>
+void SnapshotRing::restorePool(entt::registry& registry, const Slot& slot, std::size_t index) {
+    const PoolRecord& record = slot.pools[index];
+    if (record.count == 0) return;
+
+    auto& storage = registry.storage<Component>();
+    storage.reserve(record.count);
+
+    if constexpr (std::is_trivially_copyable_v<Component>) {
+        const auto* entities = reinterpret_cast<const entt::entity*>(slot.block.data() + record.entityOffset);
+        if constexpr (std::is_empty_v<Component>) {
+            storage.insert(entities, entities + record.count);
+        } else {
+            const auto* components = reinterpret_cast<const Component*>(slot.block.data() + record.componentOffset);
+            storage.insert(entities, entities + record.count, components);
+        }
+    } else {
+        const auto& buffer = static_cast<const TypedObjectBuffer<Component>&>(*slot.objects[index]);
+        storage.insert(buffer.entities.begin(), buffer.entities.end(), buffer.components.begin());
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "ECS.h"
+#include "PacketCompressor.h"
+#include <enet/enet.h>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Prefab;
+
+// Growth allowed between the start and the end of a soak run: a metric fails
+// when it grows by more than the larger of the absolute and relative limit
+struct SoakThresholds {
+    double residentBytes = 16.0 * 1024 * 1024;
+    double residentFraction = 0.05;
+    double liveAllocations = 5000.0;
+    double allocationFraction = 0.05;
+    double handles = 8.0;
+    double loadedModels = 0.0;
+    double entities = 64.0;
+    double ecsBytes = 1024.0 * 1024;
+    double ecsFraction = 0.10;
+    double frameMilliseconds = 2.0;  // p99 frame time
+    double frameFraction = 0.25;
+};
+
+struct SoakConfig {
+    double durationSeconds = 3600.0;
+    // Metrics are sampled at the end of the first scenario cycle after this many seconds
+    double sampleSeconds = 30.0;
+    // Per-sample CSV, written as the run goes (empty = none)
+    std::string reportPath;
+
+    // Loopback clients connect to the game's own server
+    int port = 12345;
+    bool compression = true;
+    std::size_t botCount = 8;
+    // Swarm entities spawned and destroyed each cycle
+    std::size_t waveSize = 2000;
+    // Loaded and released in turn, one per cycle; empty skips the model
+    // phase (it needs a GL context)
+    std::vector<std::string> modelPaths;
+
+    SoakThresholds thresholds;
+};
+
+// Long-running stress scenario for leak and frame-time regression hunting.
+// Every cycle spawns a wave of entities, connects loopback clients, loads a
+// model, then destroys and disconnects all of it again, so a healthy engine
+// returns to the same state at the end of each cycle. Samples taken there
+// (resident memory, live heap allocations, open handles, entities, loaded
+// models, ECS pool memory and the frame-time distribution) are compared
+// between the start and the end of the run.
+class SoakTest {
+public:
+    struct Sample {
+        double seconds = 0.0;
+        std::size_t cycles = 0;
+        std::size_t residentBytes = 0;
+        std::size_t liveAllocations = 0;
+        std::size_t handles = 0;
+        std::size_t entities = 0;
+        std::size_t loadedModels = 0;
+        std::size_t ecsBytes = 0;
+        std::size_t botsConnected = 0;  // peak during the cycles since the last sample
+        std::size_t frames = 0;
+        double frameP50 = 0.0;
+        double frameP99 = 0.0;
+        double frameMax = 0.0;
+    };
+
+    explicit SoakTest(const SoakConfig& config);
+    ~SoakTest();
+
+    SoakTest(const SoakTest&) = delete;
+    SoakTest& operator=(const SoakTest&) = delete;
+
+    // Advances the scenario; call between frames, on the thread that owns
+    // the GL context, while nothing else touches the world. Returns true
+    // when models were released, so frames recorded earlier must not be drawn.
+    bool Step(ECSSystem& ecs, const Prefab* swarm);
+    // Work time of one frame (simulation plus draw submission)
+    void AddFrameTime(double milliseconds);
+    bool IsFinished() const;
+
+    // Releases everything the scenario still holds, prints the trend of every
+    // metric and returns false if any grew beyond its threshold
+    bool Finish(ECSSystem& ecs);
+
+    const std::vector<Sample>& GetSamples() const { return samples; }
+
+    // Process-wide figures; 0 where the platform offers no way to read them
+    static std::size_t GetResidentBytes();
+    static std::size_t GetOpenHandleCount();
+
+private:
+    enum class Phase {
+        Idle,       // between cycles, and before the first
+        Spawn,      // wave spawned, clients connecting
+        LoadModel,  // one model loaded on its own entity
+        Release,    // everything destroyed, clients disconnecting
+        Settle      // client host destroyed, waiting for the cycle to end
+    };
+
+    void SpawnWave(ECSSystem& ecs, const Prefab* swarm);
+    void LoadModel(ECSSystem& ecs);
+    // Returns true if any model was unloaded
+    bool ReleaseWorld(ECSSystem& ecs);
+    void ConnectBots();
+    void DisconnectBots();
+    void DestroyBots();
+    void ServiceBots();
+    void TakeSample(ECSSystem& ecs);
+
+    SoakConfig config;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point cycleStart;
+    std::chrono::steady_clock::time_point lastSampleTime;
+    Phase phase = Phase::Idle;
+    std::size_t cycles = 0;
+
+    std::vector<entt::entity> waveEntities;
+    entt::entity modelEntity = entt::null;
+
+    ENetHost* botHost = nullptr;
+    PacketCompressor compressor;
+    std::size_t botsConnected = 0;
+    std::size_t peakBotsConnected = 0;
+
+    std::vector<double> frameTimes;  // since the last sample
+    std::vector<Sample> samples;
+    ECSSystem::MemoryStats memoryStats;
+    std::ofstream report;
+};
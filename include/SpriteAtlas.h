@@ -0,0 +1,84 @@
+#pragma once
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One packed sprite. Sprites are trimmed to their opaque pixels before
+// packing; trimOffset and size restore the original footprint so a sprite
+// draws in the same place as the untrimmed image would.
+struct AtlasRegion {
+    std::string name;          // "<prefix><file stem>", e.g. "Side/alien"
+    std::uint16_t page = 0;
+    Rectangle source = {0, 0, 0, 0};   // texels within the page
+    Vector2 trimOffset = {0.0f, 0.0f}; // top-left of source within the original
+    Vector2 size = {0.0f, 0.0f};       // original size, after scaling
+};
+
+// A directory of PNGs packed under a name prefix, optionally downscaled
+struct AtlasSource {
+    std::string directory;
+    std::string prefix;
+    float scale = 1.0f;
+};
+
+// Packs many small images into a few large pages with a skyline packer, so
+// sprites sharing a page can be drawn with one texture bind. An atlas is
+// either built from image directories (at startup or offline with
+// --build-atlas) or loaded from a saved <base>.atlas index and its
+// <base>_<page>.png images.
+class SpriteAtlas {
+public:
+    static constexpr std::uint32_t InvalidRegion = std::numeric_limits<std::uint32_t>::max();
+    static constexpr int DefaultPageSize = 2048;
+    static constexpr int MaxPageSize = 16384;
+    // Transparent texels between sprites so filtering never bleeds
+    static constexpr int Padding = 2;
+
+    SpriteAtlas() = default;
+    ~SpriteAtlas();
+
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    // The Side set at full size and the 512 px Isometric set at a quarter
+    static std::vector<AtlasSource> getDefaultSources(const std::string& assetsRoot);
+
+    bool build(const std::vector<AtlasSource>& sources, int pageSize = DefaultPageSize);
+    // Needs the page images, so save before uploadTextures()
+    bool save(const std::string& basePath) const;
+    // Rejects indices whose regions fall outside their pages
+    bool load(const std::string& basePath);
+    // False if the saved index is missing or older than any source image or
+    // directory, so the atlas has to be rebuilt
+    static bool isCacheCurrent(const std::string& basePath, const std::vector<AtlasSource>& sources);
+
+    // Creates GPU textures (needs a window) and releases the CPU page images
+    bool uploadTextures();
+    void unloadTextures();
+    bool hasTextures() const { return !pageTextures.empty(); }
+
+    std::uint32_t findRegion(const std::string& name) const;
+    const AtlasRegion& getRegion(std::uint32_t id) const { return regions[id]; }
+    std::size_t getRegionCount() const { return regions.size(); }
+    std::size_t getPageCount() const { return pageCount; }
+    int getPageSize() const { return pageSize; }
+    const Texture2D& getPageTexture(std::size_t page) const { return pageTextures[page]; }
+
+    double getLastMilliseconds() const { return lastMilliseconds; }
+
+private:
+    void clear();
+
+    std::vector<AtlasRegion> regions;
+    std::unordered_map<std::string, std::uint32_t> regionIds;
+    std::vector<Image> pageImages;
+    std::vector<Texture2D> pageTextures;
+    std::size_t pageCount = 0;
+    int pageSize = DefaultPageSize;
+    double lastMilliseconds = 0.0;
+};
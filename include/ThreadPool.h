@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// takes part in every loop, so a pool with no workers (web builds, or a
+// thread count of 1) simply runs the loop inline.
+class ThreadPool {
+public:
+    // Task over the half-open index range [begin, end)
+    using RangeTask = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // threadCount includes the calling thread; 0 uses every hardware thread
+    explicit ThreadPool(std::size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t getThreadCount() const { return workers.size() + 1; }
+
+    // Splits [0, count) into ranges of grain indices, handed out to threads as
+    // they become free; returns once every range has run. Not reentrant.
+    void parallelFor(std::size_t count, std::size_t grain, const RangeTask& task);
+
+private:
+    void workerLoop();
+    void runRanges();
+
+    std::vector<boost::thread> workers;
+    boost::mutex mutex;
+    boost::condition_variable workReady;
+    boost::condition_variable workDone;
+
+    // The current loop, published under the mutex
+    const RangeTask* task = nullptr;
+    std::size_t taskCount = 0;
+    std::size_t taskGrain = 1;
+    std::atomic<std::size_t> nextIndex;
+    std::size_t busyWorkers = 0;
+    std::uint64_t generation = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "SpriteAtlas.h"
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct TileMapConfig {
+    // Tiles per chunk side; each chunk is cached in one render texture
+    int chunkSize = 16;
+    // Cell footprint in world units. Isometric maps lay cells out as diamonds,
+    // so (x, y) and (x + 1, y) are half a tile apart on both axes
+    float tileWidth = 64.0f;
+    float tileHeight = 32.0f;
+    bool isometric = true;
+    // World position of the centre of tile (0, 0)
+    Vector2 origin = {0.0f, 0.0f};
+    // World units per atlas texel
+    float tileScale = 2.0f;
+    // Point of the untrimmed tile image (as a fraction of its size) placed at
+    // the cell centre; the Isometric set has its ground diamond just below the middle
+    Vector2 anchor = {0.5f, 0.615f};
+    // Chunks built per frame, so a large edit or a fast pan cannot stall a frame
+    int maxRebuildsPerFrame = 4;
+    // Frames a chunk may stay off screen before its texture is released
+    int evictAfterFrames = 300;
+};
+
+// Static terrain stored as atlas region ids in fixed-size chunks, without an
+// entity per tile. A chunk is drawn into a render texture once and reused
+// every frame until one of its tiles changes, so a frame costs one textured
+// quad per visible chunk however many tiles the level has.
+class TileMap {
+public:
+    static constexpr std::uint32_t EmptyTile = SpriteAtlas::InvalidRegion;
+
+    struct Stats {
+        std::size_t tiles = 0;
+        std::size_t chunks = 0;
+        std::size_t visibleChunks = 0;
+        std::size_t residentTextures = 0;
+        std::size_t textureBytes = 0;
+        std::size_t rebuilds = 0;          // last frame
+        double rebuildMicroseconds = 0.0;  // last frame
+    };
+
+    TileMap(const SpriteAtlas& atlas, const TileMapConfig& config = TileMapConfig());
+
+    TileMap(const TileMap&) = delete;
+    TileMap& operator=(const TileMap&) = delete;
+
+    void setTile(int x, int y, std::uint32_t region);
+    std::uint32_t getTile(int x, int y) const;
+    void fill(int x, int y, int width, int height, std::uint32_t region);
+    void clear();
+
+    // Centre of a cell, and the cell containing a world position
+    Vector2 tileToWorld(int x, int y) const;
+    void worldToTile(Vector2 position, int& x, int& y) const;
+
+    // Builds dirty visible chunks and draws the visible ones in screen space,
+    // at position - cameraOffset like the ECS passes. Call outside BeginMode3D.
+    void render(Vector2 cameraOffset);
+    // Render textures need the GL context; release them before closing the window
+    void unloadTextures();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Chunk {
+        int chunkX = 0;
+        int chunkY = 0;
+        std::vector<std::uint32_t> tiles;
+        std::size_t tileCount = 0;
+        // World-space area covered by the chunk's tile images
+        Rectangle bounds = {0, 0, 0, 0};
+        RenderTexture2D target = {};
+        bool hasTarget = false;
+        bool dirty = true;
+        std::uint64_t lastVisibleFrame = 0;
+    };
+
+    static std::uint64_t chunkKey(int chunkX, int chunkY);
+    Rectangle tileRect(int x, int y, std::uint32_t region) const;
+    void rebuildChunk(Chunk& chunk);
+    void releaseTarget(Chunk& chunk);
+
+    const SpriteAtlas& atlas;
+    TileMapConfig config;
+    std::unordered_map<std::uint64_t, std::unique_ptr<Chunk>> chunks;
+    std::vector<Chunk*> visible;
+    std::uint64_t frame = 0;
+    Stats stats;
+};
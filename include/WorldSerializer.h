@@ -0,0 +1,279 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Append-only byte buffer used by per-element component codecs
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::vector<char>& buffer) : buffer(buffer) {}
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "write() takes trivially copyable values");
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void writeString(const std::string& value) {
+        write(static_cast<std::uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+private:
+    std::vector<char>& buffer;
+};
+
+// Bounds-checked reader over a chunk payload; every read returns false past the end
+class BinaryReader {
+public:
+    BinaryReader(const char* data, std::size_t size) : data(data), size(size) {}
+
+    template<typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "read() takes trivially copyable values");
+        if (size - offset < sizeof(T)) return false;
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        std::uint32_t length = 0;
+        if (!read(length) || size - offset < length) return false;
+        value.assign(data + offset, length);
+        offset += length;
+        return true;
+    }
+
+private:
+    const char* data;
+    std::size_t size;
+    std::size_t offset = 0;
+};
+
+// Streams a whole registry to and from a versioned, chunked binary file.
+//
+// File layout (native byte order, checked on load):
+//   header  "GEWD", u32 version, u32 byte order mark, u32 chunk count
+//   chunk   u32 chunk id, u32 element size, u64 element count, u64 payload bytes, payload
+//
+// The 'ENTS' chunk holds the packed entity pool (u64 in-use count, then the
+// entity array) so ids and versions survive a round trip. Each registered
+// component has its own chunk: the packed entity array of its pool followed
+// either by the raw component pages (trivially copyable components, written
+// and read straight from pool memory) or by codec-encoded elements.
+// Unknown chunks are skipped, so older builds can load newer files as long
+// as the chunks they know keep their element size.
+class WorldSerializer {
+public:
+    // 2: shapes split out of Renderable, Player name and Model3D path moved to cold storage
+    static const std::uint32_t Version = 2;
+
+    // Handlers refer back to the serializer's scratch buffers
+    WorldSerializer() = default;
+    WorldSerializer(const WorldSerializer&) = delete;
+    WorldSerializer& operator=(const WorldSerializer&) = delete;
+
+    // Codecs may capture state, e.g. a table that turns handles into paths
+    template<typename Component>
+    using WriteFunction = std::function<void(BinaryWriter& writer, const Component& component)>;
+    template<typename Component>
+    using ReadFunction = std::function<bool(BinaryReader& reader, Component& component)>;
+
+    static constexpr std::uint32_t makeChunkId(const char (&name)[5]) {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(name[0])) |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(name[1])) << 8 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(name[2])) << 16 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(name[3])) << 24;
+    }
+
+    // Trivially copyable components are stored as raw pool memory. Their bool
+    // members are listed so loads can reject bytes other than 0 and 1, which
+    // would not be valid bool values.
+    template<typename Component>
+    void registerComponent(const char (&chunkName)[5], std::vector<bool Component::*> flags = {});
+
+    // Components owning heap data or referring to external resources provide a codec;
+    // elementVersion goes in the element size field and must change with the encoding
+    template<typename Component>
+    void registerComponent(const char (&chunkName)[5], std::uint32_t elementVersion,
+                           WriteFunction<Component> write, ReadFunction<Component> read);
+
+    bool save(const entt::registry& registry, const std::string& path);
+    // Replaces the registry contents with the file contents. The file is read
+    // into a separate registry first, so a corrupt or truncated file leaves
+    // the registry untouched.
+    bool load(entt::registry& registry, const std::string& path);
+
+    std::uint64_t getLastBytes() const { return lastBytes; }
+    double getLastMilliseconds() const { return lastMilliseconds; }
+
+private:
+    struct ChunkHeader {
+        std::uint32_t id = 0;
+        std::uint32_t elementSize = 0;
+        std::uint64_t count = 0;
+        std::uint64_t payloadBytes = 0;
+    };
+
+    struct PoolHandler {
+        std::uint32_t chunkId;
+        entt::id_type typeId;
+        std::function<void(const entt::registry&, std::ofstream&)> save;
+        std::function<bool(entt::registry&, std::ifstream&, const ChunkHeader&)> load;
+    };
+
+    static void writeChunkHeader(std::ofstream& file, const ChunkHeader& header);
+    static bool readChunkHeader(std::ifstream& file, ChunkHeader& header);
+    // Bytes between the read position and the end of the file being loaded;
+    // every size read from the file is checked against it before allocating
+    std::uint64_t bytesLeft(std::ifstream& file) const;
+    // Reads the chunk's entity array into scratchEntities
+    bool readEntities(std::ifstream& file, std::uint64_t count);
+    // True if every entity in scratchEntities is alive in registry and listed once
+    bool checkEntities(const entt::registry& registry);
+    bool checkRegistered(const entt::registry& registry) const;
+
+    std::vector<PoolHandler> handlers;
+    std::vector<entt::entity> scratchEntities;
+    std::vector<char> scratchBytes;
+    std::vector<std::uint8_t> scratchSeen;  // by entity index
+    std::vector<char> streamBuffer;
+    std::uint64_t fileBytes = 0;
+
+    std::uint64_t lastBytes = 0;
+    double lastMilliseconds = 0.0;
+};
+
+// Template implementations
+template<typename Component>
+void WorldSerializer::registerComponent(const char (&chunkName)[5], std::vector<bool Component::*> flags) {
+    static_assert(std::is_trivially_copyable_v<Component>,
+                  "Components that are not trivially copyable need a codec");
+    static_assert(sizeof(bool) == 1, "bool members are checked byte by byte");
+
+    PoolHandler handler;
+    handler.chunkId = makeChunkId(chunkName);
+    handler.typeId = entt::type_hash<Component>::value();
+
+    handler.save = [chunkId = handler.chunkId](const entt::registry& registry, std::ofstream& file) {
+        const auto* storage = registry.storage<Component>();
+        ChunkHeader header;
+        header.id = chunkId;
+        header.elementSize = std::is_empty_v<Component> ? 0 : sizeof(Component);
+        header.count = storage ? storage->size() : 0;
+        header.payloadBytes = header.count * (sizeof(entt::entity) + header.elementSize);
+        writeChunkHeader(file, header);
+        if (header.count == 0) return;
+
+        file.write(reinterpret_cast<const char*>(storage->data()), header.count * sizeof(entt::entity));
+        if constexpr (!std::is_empty_v<Component>) {
+            constexpr std::size_t pageSize = entt::component_traits<Component>::page_size;
+            auto pages = storage->raw();
+            for (std::size_t first = 0; first < header.count; first += pageSize) {
+                std::size_t length = std::min<std::size_t>(pageSize, header.count - first);
+                file.write(reinterpret_cast<const char*>(pages[first / pageSize]), length * sizeof(Component));
+            }
+        }
+    };
+
+    handler.load = [this, flags](entt::registry& registry, std::ifstream& file, const ChunkHeader& header) {
+        std::uint32_t expectedSize = std::is_empty_v<Component> ? 0 : sizeof(Component);
+        if (header.elementSize != expectedSize ||
+            header.payloadBytes != header.count * (sizeof(entt::entity) + expectedSize)) {
+            return false;
+        }
+        if (!readEntities(file, header.count) || !checkEntities(registry)) return false;
+
+        // Append default components in file order, then overwrite their pages in place
+        auto& storage = registry.storage<Component>();
+        storage.reserve(header.count);
+        storage.insert(scratchEntities.begin(), scratchEntities.end());
+        if constexpr (!std::is_empty_v<Component>) {
+            constexpr std::size_t pageSize = entt::component_traits<Component>::page_size;
+            auto pages = storage.raw();
+            for (std::size_t first = 0; first < header.count; first += pageSize) {
+                std::size_t length = std::min<std::size_t>(pageSize, header.count - first);
+                Component* page = pages[first / pageSize];
+                if (!file.read(reinterpret_cast<char*>(page), length * sizeof(Component))) {
+                    return false;
+                }
+                // Inspect the bytes without reading them as bool
+                for (std::size_t i = 0; i < length; i++) {
+                    for (bool Component::*flag : flags) {
+                        unsigned char byte = 0;
+                        std::memcpy(&byte, &(page[i].*flag), 1);
+                        if (byte > 1) return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    handlers.push_back(std::move(handler));
+}
+
+template<typename Component>
+void WorldSerializer::registerComponent(const char (&chunkName)[5], std::uint32_t elementVersion,
+                                        WriteFunction<Component> write, ReadFunction<Component> read) {
+    PoolHandler handler;
+    handler.chunkId = makeChunkId(chunkName);
+    handler.typeId = entt::type_hash<Component>::value();
+
+    handler.save = [this, chunkId = handler.chunkId, elementVersion, write](const entt::registry& registry, std::ofstream& file) {
+        const auto* storage = registry.storage<Component>();
+        std::size_t count = storage ? storage->size() : 0;
+
+        // Encode first so the chunk length is known without seeking back
+        scratchBytes.clear();
+        BinaryWriter writer(scratchBytes);
+        for (std::size_t i = 0; i < count; i++) {
+            write(writer, storage->get(storage->data()[i]));
+        }
+
+        ChunkHeader header;
+        header.id = chunkId;
+        header.elementSize = elementVersion;
+        header.count = count;
+        header.payloadBytes = count * sizeof(entt::entity) + scratchBytes.size();
+        writeChunkHeader(file, header);
+        if (count == 0) return;
+
+        file.write(reinterpret_cast<const char*>(storage->data()), count * sizeof(entt::entity));
+        file.write(scratchBytes.data(), scratchBytes.size());
+    };
+
+    handler.load = [this, elementVersion, read](entt::registry& registry, std::ifstream& file, const ChunkHeader& header) {
+        if (header.elementSize != elementVersion || header.count > header.payloadBytes / sizeof(entt::entity)) {
+            return false;
+        }
+        std::uint64_t entityBytes = header.count * sizeof(entt::entity);
+        if (!readEntities(file, header.count) || !checkEntities(registry)) return false;
+
+        scratchBytes.resize(header.payloadBytes - entityBytes);
+        if (!file.read(scratchBytes.data(), scratchBytes.size())) return false;
+
+        std::vector<Component> components(header.count);
+        BinaryReader reader(scratchBytes.data(), scratchBytes.size());
+        for (auto& component : components) {
+            if (!read(reader, component)) return false;
+        }
+
+        auto& storage = registry.storage<Component>();
+        storage.reserve(header.count);
+        storage.insert(scratchEntities.begin(), scratchEntities.end(), components.begin());
+        return true;
+    };
+
+    handlers.push_back(std::move(handler));
+}
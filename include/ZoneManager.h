@@ -0,0 +1,152 @@
+#pragma once
+
+#include "ECS.h"
+#include "MessageChannel.h"
+#include <enet/enet.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/thread.hpp>
+
+class NetworkManager;
+class PhysicsWorld;
+
+// Server-side entity of a connected client, positioned by its POS messages
+struct RemotePlayer {
+    ENetPeer* peer = nullptr;
+    std::uint32_t connectId = 0;
+};
+
+// Read-only stand-in for an entity owned by a neighbouring zone that is within
+// the ghost margin of the shared boundary. Ghosts are not simulated, rendered
+// or migrated; they only make the entity visible from the other side.
+struct Ghost {
+    std::uint32_t sourceZone = 0;
+    entt::entity source = entt::null;
+    std::int32_t peerId = -1;  // ENet peer id if the source is a remote player
+    std::uint64_t generation = 0;
+};
+
+struct ZoneConfig {
+    std::size_t zoneCount = 2;
+    // Zones are vertical strips: zone i covers x in [originX + i * zoneWidth,
+    // originX + (i + 1) * zoneWidth); the first and last extend to infinity
+    float originX = 0.0f;
+    float zoneWidth = 500.0f;
+    // Entities this close to a boundary are ghosted into the neighbour
+    float ghostMargin = 150.0f;
+    // Clients get the positions of other players within this distance
+    float viewRadius = 600.0f;
+    // Collisions within each zone, serial since the zones already run in
+    // parallel; bodies in different zones do not collide
+    bool physics = true;
+};
+
+// Splits the server world into spatial zones, each with its own registry
+// simulated on its own thread. A tick runs every zone in parallel between two
+// barriers, then hands off entities that crossed a boundary, refreshes ghosts
+// and drops players of disconnected peers on the calling thread.
+class ZoneManager {
+public:
+    struct Stats {
+        double parallelMicroseconds = 0.0;     // wall time of the parallel phase
+        double slowestZoneMicroseconds = 0.0;
+        double serialMicroseconds = 0.0;       // handoff and ghost refresh
+        std::size_t migrations = 0;            // last step
+        std::uint64_t totalMigrations = 0;
+        std::size_t ghosts = 0;
+    };
+
+    explicit ZoneManager(const ZoneConfig& config);
+    ~ZoneManager();
+
+    ZoneManager(const ZoneManager&) = delete;
+    ZoneManager& operator=(const ZoneManager&) = delete;
+
+    std::size_t getZoneCount() const { return zones.size(); }
+    std::size_t zoneAt(Vector2 position) const;
+    ECSSystem& getZone(std::size_t index) { return zones[index]->ecs; }
+    // Owned entities, ghosts excluded
+    std::size_t getEntityCount(std::size_t index);
+    std::size_t getPlayerCount() const { return peers.size(); }
+    const Stats& getStats() const { return stats; }
+
+    // Moves every entity with an ECSTransform (except keep) out of source and
+    // into the zone containing it; returns the number moved
+    std::size_t adoptEntities(ECSSystem& source, entt::entity keep = entt::null);
+
+    // Handoffs only carry model paths, since loading needs the GL context;
+    // this loads the models entities brought into zones that lacked them.
+    // Call between steps on the GL thread; returns the number loaded.
+    std::size_t loadPendingModels();
+    // Every zone's GPU models; call before the GL context closes
+    void unloadModels();
+
+    // Position reported by a client; creates its player entity on first report
+    void setPeerPosition(ENetPeer* peer, Vector2 position);
+
+    // One simulation tick for every zone; must not overlap other calls
+    void step(float deltaTime);
+    // Queues each client's view of its zone built during the last step
+    void sendUpdates(NetworkManager& network);
+
+    // Records the owned entities of every zone into the frame, seen from
+    // frame.cameraOffset
+    void buildRenderCommands(RenderFrame& frame);
+
+private:
+    struct OutgoingMessage {
+        ENetPeer* peer;
+        std::size_t offset;
+        std::size_t length;
+        MessageChannel channel;
+    };
+
+    struct Zone {
+        std::size_t index = 0;
+        ECSSystem ecs;
+        std::unique_ptr<PhysicsWorld> physics;
+        // Ghosts by source zone and entity
+        std::unordered_map<std::uint64_t, entt::entity> ghosts;
+        // Owned entities that left the zone's strip this step
+        std::vector<entt::entity> leaving;
+        // Messages for the clients served by this zone until sendUpdates()
+        std::vector<char> outboxBuffer;
+        std::vector<OutgoingMessage> outbox;
+        double lastStepMicroseconds = 0.0;
+    };
+
+    struct PeerLocation {
+        std::size_t zone;
+        entt::entity entity;
+    };
+
+    void workerLoop(std::size_t index);
+    void simulateZone(Zone& zone, float deltaTime);
+    void queueMessage(Zone& zone, ENetPeer* peer, const char* message, int length, MessageChannel channel);
+    void migrate();
+    void refreshGhosts();
+    void ghostInto(Zone& target, std::size_t sourceZone, entt::entity source, const ECSTransform& transform,
+                   std::int32_t peerId);
+    void removeDisconnectedPeers();
+    void notifyZone(ENetPeer* peer, std::size_t zone);
+
+    ZoneConfig config;
+    std::vector<std::unique_ptr<Zone>> zones;
+    std::unordered_map<ENetPeer*, PeerLocation> peers;
+    // Set by handoffs that left a zone with an unloaded model
+    bool modelsPending = false;
+
+    // Zone 0 runs on the calling thread, every other zone on its own worker
+    std::vector<boost::thread> workers;
+    std::unique_ptr<boost::barrier> barrier;
+    std::atomic<bool> stopping;
+    float stepDeltaTime = 0.0f;
+
+    std::uint64_t ghostGeneration = 0;
+    Stats stats;
+};
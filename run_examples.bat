@@ -26,5 +26,22 @@ echo.
 echo 6. Connect to remote server:
 echo build\Release\GameEngine.exe --host 192.168.1.100 --port 12345
 
+echo.
+echo 7. Record a deterministic session, then replay it headless:
+echo build\Release\GameEngine.exe --record session.replay --seed 42
+echo build\Release\GameEngine.exe --replay session.replay
+
+echo.
+echo 8. Load test with 1000 bot clients against an in-process server:
+echo build\Release\LoadTest.exe --embedded-server --clients 1000 --ramp-step 100
+
+echo.
+echo 9. Server with the world split into 4 zones, one thread each:
+echo build\Release\GameEngine.exe --server --headless --zones 4
+
+echo.
+echo 10. Pack the sprite atlas offline:
+echo build\Release\GameEngine.exe --build-atlas --atlas sprites
+
 echo.
 pause
@@ -28,3 +28,20 @@ echo "6. Connect to remote server:"
 echo "./build/GameEngine --host 192.168.1.100 --port 12345"
 
 echo
+echo "7. Record a deterministic session, then replay it headless:"
+echo "./build/GameEngine --record session.replay --seed 42"
+echo "./build/GameEngine --replay session.replay"
+
+echo
+echo "8. Load test with 1000 bot clients against an in-process server:"
+echo "./build/LoadTest --embedded-server --clients 1000 --ramp-step 100"
+
+echo
+echo "9. Server with the world split into 4 zones, one thread each:"
+echo "./build/GameEngine --server --headless --zones 4"
+
+echo
+echo "10. Pack the sprite atlas offline:"
+echo "./build/GameEngine --build-atlas --atlas sprites"
+
+echo
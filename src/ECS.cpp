@@ -1,5 +1,82 @@
 #include "ECS.h"
+#include "FrameArena.h"
+#include "Prefab.h"
+#include "RenderFrame.h"
+#include "SnapshotRing.h"
+#include "SpriteAtlas.h"
+#include "WorldSerializer.h"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    // Bool members of raw world chunks, checked on load
+    template<typename Component>
+    std::vector<bool Component::*> BoolMembers(ComponentTag<Component>) {
+        return {};
+    }
+    std::vector<bool Alien3D::*> BoolMembers(ComponentTag<Alien3D>) {
+        return {&Alien3D::isAlien};
+    }
+    std::vector<bool Networked::*> BoolMembers(ComponentTag<Networked>) {
+        return {&Networked::needsSync};
+    }
+    std::vector<bool Collider::*> BoolMembers(ComponentTag<Collider>) {
+        return {&Collider::isCircle};
+    }
+    std::vector<bool RigidBody::*> BoolMembers(ComponentTag<RigidBody>) {
+        return {&RigidBody::sleeping};
+    }
+    
+    // Heap memory a component owns beyond its own size; short strings live inline
+    std::size_t StringHeapBytes(const std::string& text) {
+        return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+    }
+    std::size_t OwnedHeapBytes(const PlayerName& playerName) { return StringHeapBytes(playerName.name); }
+    
+    template<typename Component>
+    ECSSystem::PoolMemory MeasurePool(const entt::registry& registry, std::string_view name) {
+        ECSSystem::PoolMemory pool;
+        pool.name = name;
+        const auto* storage = registry.storage<Component>();
+        if (!storage) return pool;
+        
+        // The storage's own capacity() is its payload capacity; the packed
+        // entity array has to be asked through the sparse set
+        std::size_t packedCapacity = storage->entt::sparse_set::capacity();
+        pool.count = storage->size();
+        pool.capacity = packedCapacity;
+        pool.packedBytes = packedCapacity * sizeof(entt::entity);
+        pool.sparseBytes = storage->extent() * sizeof(entt::entity);
+        pool.unusedBytes = (packedCapacity - pool.count) * sizeof(entt::entity);
+        if constexpr (!std::is_empty_v<Component>) {
+            pool.capacity = storage->capacity();
+            pool.componentBytes = pool.capacity * sizeof(Component);
+            pool.unusedBytes += (pool.capacity - pool.count) * sizeof(Component);
+        }
+        if constexpr (!std::is_trivially_copyable_v<Component>) {
+            for (const Component& component : *storage) {
+                pool.heapBytes += OwnedHeapBytes(component);
+            }
+        }
+        return pool;
+    }
+    
+    template<typename Component>
+    void CompactPool(entt::registry& registry, bool sortByEntity) {
+        if (!std::as_const(registry).storage<Component>()) return;
+        
+        auto& storage = registry.storage<Component>();
+        storage.shrink_to_fit();
+        if (sortByEntity && storage.size() > 1) {
+            registry.sort<Component>([](entt::entity lhs, entt::entity rhs) {
+                return entt::to_entity(lhs) < entt::to_entity(rhs);
+            });
+        }
+    }
+}
 
 entt::entity ECSSystem::createEntity() {
     return registry.create();
@@ -9,6 +86,26 @@ void ECSSystem::destroyEntity(entt::entity entity) {
     registry.destroy(entity);
 }
 
+entt::entity ECSSystem::spawnPrefab(const Prefab& prefab) {
+    entt::entity entity = registry.create();
+    prefab.instantiate(registry, &entity, &entity + 1);
+    return entity;
+}
+
+void ECSSystem::spawnPrefab(const Prefab& prefab, std::size_t count, std::vector<entt::entity>& out) {
+    if (count == 0) return;
+    
+    std::size_t first = out.size();
+    out.resize(first + count);
+    
+    auto& entities = registry.storage<entt::entity>();
+    entities.reserve(entities.size() + count);
+    registry.create(out.begin() + first, out.end());
+    
+    const entt::entity* begin = out.data() + first;
+    prefab.instantiate(registry, begin, begin + count);
+}
+
 void ECSSystem::updateMovement(float deltaTime) {
     // Update entities with ECSTransform and Velocity components
     auto view = registry.view<ECSTransform, Velocity>();
@@ -31,22 +128,20 @@ void ECSSystem::updateMovement(float deltaTime) {
 
 void ECSSystem::updateCamera(float deltaTime) {
     if (cameraTarget == entt::null || !registry.valid(cameraTarget)) {
-        std::cout << "DEBUG: No valid camera target set" << std::endl;
+        if (debugLogging) std::cout << "DEBUG: No valid camera target set" << std::endl;
         return;
     }
-    std::cout << "DEBUG: Camera target entity ID: " << static_cast<uint32_t>(cameraTarget) << std::endl;
+    if (debugLogging) {
+        std::cout << "DEBUG: Camera target entity ID: " << static_cast<uint32_t>(cameraTarget) << std::endl;
+    }
 
     if (!registry.all_of<ECSTransform>(cameraTarget)) {
-        std::cout << "DEBUG: Camera target entity has no transform component" << std::endl;
+        if (debugLogging) std::cout << "DEBUG: Camera target entity has no transform component" << std::endl;
         return;
     }
     
     const auto& targetTransform = registry.get<ECSTransform>(cameraTarget);
     
-    // Debug: Display target position
-    std::cout << "DEBUG: Target position - X: " << targetTransform.position.x 
-              << ", Y: " << targetTransform.position.y << std::endl;
-    
     // Calculate the desired camera offset to center the target
     Vector2 screenCenter = {400.0f, 300.0f}; // Half of 800x600 window
     Vector2 desiredOffset = {
@@ -54,15 +149,21 @@ void ECSSystem::updateCamera(float deltaTime) {
         screenCenter.y - targetTransform.position.y
     };
     
-    // Debug: Display desired camera offset
-    std::cout << "DEBUG: Desired camera offset - X: " << desiredOffset.x 
-              << ", Y: " << desiredOffset.y << std::endl;
-    
     // Smoothly interpolate camera offset
     float smoothFactor = 5.0f * deltaTime;
     cameraOffset.x += (desiredOffset.x - cameraOffset.x) * smoothFactor;
     cameraOffset.y += (desiredOffset.y - cameraOffset.y) * smoothFactor;
     
+    if (!debugLogging) return;
+    
+    // Debug: Display target position
+    std::cout << "DEBUG: Target position - X: " << targetTransform.position.x 
+              << ", Y: " << targetTransform.position.y << std::endl;
+    
+    // Debug: Display desired camera offset
+    std::cout << "DEBUG: Desired camera offset - X: " << desiredOffset.x 
+              << ", Y: " << desiredOffset.y << std::endl;
+    
     // Debug: Display current camera offset (actual camera position)
     std::cout << "DEBUG: Current camera position (offset) - X: " << cameraOffset.x 
               << ", Y: " << cameraOffset.y << std::endl;
@@ -77,96 +178,125 @@ void ECSSystem::updateCamera(float deltaTime) {
     std::cout << "---" << std::endl;
 }
 
-void ECSSystem::updateRendering() {
+void ECSSystem::buildRenderCommands(RenderFrame& frame) {
     // Apply camera offset to all rendering
     Vector2 cameraPos = cameraOffset;
     
-    // Render entities with ECSTransform and Renderable components (2D)
-    auto view2D = registry.view<ECSTransform, Renderable>();
-    
-    for (auto entity : view2D) {
-        const auto& transform = view2D.get<ECSTransform>(entity);
-        const auto& renderable = view2D.get<Renderable>(entity);
-        
+    // Entities with ECSTransform and Renderable components (2D), one pass per
+    // shape pool so neither loop branches on the shape
+    for (auto [entity, transform, renderable, circle] : registry.view<ECSTransform, Renderable, CircleShape>().each()) {
         // Apply camera offset to position (subtract to move world opposite to camera)
         Vector2 screenPos = {
             transform.position.x - cameraPos.x,
             transform.position.y - cameraPos.y
         };
-        
-        if (renderable.isCircle) {
-            DrawCircleV(screenPos, renderable.radius, renderable.color);
-        } else {
-            Rectangle rect = renderable.rect;
-            rect.x = screenPos.x - rect.width / 2;
-            rect.y = screenPos.y - rect.height / 2;
-            DrawRectangleRec(rect, renderable.color);
-        }
+        frame.circles.push_back(RenderFrame::Circle{screenPos, circle.radius, renderable.color});
     }
     
-    // Render entities with ECSTransform and Model3D components (3D)
-    auto view3D = registry.view<ECSTransform, Model3D>();
-    
-    for (auto entity : view3D) {
-        const auto& transform = view3D.get<ECSTransform>(entity);
-        const auto& model3D = view3D.get<Model3D>(entity);
-        
-        if (model3D.isLoaded) {
-            // Apply camera offset to 3D position (subtract to move world opposite to camera)
-            Vector3 modelPos = { 
-                transform.position.x - cameraPos.x, 
-                transform.position.y - cameraPos.y, 
-                0.0f 
-            };
-            DrawModel(model3D.model, modelPos, model3D.scale, WHITE);
-            
-            // Draw wireframe bounding box for debugging
-            BoundingBox bbox = GetModelBoundingBox(model3D.model);
-            DrawBoundingBox(bbox, RED);
-        } else {
-            // If model not loaded, draw a placeholder
-            Vector3 spherePos = { 
-                transform.position.x - cameraPos.x, 
-                transform.position.y - cameraPos.y, 
-                0.0f 
-            };
-            DrawSphere(spherePos, 10.0f, YELLOW);
-        }
+    for (auto [entity, transform, renderable, box] : registry.view<ECSTransform, Renderable, BoxShape>().each()) {
+        Rectangle rect = {
+            transform.position.x - cameraPos.x - box.size.x / 2,
+            transform.position.y - cameraPos.y - box.size.y / 2,
+            box.size.x,
+            box.size.y
+        };
+        frame.boxes.push_back(RenderFrame::Box{rect, renderable.color});
     }
     
-    // Render entities with ECSTransform and Alien3D components (3D Alien)
-    auto viewAlien = registry.view<ECSTransform, Alien3D>();
+    // Entities with ECSTransform and Model3D components (3D); unloaded models
+    // are drawn as a placeholder
+    for (auto [entity, transform, model3D] : registry.view<ECSTransform, Model3D>().each()) {
+        Vector3 modelPos = { 
+            transform.position.x - cameraPos.x, 
+            transform.position.y - cameraPos.y, 
+            0.0f 
+        };
+        bool loaded = isModelLoaded(model3D.model);
+        frame.models.push_back(RenderFrame::ModelDraw{loaded ? models[model3D.model].model : Model{}, modelPos,
+                                                      model3D.scale, loaded});
+    }
     
-    for (auto entity : viewAlien) {
-        const auto& transform = viewAlien.get<ECSTransform>(entity);
-        const auto& alien = viewAlien.get<Alien3D>(entity);
-        
-        // Apply camera offset to 3D position (subtract to move world opposite to camera)
+    // Entities with ECSTransform and Alien3D components (3D Alien)
+    for (auto [entity, transform, alien] : registry.view<ECSTransform, Alien3D>().each()) {
         Vector3 alienPos = { 
             transform.position.x - cameraPos.x, 
             transform.position.y - cameraPos.y, 
             0.0f 
         };
+        frame.aliens.push_back(RenderFrame::Alien{alienPos, alien.size, alien.color});
+    }
+}
+
+void ECSSystem::buildSpriteCommands(RenderFrame& frame) {
+    spriteStats = SpriteStats{};
+    if (!spriteAtlas || !spriteAtlas->hasTextures()) return;
+    
+    // Skip off-screen sprites; the frame's own buffer keeps its capacity
+    float screenWidth = frame.screenSize.x;
+    float screenHeight = frame.screenSize.y;
+    std::size_t first = frame.sprites.size();
+    auto view = registry.view<ECSTransform, Sprite>();
+    frame.sprites.reserve(first + view.size_hint());
+    
+    for (auto [entity, transform, sprite] : view.each()) {
+        if (sprite.region >= spriteAtlas->getRegionCount()) continue;
+        const AtlasRegion& region = spriteAtlas->getRegion(sprite.region);
         
-        // Draw alien body (sphere)
-        DrawSphere(alienPos, alien.size * 15.0f, alien.color);
-        
-        // Draw alien head (smaller sphere on top)
-        Vector3 headPos = { alienPos.x, alienPos.y - alien.size * 20.0f, alienPos.z };
-        DrawSphere(headPos, alien.size * 8.0f, alien.color);
-        
-        // Draw alien eyes (two small spheres)
-        Vector3 leftEye = { headPos.x - 3.0f, headPos.y - 2.0f, headPos.z + 5.0f };
-        Vector3 rightEye = { headPos.x + 3.0f, headPos.y - 2.0f, headPos.z + 5.0f };
-        DrawSphere(leftEye, 2.0f, BLACK);
-        DrawSphere(rightEye, 2.0f, BLACK);
+        // The trimmed quad sits where it was inside the original, untrimmed image
+        float scaleX = sprite.scale * transform.scale.x;
+        float scaleY = sprite.scale * transform.scale.y;
+        float x = transform.position.x - cameraOffset.x + (region.trimOffset.x - region.size.x / 2) * scaleX;
+        float y = transform.position.y - cameraOffset.y + (region.trimOffset.y - region.size.y / 2) * scaleY;
+        float width = region.source.width * scaleX;
+        float height = region.source.height * scaleY;
         
-        // Draw alien antennae (two cylinders)
-        Vector3 leftAntenna = { headPos.x - 4.0f, headPos.y - 8.0f, headPos.z };
-        Vector3 rightAntenna = { headPos.x + 4.0f, headPos.y - 8.0f, headPos.z };
-        DrawCylinder(leftAntenna, 1.0f, 1.0f, 8.0f, 8, alien.color);
-        DrawCylinder(rightAntenna, 1.0f, 1.0f, 8.0f, 8, alien.color);
+        if (x + width < 0.0f || y + height < 0.0f || x > screenWidth || y > screenHeight) {
+            spriteStats.culled++;
+            continue;
+        }
+        frame.sprites.push_back(RenderFrame::SpriteQuad{sprite.layer, region.page,
+                                                        {x, y, width, height}, region.source, sprite.tint});
     }
+    
+    // Sort small keys rather than whole quads, then gather the quads in key
+    // order; both scratch arrays come from the frame arena. The index breaks
+    // ties, so overlapping sprites keep a stable order from frame to frame.
+    struct SortKey {
+        std::int16_t layer;
+        std::uint16_t page;
+        float bottom;
+        std::uint32_t index;
+    };
+    std::pmr::memory_resource* scratch = getFrameResource();
+    std::size_t count = frame.sprites.size() - first;
+    std::pmr::vector<SortKey> keys(scratch);
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        const RenderFrame::SpriteQuad& quad = frame.sprites[first + i];
+        keys.push_back(SortKey{quad.layer, quad.page, quad.destination.y + quad.destination.height,
+                               static_cast<std::uint32_t>(i)});
+    }
+    std::sort(keys.begin(), keys.end(), [](const SortKey& a, const SortKey& b) {
+        if (a.layer != b.layer) return a.layer < b.layer;
+        if (a.page != b.page) return a.page < b.page;
+        if (a.bottom != b.bottom) return a.bottom < b.bottom;
+        return a.index < b.index;
+    });
+    std::pmr::vector<RenderFrame::SpriteQuad> sorted(scratch);
+    sorted.reserve(count);
+    for (const SortKey& key : keys) {
+        sorted.push_back(frame.sprites[first + key.index]);
+    }
+    auto begin = frame.sprites.begin() + static_cast<std::ptrdiff_t>(first);
+    std::copy(sorted.begin(), sorted.end(), begin);
+    
+    // Count the batches drawSprites will submit, one per run of the same page
+    for (auto it = begin; it != frame.sprites.end(); ++it) {
+        if (it == begin || it->page != (it - 1)->page || it->layer != (it - 1)->layer) {
+            spriteStats.batches++;
+        }
+    }
+    spriteStats.drawn = frame.sprites.size() - first;
 }
 
 void ECSSystem::updateNetworkSync() {
@@ -177,9 +307,10 @@ void ECSSystem::updateNetworkSync() {
         auto& transform = view.get<ECSTransform>(entity);
         auto& networked = view.get<Networked>(entity);
         
-        // Mark for network sync if position changed significantly
+        // Mark for network sync; the sender formats the message from the
+        // captured position, so nothing here touches the heap
         networked.needsSync = true;
-        networked.lastSyncData = "POS:" + std::to_string(transform.position.x) + "," + std::to_string(transform.position.y);
+        networked.syncPosition = transform.position;
     }
 }
 
@@ -189,35 +320,248 @@ bool ECSSystem::loadModel3D(entt::entity entity, const std::string& modelPath, f
         return false;
     }
     
+    std::uint32_t handle = addModel(modelPath);
+    ModelAsset& asset = models[handle];
+    
+    if (!asset.loaded) {
+        // Debug: Print the model path being loaded
+        std::cout << "Attempting to load model: " << modelPath << std::endl;
+        
+        // Load the model
+        Model model = LoadModel(modelPath.c_str());
+        
+        if (model.meshCount == 0) {
+            std::cerr << "Failed to load model: " << modelPath << std::endl;
+            return false;
+        }
+        
+        asset.model = model;
+        asset.loaded = true;
+        
+        std::cout << "Successfully loaded model: " << modelPath << std::endl;
+        std::cout << "Model info - Mesh count: " << model.meshCount << ", Scale: " << scale << std::endl;
+        
+        // Get and print bounding box info
+        BoundingBox bbox = GetModelBoundingBox(model);
+        std::cout << "Bounding box - Min: (" << bbox.min.x << ", " << bbox.min.y << ", " << bbox.min.z 
+                  << ") Max: (" << bbox.max.x << ", " << bbox.max.y << ", " << bbox.max.z << ")" << std::endl;
+    }
+    
     auto& model3D = registry.get<Model3D>(entity);
+    model3D.model = handle;
+    model3D.scale = scale;
+    return true;
+}
+
+std::uint32_t ECSSystem::addModel(const std::string& modelPath) {
+    for (std::size_t i = 0; i < models.size(); i++) {
+        if (models[i].path == modelPath) {
+            return static_cast<std::uint32_t>(i);
+        }
+    }
+    models.push_back(ModelAsset{modelPath});
+    return static_cast<std::uint32_t>(models.size() - 1);
+}
+
+const std::string& ECSSystem::getModelPath(std::uint32_t model) const {
+    static const std::string noPath;
+    return model < models.size() ? models[model].path : noPath;
+}
+
+bool ECSSystem::isModelLoaded(std::uint32_t model) const {
+    return model < models.size() && models[model].loaded;
+}
+
+void ECSSystem::unloadModels() {
+    for (auto& asset : models) {
+        if (asset.loaded) {
+            UnloadModel(asset.model);
+            asset.model = Model{};
+            asset.loaded = false;
+        }
+    }
+}
+
+std::size_t ECSSystem::reloadModels() {
+    // Only paths some entity still refers to
+    std::vector<bool> used(models.size(), false);
+    for (auto [entity, model3D] : registry.view<Model3D>().each()) {
+        if (model3D.model < models.size()) {
+            used[model3D.model] = true;
+        }
+    }
     
-    // Debug: Print the model path being loaded
-    std::cout << "Attempting to load model: " << modelPath << std::endl;
+    std::size_t loaded = 0;
+    for (std::size_t i = 0; i < models.size(); i++) {
+        ModelAsset& asset = models[i];
+        if (!used[i] || asset.loaded || asset.path.empty()) continue;
+        
+        asset.model = LoadModel(asset.path.c_str());
+        if (asset.model.meshCount == 0) {
+            std::cerr << "Failed to load model: " << asset.path << std::endl;
+            asset.model = Model{};
+            continue;
+        }
+        asset.loaded = true;
+        loaded++;
+    }
+    return loaded;
+}
+
+std::size_t ECSSystem::releaseUnusedModels() {
+    std::vector<bool> used(models.size(), false);
+    for (auto [entity, model3D] : registry.view<Model3D>().each()) {
+        if (model3D.model < models.size()) {
+            used[model3D.model] = true;
+        }
+    }
     
-    // Load the model
-    Model model = LoadModel(modelPath.c_str());
+    std::size_t released = 0;
+    for (std::size_t i = 0; i < models.size(); i++) {
+        ModelAsset& asset = models[i];
+        if (used[i] || !asset.loaded) continue;
+        
+        UnloadModel(asset.model);
+        asset.model = Model{};
+        asset.loaded = false;
+        released++;
+    }
+    return released;
+}
+
+std::size_t ECSSystem::getLoadedModelCount() const {
+    std::size_t loaded = 0;
+    for (const auto& asset : models) {
+        loaded += asset.loaded ? 1 : 0;
+    }
+    return loaded;
+}
+
+void ECSSystem::setCameraTarget(entt::entity targetEntity) {
+    cameraTarget = targetEntity;
+}
+
+std::uint64_t ECSSystem::computeStateHash() {
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
     
-    if (model.meshCount == 0) {
-        std::cerr << "Failed to load model: " << modelPath << std::endl;
-        return false;
+    for (auto [entity, transform] : registry.view<ECSTransform>().each()) {
+        mix(&entity, sizeof(entity));
+        mix(&transform, sizeof(transform));
     }
+    for (auto [entity, velocity] : registry.view<Velocity>().each()) {
+        mix(&entity, sizeof(entity));
+        mix(&velocity, sizeof(velocity));
+    }
+    mix(&cameraOffset, sizeof(cameraOffset));
     
-    model3D.model = model;
-    model3D.isLoaded = true;
-    model3D.modelPath = modelPath;
-    model3D.scale = scale;
+    return hash;
+}
+
+void ECSSystem::registerSnapshotComponents(SnapshotRing& snapshots) const {
+    forEachComponentType([&](auto tag, const char*, const char*) {
+        snapshots.registerComponent<typename decltype(tag)::type>();
+    });
+}
+
+void ECSSystem::registerWorldComponents(WorldSerializer& serializer) {
+    forEachComponentType([&](auto tag, const char*, const auto& chunkId) {
+        using Component = typename decltype(tag)::type;
+        if constexpr (std::is_same_v<Component, Model3D>) {
+            // Only the path and scale of a model are stored; the handle is looked up
+            // again on load and the model is reloaded afterwards
+            serializer.registerComponent<Model3D>(chunkId, 1,
+                [this](BinaryWriter& writer, const Model3D& model3D) {
+                    writer.writeString(getModelPath(model3D.model));
+                    writer.write(model3D.scale);
+                },
+                [this, path = std::string()](BinaryReader& reader, Model3D& model3D) mutable {
+                    if (!reader.readString(path) || !reader.read(model3D.scale)) return false;
+                    model3D.model = path.empty() ? Model3D::InvalidModel : addModel(path);
+                    return true;
+                });
+        } else if constexpr (std::is_same_v<Component, PlayerName>) {
+            serializer.registerComponent<PlayerName>(chunkId, 1,
+                [](BinaryWriter& writer, const PlayerName& playerName) {
+                    writer.writeString(playerName.name);
+                },
+                [](BinaryReader& reader, PlayerName& playerName) {
+                    return reader.readString(playerName.name);
+                });
+        } else {
+            serializer.registerComponent<Component>(chunkId, BoolMembers(tag));
+        }
+    });
+}
+
+void ECSSystem::collectMemoryStats(MemoryStats& stats) {
+    stats.pools.clear();
+    stats.totalBytes = 0;
+    stats.unusedBytes = 0;
+    
+    std::vector<entt::id_type> measured;
+    const entt::registry& pools = registry;
+    forEachComponentType([&](auto tag, const char* name, const char*) {
+        using Component = typename decltype(tag)::type;
+        stats.pools.push_back(MeasurePool<Component>(pools, name));
+        measured.push_back(entt::type_hash<Component>::value());
+    });
     
-    std::cout << "Successfully loaded model: " << modelPath << std::endl;
-    std::cout << "Model info - Mesh count: " << model.meshCount << ", Scale: " << scale << std::endl;
+    // Pools added outside this class (zone bookkeeping, tags) by type name;
+    // without the type only the entity arrays can be counted
+    for (auto [id, pool] : pools.storage()) {
+        if (std::find(measured.begin(), measured.end(), id) != measured.end()) continue;
+        PoolMemory other;
+        other.name = pool.type().name();
+        other.count = pool.size();
+        other.capacity = pool.entt::sparse_set::capacity();
+        other.packedBytes = other.capacity * sizeof(entt::entity);
+        other.sparseBytes = pool.extent() * sizeof(entt::entity);
+        other.unusedBytes = (other.capacity - other.count) * sizeof(entt::entity);
+        stats.pools.push_back(other);
+    }
     
-    // Get and print bounding box info
-    BoundingBox bbox = GetModelBoundingBox(model);
-    std::cout << "Bounding box - Min: (" << bbox.min.x << ", " << bbox.min.y << ", " << bbox.min.z 
-              << ") Max: (" << bbox.max.x << ", " << bbox.max.y << ", " << bbox.max.z << ")" << std::endl;
+    // Destroyed entities keep their slot (and version) in the entity pool, so
+    // only the capacity past every slot ever used can be returned
+    auto& entities = registry.storage<entt::entity>();
+    PoolMemory entityPool;
+    entityPool.name = "entity";
+    entityPool.count = entities.in_use();
+    entityPool.capacity = entities.entt::sparse_set::capacity();
+    entityPool.packedBytes = entityPool.capacity * sizeof(entt::entity);
+    entityPool.sparseBytes = entities.extent() * sizeof(entt::entity);
+    entityPool.unusedBytes = (entityPool.capacity - entities.size()) * sizeof(entt::entity);
+    stats.pools.push_back(entityPool);
     
-    return true;
+    for (const PoolMemory& pool : stats.pools) {
+        stats.totalBytes += pool.totalBytes();
+        stats.unusedBytes += pool.unusedBytes;
+    }
 }
 
-void ECSSystem::setCameraTarget(entt::entity targetEntity) {
-    cameraTarget = targetEntity;
+std::size_t ECSSystem::compactStorage(bool sortByEntity) {
+    MemoryStats before;
+    collectMemoryStats(before);
+    
+    forEachComponentType([&](auto tag, const char*, const char*) {
+        CompactPool<typename decltype(tag)::type>(registry, sortByEntity);
+    });
+    registry.storage<entt::entity>().shrink_to_fit();
+    
+    MemoryStats after;
+    collectMemoryStats(after);
+    return before.totalBytes > after.totalBytes ? before.totalBytes - after.totalBytes : 0;
+}
+
+std::pmr::memory_resource* ECSSystem::getFrameResource() const {
+    if (frameArena) {
+        return frameArena;
+    }
+    return std::pmr::get_default_resource();
 }
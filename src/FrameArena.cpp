@@ -0,0 +1,186 @@
+#include "FrameArena.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::size_t> heapAllocationCount{0};
+    std::atomic<std::size_t> heapFreeCount{0};
+
+    std::byte* AlignUp(std::byte* ptr, std::size_t alignment) {
+        auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        auto aligned = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        return ptr + (aligned - address);
+    }
+}
+
+FrameArena::FrameArena(std::size_t initialCapacity, std::pmr::memory_resource* upstream)
+    : upstream(upstream)
+    , block(nullptr)
+    , capacity(initialCapacity)
+    , offset(0)
+    , overflowHead(nullptr)
+    , overflowCursor(nullptr)
+    , overflowEnd(nullptr)
+    , overflowBytes(0)
+    , bytesUsed(0)
+    , peakBytesUsed(0)
+    , overflowCount(0) {
+    if (capacity > 0) {
+        block = static_cast<std::byte*>(upstream->allocate(capacity, alignof(std::max_align_t)));
+    }
+}
+
+FrameArena::~FrameArena() {
+    ReleaseOverflow();
+    if (block) {
+        upstream->deallocate(block, capacity, alignof(std::max_align_t));
+    }
+}
+
+void FrameArena::Reset() {
+    if (overflowHead) {
+        // Grow the main block so the next frame fits in one piece
+        std::size_t newCapacity = capacity + overflowBytes;
+        ReleaseOverflow();
+        if (block) {
+            upstream->deallocate(block, capacity, alignof(std::max_align_t));
+        }
+        block = static_cast<std::byte*>(upstream->allocate(newCapacity, alignof(std::max_align_t)));
+        capacity = newCapacity;
+    }
+
+    offset = 0;
+    bytesUsed = 0;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (block) {
+        std::byte* start = AlignUp(block + offset, alignment);
+        std::size_t newOffset = static_cast<std::size_t>(start - block) + bytes;
+        if (newOffset <= capacity) {
+            bytesUsed += newOffset - offset;
+            offset = newOffset;
+            if (bytesUsed > peakBytesUsed) peakBytesUsed = bytesUsed;
+            return start;
+        }
+    }
+
+    return AllocateOverflow(bytes, alignment);
+}
+
+void FrameArena::do_deallocate(void* /*p*/, std::size_t /*bytes*/, std::size_t /*alignment*/) {
+    // Memory is reclaimed wholesale by Reset()
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void* FrameArena::AllocateOverflow(std::size_t bytes, std::size_t alignment) {
+    if (overflowCursor) {
+        std::byte* start = AlignUp(overflowCursor, alignment);
+        if (start + bytes <= overflowEnd) {
+            bytesUsed += static_cast<std::size_t>(start + bytes - overflowCursor);
+            overflowCursor = start + bytes;
+            if (bytesUsed > peakBytesUsed) peakBytesUsed = bytesUsed;
+            return start;
+        }
+    }
+
+    // Start a new overflow block at least as big as the main block
+    std::size_t blockSize = sizeof(OverflowBlock) + bytes + alignment;
+    if (blockSize < capacity) blockSize = capacity;
+
+    auto* header = static_cast<OverflowBlock*>(upstream->allocate(blockSize, alignof(std::max_align_t)));
+    header->next = overflowHead;
+    header->size = blockSize;
+    overflowHead = header;
+    overflowBytes += blockSize;
+    overflowCount++;
+
+    std::byte* base = reinterpret_cast<std::byte*>(header) + sizeof(OverflowBlock);
+    std::byte* start = AlignUp(base, alignment);
+    overflowCursor = start + bytes;
+    overflowEnd = reinterpret_cast<std::byte*>(header) + blockSize;
+
+    bytesUsed += static_cast<std::size_t>(overflowCursor - base);
+    if (bytesUsed > peakBytesUsed) peakBytesUsed = bytesUsed;
+    return start;
+}
+
+void FrameArena::ReleaseOverflow() {
+    while (overflowHead) {
+        OverflowBlock* next = overflowHead->next;
+        upstream->deallocate(overflowHead, overflowHead->size, alignof(std::max_align_t));
+        overflowHead = next;
+    }
+    overflowCursor = nullptr;
+    overflowEnd = nullptr;
+    overflowBytes = 0;
+}
+
+std::size_t FrameArena::GetHeapAllocationCount() {
+    return heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+std::size_t FrameArena::GetHeapFreeCount() {
+    return heapFreeCount.load(std::memory_order_relaxed);
+}
+
+// Global allocation counters. The remaining operator new/delete overloads
+// (arrays, nothrow) forward to these in the standard library. Aligned
+// allocations keep the malloc'd pointer just before the returned address.
+void* operator new(std::size_t size) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* p = std::malloc(size)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    heapFreeCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+    operator delete(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (align < alignof(void*)) align = alignof(void*);
+    while (true) {
+        if (void* raw = std::malloc(size + align + sizeof(void*))) {
+            std::byte* start = AlignUp(static_cast<std::byte*>(raw) + sizeof(void*), align);
+            reinterpret_cast<void**>(start)[-1] = raw;
+            return start;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* p, std::align_val_t /*alignment*/) noexcept {
+    if (!p) return;
+    heapFreeCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(reinterpret_cast<void**>(p)[-1]);
+}
+
+void operator delete(void* p, std::size_t /*size*/, std::align_val_t alignment) noexcept {
+    operator delete(p, alignment);
+}
@@ -1,14 +1,77 @@
 #include "Game.h"
 #include "NetworkManager.h"
 #include "ECS.h"
+#include "FrameArena.h"
+#include "Navigation.h"
+#include "Particles.h"
+#include "Physics.h"
+#include "Prefab.h"
+#include "RenderFrame.h"
+#include "Replay.h"
+#include "SnapshotRing.h"
+#include "Soak.h"
+#include "SpriteAtlas.h"
+#include "TileMap.h"
+#include "WorldSerializer.h"
+#include "ZoneManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <thread>
+
+namespace {
+    // Simulation state outside the registry that rollback must restore
+    struct SimulationState {
+        std::uint64_t rngState;
+        Vector2 cameraOffset;
+    };
+}
+
+// What the main thread hands the simulation each frame
+struct Game::FrameInput {
+    InputFrame input;
+    float deltaTime = 0.0f;
+    Vector2 screenSize = {0.0f, 0.0f};
+    // Main thread timings of the previous frame, shown in the HUD
+    double drawMilliseconds = 0.0;
+    double waitMilliseconds = 0.0;
+};
 
 Game::Game() 
     : running(false)
+    , stopRequested(false)
+    , windowCreated(false)
+    , exitCode(0)
+    , heapAllocationsAtFrameStart(0)
+    , heapAllocationsLastFrame(0)
+    , fixedTimestep(1.0f / 60.0f)
+    , tickAccumulator(0.0f)
+    , tickCount(0)
+    , lastTickMicroseconds(0.0)
+    , lastCompactionBytes(0)
+    , lastCompactionMicroseconds(0.0)
+    , showMemoryOverlay(false)
+    , lastRollbackTicks(0)
+    , lastRollbackMicroseconds(0.0)
+    , lastRollbackMatched(true)
+    , showNetworkOverlay(false)
+    , playerGoal(0)
+    , playerTrailEmitter(0)
+    , waveSparkEmitter(0)
+    , readyFrame(0)
+    , frameInFlight(false)
+    , lastDrawMilliseconds(0.0)
+    , lastWaitMilliseconds(0.0)
+    , lastSimulateMilliseconds(0.0)
+    , simulationPending(false)
+    , simulationStopping(false)
+    , replayFinished(false)
     , playerPosition({400.0f, 300.0f})
     , playerSpeed(200.0f)
     , backgroundColor({25, 25, 35, 255})
-    , playerColor({255, 255, 255, 255}) {
+    , playerColor({255, 255, 255, 255})
+    , assetsPathExists(false) {
 }
 
 Game::~Game() {
@@ -16,19 +79,61 @@ Game::~Game() {
 }
 
 void Game::Initialize(bool isServer, int port, const std::string& host, int width, int height, bool fullscreen) {
-    // Initialize raylib
-    InitWindow(width, height, "Game Engine - Raylib + ENet + EnTT");
+    GameOptions gameOptions;
+    gameOptions.isServer = isServer;
+    gameOptions.port = port;
+    gameOptions.host = host;
+    gameOptions.width = width;
+    gameOptions.height = height;
+    gameOptions.fullscreen = fullscreen;
+    Initialize(gameOptions);
+}
+
+void Game::Initialize(const GameOptions& gameOptions) {
+    options = gameOptions;
     
-    if (fullscreen) {
-        ToggleFullscreen();
+    // Replays run the simulation only, as fast as possible
+    if (!options.replayPath.empty()) {
+        replayPlayer = std::make_unique<ReplayPlayer>();
+        if (!replayPlayer->Open(options.replayPath)) {
+            throw std::runtime_error("Failed to open replay " + options.replayPath);
+        }
+        options.deterministic = true;
+        options.headless = true;
+        options.seed = replayPlayer->GetSeed();
+        options.tickRate = 1.0f / replayPlayer->GetTickSeconds();
+        std::cout << "Replaying " << options.replayPath << " (seed " << options.seed << ")" << std::endl;
+    } else if (!options.recordPath.empty()) {
+        options.deterministic = true;
     }
-    SetTargetFPS(60);
     
-    // Initialize 3D camera
-    InitAudioDevice();
+    // Replays reuse the recorded timestep as is; rebuilding it from the rate can differ in the last bit
+    fixedTimestep = replayPlayer ? replayPlayer->GetTickSeconds() : 1.0f / options.tickRate;
+    random.setSeed(options.seed);
+    
+    // Initialize raylib
+    if (!options.headless) {
+        // Soak runs draw every frame, but nobody needs to watch them
+        if (options.soak) {
+            SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        }
+        InitWindow(options.width, options.height, "Game Engine - Raylib + ENet + EnTT");
+        windowCreated = true;
+        
+        if (options.fullscreen) {
+            ToggleFullscreen();
+        }
+        SetTargetFPS(60);
+        
+        // Initialize 3D camera
+        InitAudioDevice();
+    }
     
-    // Initialize ECS system
+    // Initialize frame arena and ECS system
+    frameArena = std::make_unique<FrameArena>();
     ecsSystem = std::make_unique<ECSSystem>();
+    ecsSystem->setFrameArena(frameArena.get());
+    ecsSystem->setDebugLogging(options.verbose);
     
     // Initialize network manager
     networkManager = std::make_unique<NetworkManager>();
@@ -36,15 +141,22 @@ void Game::Initialize(bool isServer, int port, const std::string& host, int widt
         throw std::runtime_error("Failed to initialize network manager");
     }
     
-    // Start networking based on command line options
-    if(isServer) {
-        std::cout << "Starting server on port " << port << std::endl;
-        if (!networkManager->StartServer(port)) {
+    if (!options.netStatsPath.empty()) {
+        networkManager->GetTelemetry().SetDumpTarget(options.netStatsPath, options.netStatsInterval);
+    }
+    networkManager->SetCompression(options.compression, options.rangeCoder);
+    
+    // Start networking based on command line options (replays feed recorded messages instead)
+    if (replayPlayer) {
+        std::cout << "Replay mode: networking disabled" << std::endl;
+    } else if (options.isServer) {
+        std::cout << "Starting server on port " << options.port << std::endl;
+        if (!networkManager->StartServer(options.port, options.maxClients)) {
             std::cout << "Warning: Could not start server, running in offline mode" << std::endl;
         }
     } else {
-        std::cout << "Connecting to server at " << host << ":" << port << std::endl;
-        if (!networkManager->Connect(host.c_str(), port)) {
+        std::cout << "Connecting to server at " << options.host << ":" << options.port << std::endl;
+        if (!networkManager->ConnectToServer(options.host, options.port)) {
             std::cout << "Warning: Could not connect to server, running in offline mode" << std::endl;
         }
     }
@@ -54,8 +166,12 @@ void Game::Initialize(bool isServer, int port, const std::string& host, int widt
     ecsSystem->addComponent(playerEntity, ECSTransform{{400.0f, 300.0f}});
     ecsSystem->addComponent(playerEntity, Velocity{});
     ecsSystem->addComponent(playerEntity, Model3D{});
-    ecsSystem->addComponent(playerEntity, Player{200.0f, "Player"});
+    ecsSystem->addComponent(playerEntity, Player{200.0f});
+    ecsSystem->addComponent(playerEntity, PlayerName{"Player"});
     ecsSystem->addComponent(playerEntity, Networked{});
+    // Heavier than the demo bodies, so the player shoves them aside
+    ecsSystem->addComponent(playerEntity, Collider{true, 20.0f});
+    ecsSystem->addComponent(playerEntity, RigidBody{0.2f});
     
     // Set the player as the camera target
     ecsSystem->setCameraTarget(playerEntity);
@@ -67,119 +183,624 @@ void Game::Initialize(bool isServer, int port, const std::string& host, int widt
         std::cout << "DEBUG: __EMSCRIPTEN__ is NOT defined!" << std::endl;
     #endif
     
-    // Load the alien model
+    // Load the alien model (needs a GL context, so headless runs use the fallback)
+    bool modelLoaded = false;
     #ifdef __EMSCRIPTEN__
         // In web builds, the path is relative to the preloaded assets root
         std::cout << "EMSCRIPTEN: Loading alien model from: Models/OBJ format/alien.obj" << std::endl;
-        if (!ecsSystem->loadModel3D(playerEntity, "/assets/Models/OBJ format/alien.obj", 50.0f)) {
+        modelLoaded = windowCreated && ecsSystem->loadModel3D(playerEntity, "/assets/Models/OBJ format/alien.obj", 50.0f);
     #else
         // In desktop builds, use the full assets path
         std::cout << "DESKTOP: Loading alien model from: assets/Models/OBJ format/alien.obj" << std::endl;
-        if (!ecsSystem->loadModel3D(playerEntity, "assets/Models/OBJ format/alien.obj", 50.0f)) {
+        modelLoaded = windowCreated && ecsSystem->loadModel3D(playerEntity, "assets/Models/OBJ format/alien.obj", 50.0f);
     #endif
+    if (!modelLoaded) {
         std::cout << "Warning: Could not load alien model, falling back to 2D circle" << std::endl;
         // Fallback to 2D circle if model loading fails
         ecsSystem->removeComponent<Model3D>(playerEntity);
-        ecsSystem->addComponent(playerEntity, Renderable{WHITE, 20.0f, true});
+        ecsSystem->addComponent(playerEntity, Renderable{WHITE});
+        ecsSystem->addComponent(playerEntity, CircleShape{20.0f});
     }
     
     // Create some additional entities for demonstration - place them further out to show camera movement
     auto enemy1 = ecsSystem->createEntity();
     ecsSystem->addComponent(enemy1, ECSTransform{{200.0f, 200.0f}});
     ecsSystem->addComponent(enemy1, Velocity{{50.0f, 0.0f}});
-    ecsSystem->addComponent(enemy1, Renderable{RED, 15.0f, true});
+    ecsSystem->addComponent(enemy1, Renderable{RED});
+    ecsSystem->addComponent(enemy1, CircleShape{15.0f});
+    ecsSystem->addComponent(enemy1, makeCollider(ecsSystem->getComponent<CircleShape>(enemy1)));
+    ecsSystem->addComponent(enemy1, RigidBody{});
+    // Goal 0 follows the player
+    ecsSystem->addComponent(enemy1, NavAgent{0, 50.0f, 15.0f});
     
     auto enemy2 = ecsSystem->createEntity();
     ecsSystem->addComponent(enemy2, ECSTransform{{600.0f, 400.0f}});
     ecsSystem->addComponent(enemy2, Velocity{{-30.0f, 20.0f}});
-    ecsSystem->addComponent(enemy2, Renderable{BLUE, 12.0f, true});
+    ecsSystem->addComponent(enemy2, Renderable{BLUE});
+    ecsSystem->addComponent(enemy2, CircleShape{12.0f});
+    ecsSystem->addComponent(enemy2, makeCollider(ecsSystem->getComponent<CircleShape>(enemy2)));
+    ecsSystem->addComponent(enemy2, RigidBody{});
+    ecsSystem->addComponent(enemy2, NavAgent{0, 40.0f, 12.0f});
     
     // Add some static entities to show the world moving around the player
     auto static1 = ecsSystem->createEntity();
     ecsSystem->addComponent(static1, ECSTransform{{100.0f, 100.0f}});
-    ecsSystem->addComponent(static1, Renderable{GREEN, 25.0f, true});
+    ecsSystem->addComponent(static1, Renderable{GREEN});
+    ecsSystem->addComponent(static1, CircleShape{25.0f});
+    ecsSystem->addComponent(static1, makeCollider(ecsSystem->getComponent<CircleShape>(static1)));
     
     auto static2 = ecsSystem->createEntity();
     ecsSystem->addComponent(static2, ECSTransform{{700.0f, 500.0f}});
-    ecsSystem->addComponent(static2, Renderable{ORANGE, 30.0f, true});
+    ecsSystem->addComponent(static2, Renderable{ORANGE});
+    ecsSystem->addComponent(static2, CircleShape{30.0f});
+    ecsSystem->addComponent(static2, makeCollider(ecsSystem->getComponent<CircleShape>(static2)));
     
     auto static3 = ecsSystem->createEntity();
     ecsSystem->addComponent(static3, ECSTransform{{100.0f, 500.0f}});
-    ecsSystem->addComponent(static3, Renderable{PURPLE, 18.0f, true});
+    ecsSystem->addComponent(static3, Renderable{PURPLE});
+    ecsSystem->addComponent(static3, CircleShape{18.0f});
+    ecsSystem->addComponent(static3, makeCollider(ecsSystem->getComponent<CircleShape>(static3)));
     
     auto static4 = ecsSystem->createEntity();
     ecsSystem->addComponent(static4, ECSTransform{{700.0f, 100.0f}});
-    ecsSystem->addComponent(static4, Renderable{YELLOW, 22.0f, true});
+    ecsSystem->addComponent(static4, Renderable{YELLOW});
+    ecsSystem->addComponent(static4, CircleShape{22.0f});
+    ecsSystem->addComponent(static4, makeCollider(ecsSystem->getComponent<CircleShape>(static4)));
+    
+    // Archetypes for the bulk-spawned demo entities
+    prefabLibrary = std::make_unique<PrefabLibrary>();
+    prefabLibrary->define("decoration")
+        .with(ECSTransform{})
+        .with(Renderable{})
+        .with(CircleShape{});
+    prefabLibrary->define("mover")
+        .with(ECSTransform{})
+        .with(Velocity{})
+        .with(Renderable{WHITE})
+        .with(CircleShape{12.0f})
+        .with(Collider{true, 12.0f})
+        .with(RigidBody{})
+        .with(NavAgent{0, 40.0f, 12.0f});
+    
+    // Data-defined prefabs (spawn waves etc.), optional
+    #ifdef __EMSCRIPTEN__
+        const char* prefabPath = "/assets/prefabs.ini";
+    #else
+        const char* prefabPath = "assets/prefabs.ini";
+    #endif
+    if (boost::filesystem::exists(prefabPath)) {
+        prefabLibrary->loadFromFile(prefabPath);
+    }
+    
+    std::vector<entt::entity> spawned;
     
     // Add more entities in a larger area to demonstrate camera movement
+    ecsSystem->spawnPrefab(*prefabLibrary->find("decoration"), 10, spawned);
     for (int i = 0; i < 10; i++) {
-        auto entity = ecsSystem->createEntity();
         float x = 100.0f + (i * 150.0f);
         float y = 50.0f + ((i % 3) * 200.0f);
         Color colors[] = {RED, BLUE, GREEN, YELLOW, ORANGE, PURPLE, PINK, LIME, SKYBLUE, GOLD};
-        ecsSystem->addComponent(entity, ECSTransform{{x, y}});
-        ecsSystem->addComponent(entity, Renderable{colors[i % 10], 15.0f + (i * 2.0f), true});
+        ecsSystem->getComponent<ECSTransform>(spawned[i]).position = {x, y};
+        ecsSystem->getComponent<Renderable>(spawned[i]).color = colors[i % 10];
+        auto& circle = ecsSystem->getComponent<CircleShape>(spawned[i]);
+        circle.radius = 15.0f + (i * 2.0f);
+        // Static obstacles: a collider without a RigidBody never moves
+        ecsSystem->addComponent(spawned[i], makeCollider(circle));
     }
     
     // Add some entities that move in patterns to show dynamic world
+    spawned.clear();
+    ecsSystem->spawnPrefab(*prefabLibrary->find("mover"), 5, spawned);
     for (int i = 0; i < 5; i++) {
-        auto movingEntity = ecsSystem->createEntity();
         float x = 200.0f + (i * 120.0f);
         float y = 300.0f + (i * 50.0f);
-        ecsSystem->addComponent(movingEntity, ECSTransform{{x, y}});
-        ecsSystem->addComponent(movingEntity, Velocity{{30.0f + (i * 10.0f), -20.0f + (i * 5.0f)}});
-        Color movingColor = {255, (unsigned char)(100 + i * 30), (unsigned char)(100 + i * 20), 255};
-        ecsSystem->addComponent(movingEntity, Renderable{movingColor, 12.0f, true});
+        ecsSystem->getComponent<ECSTransform>(spawned[i]).position = {x, y};
+        ecsSystem->getComponent<Velocity>(spawned[i]).linear = {30.0f + (i * 10.0f), -20.0f + (i * 5.0f)};
+        ecsSystem->getComponent<NavAgent>(spawned[i]).speed = 30.0f + (i * 10.0f);
+        ecsSystem->getComponent<Renderable>(spawned[i]).color = {255, (unsigned char)(100 + i * 30), (unsigned char)(100 + i * 20), 255};
+    }
+    
+    worldSerializer = std::make_unique<WorldSerializer>();
+    ecsSystem->registerWorldComponents(*worldSerializer);
+    if (options.loadWorld && !LoadWorld(options.worldPath)) {
+        std::cout << "Warning: Could not load world " << options.worldPath << ", using the default world" << std::endl;
+    }
+    
+    // Hand the world to the zones; the local player and camera stay behind
+    if (options.zones > 1) {
+        if (!options.isServer || options.deterministic) {
+            std::cout << "Warning: zones need server mode and are not deterministic, using a single registry" << std::endl;
+        } else {
+            ZoneConfig zoneConfig;
+            zoneConfig.zoneCount = static_cast<std::size_t>(options.zones);
+            zoneConfig.zoneWidth = options.zoneWidth;
+            zoneConfig.physics = options.physics;
+            zoneManager = std::make_unique<ZoneManager>(zoneConfig);
+            std::size_t adopted = zoneManager->adoptEntities(*ecsSystem, playerEntity);
+            std::cout << "Distributed " << adopted << " entities over " << zoneManager->getZoneCount() << " zones" << std::endl;
+        }
+    }
+    
+    if (options.physics) {
+        PhysicsConfig physicsConfig;
+        physicsConfig.threadCount = static_cast<std::size_t>(options.physicsThreads);
+        physicsWorld = std::make_unique<PhysicsWorld>(physicsConfig);
+        std::cout << "Physics narrowphase on " << physicsWorld->getStats().threads << " threads" << std::endl;
+    }
+    
+    // Agents handed to zones keep their NavAgent but are not steered there
+    if (options.navigation && !zoneManager) {
+        NavigationConfig navigationConfig;
+        navigationConfig.threadCount = static_cast<std::size_t>(options.navigationThreads);
+        // Whole builds keep every field a function of the current state, which rollback relies on
+        if (options.deterministic) {
+            navigationConfig.buildBudget = 0;
+        }
+        navigationSystem = std::make_unique<NavigationSystem>(navigationConfig);
+        playerGoal = navigationSystem->addGoal(playerPosition);
+        navigationSystem->setGoalTarget(playerGoal, playerEntity);
+        std::cout << "Navigation on " << navigationSystem->getStats().threads << " threads" << std::endl;
+    }
+    
+    // Sprites are render-only; the zones draw their own entities, so they are skipped there
+    if (windowCreated && !options.deterministic && !zoneManager) {
+        InitializeSprites();
+        if (spriteAtlas) {
+            InitializeTileMap();
+        }
+    }
+    
+    // Particles are visual only, so they run in every mode that draws
+    if (windowCreated && options.particles) {
+        InitializeParticles();
+    }
+    
+    // Rollback keeps one snapshot per tick for the last rollbackWindow ticks
+    if (options.rollbackWindow > 0) {
+        if (!options.deterministic) {
+            std::cout << "Warning: rollback requires deterministic mode, disabling it" << std::endl;
+        } else {
+            snapshots = std::make_unique<SnapshotRing>(options.rollbackWindow + 1);
+            ecsSystem->registerSnapshotComponents(*snapshots);
+            inputHistory.resize(options.rollbackWindow + 1);
+        }
+    }
+    
+    if (!options.recordPath.empty()) {
+        replayRecorder = std::make_unique<ReplayRecorder>();
+        if (!replayRecorder->Open(options.recordPath, options.seed, fixedTimestep)) {
+            replayRecorder.reset();
+        }
+    }
+    
+    // Frames are recorded by the simulation and drawn afterwards; with the
+    // render thread the two overlap, each working on its own RenderFrame
+    if (windowCreated) {
+        renderFrames[0] = std::make_unique<RenderFrame>();
+        renderFrames[1] = std::make_unique<RenderFrame>();
+        #ifndef __EMSCRIPTEN__
+            if (options.renderThread) {
+                pendingFrame = std::make_unique<FrameInput>();
+                simulationThread = boost::thread([this]() { SimulationLoop(); });
+                std::cout << "Simulating on a separate thread while the main thread draws" << std::endl;
+            }
+        #endif
     }
     
     running = true;
+    lastFrameTime = std::chrono::steady_clock::now();
+    replayStartTime = lastFrameTime;
+    lastCompactionCheck = lastFrameTime;
     
     // Initialize Boost features
     InitializeBoostFeatures();
     
+    // Last, so the soak scenario starts from the finished demo world
+    if (options.soak) {
+        SoakConfig soakConfig;
+        soakConfig.durationSeconds = options.soakDuration;
+        soakConfig.sampleSeconds = options.soakInterval;
+        soakConfig.reportPath = options.soakReportPath;
+        soakConfig.port = options.port;
+        soakConfig.compression = options.compression;
+        soakConfig.botCount = static_cast<std::size_t>(std::min(8, options.maxClients));
+        // Models need the GL context, so headless soaks skip them
+        if (windowCreated) {
+            for (const char* name : {"barrel", "astronautA", "chimney", "bones"}) {
+                soakConfig.modelPaths.push_back(std::string("assets/Models/OBJ format/") + name + ".obj");
+            }
+        }
+        soakTest = std::make_unique<SoakTest>(soakConfig);
+    }
+    
     std::cout << "Game initialized successfully with ECS, camera system, and Boost libraries!" << std::endl;
 }
 
 void Game::Update() {
+    if (stopRequested) {
+        running = false;
+    }
     if (!running) return;
     
-    float deltaTime = GetFrameTime();
+    // The world belongs to this thread again until the next frame is posted
+    FinishSimulation();
     
-    // Update network
-    if (networkManager) {
+    if (replayFinished) {
+        FinishReplay();
+        return;
+    }
+    
+    // Heap allocations made during the previous frame (update + render)
+    std::size_t heapAllocations = FrameArena::GetHeapAllocationCount();
+    heapAllocationsLastFrame = heapAllocations - heapAllocationsAtFrameStart;
+    heapAllocationsAtFrameStart = heapAllocations;
+    
+    // Input and anything that needs the GL context run here, between frames
+    if (snapshots && windowCreated && IsKeyPressed(KEY_F6)) {
+        DebugRollback();
+    }
+    
+    if (zoneManager && windowCreated) {
+        zoneManager->loadPendingModels();
+    }
+    
+    if (windowCreated && IsKeyPressed(KEY_F3)) {
+        showNetworkOverlay = !showNetworkOverlay;
+    }
+    if (windowCreated && IsKeyPressed(KEY_F4)) {
+        showMemoryOverlay = !showMemoryOverlay;
+    }
+    
+    if (tileMap) {
+        EditTileMap();
+    }
+    
+    bool worldReplaced = false;
+    if (windowCreated && (IsKeyPressed(KEY_F5) || IsKeyPressed(KEY_F9)) && zoneManager) {
+        // World files hold a single registry
+        std::cout << "World save/load is not available with zones" << std::endl;
+    } else if (windowCreated && IsKeyPressed(KEY_F5)) {
+        SaveWorld(options.worldPath);
+    } else if (windowCreated && IsKeyPressed(KEY_F9)) {
+        if (replayRecorder) {
+            // A recording only captures inputs, so it cannot reproduce a load
+            std::cout << "World loading is disabled while recording a replay" << std::endl;
+        } else {
+            LoadWorld(options.worldPath);
+            worldReplaced = true;
+        }
+    }
+    
+    // Soak scenario steps create and destroy entities and models, so they run
+    // here, where the world and the GL context are free
+    if (soakTest) {
+        soakTest->AddFrameTime(lastSimulateMilliseconds + lastDrawMilliseconds);
+        worldReplaced = soakTest->Step(*ecsSystem, prefabLibrary ? prefabLibrary->find("swarm") : nullptr) || worldReplaced;
+        if (soakTest->IsFinished()) {
+            if (!soakTest->Finish(*ecsSystem)) {
+                exitCode = 1;
+            }
+            soakTest.reset();
+            // The last recorded frame may still refer to released models;
+            // headless runs record no frames
+            if (renderFrames[readyFrame]) {
+                renderFrames[readyFrame]->clear();
+            }
+            running = false;
+            return;
+        }
+    }
+    
+    // Check for window close
+    if (windowCreated && WindowShouldClose()) {
+        running = false;
+        return;
+    }
+    
+    FrameInput frame;
+    if (!replayPlayer) {
+        frame.input = SampleInput();
+        frame.deltaTime = GetFrameDelta();
+    }
+    if (windowCreated) {
+        frame.screenSize = {static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())};
+    }
+    frame.drawMilliseconds = lastDrawMilliseconds;
+    frame.waitMilliseconds = lastWaitMilliseconds;
+    
+    if (!simulationThread.joinable()) {
+        SimulateFrame(frame, renderFrames[readyFrame].get());
+        return;
+    }
+    
+    // The frame about to be drawn still holds the old world's models
+    if (worldReplaced) {
+        BuildRenderFrame(*renderFrames[readyFrame], frame);
+    }
+    
+    {
+        boost::lock_guard<boost::mutex> lock(simulationMutex);
+        *pendingFrame = frame;
+        simulationPending = true;
+    }
+    frameInFlight = true;
+    simulationWake.notify_one();
+}
+
+void Game::SimulateFrame(const FrameInput& frame, RenderFrame* target) {
+    auto simulateStart = std::chrono::steady_clock::now();
+    
+    if (replayPlayer) {
+        // One recorded tick per call, no pacing
+        if (!Tick(fixedTimestep, InputFrame{})) {
+            // Verified at the start of the next Update, with the other ways a run ends
+            replayFinished = true;
+        }
+    } else if (options.deterministic) {
+        // Fixed ticks; input is sampled once per frame and one-shot buttons
+        // only apply to the first tick
+        InputFrame input = frame.input;
+        tickAccumulator += frame.deltaTime;
+        
+        // Avoid a spiral of death after a long stall
+        const float maxAccumulated = fixedTimestep * 8.0f;
+        if (tickAccumulator > maxAccumulated) {
+            tickAccumulator = maxAccumulated;
+        }
+        
+        while (tickAccumulator >= fixedTimestep) {
+            Tick(fixedTimestep, input);
+            input.buttons &= ~InputFrame::SpawnWave;
+            tickAccumulator -= fixedTimestep;
+        }
+    } else {
+        Tick(frame.deltaTime, frame.input);
+    }
+    
+    // Effects run on frame time outside the ticks, so rollback never replays them
+    if (particleSystem) {
+        if (frame.input.isDown(InputFrame::SpawnWave)) {
+            particleSystem->burst(waveSparkEmitter, 2000);
+        }
+        particleSystem->update(ecsSystem->getRegistry(), frame.deltaTime);
+    }
+    
+    CompactStorageIfIdle();
+    
+    // Update Boost features
+    UpdateBoostFeatures();
+    
+    lastSimulateMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - simulateStart).count();
+    if (target) {
+        BuildRenderFrame(*target, frame);
+    }
+    
+    // Everything allocated from the arena this frame is released here
+    if (frameArena) {
+        frameArena->Reset();
+    }
+}
+
+void Game::SimulationLoop() {
+    for (;;) {
+        {
+            boost::unique_lock<boost::mutex> lock(simulationMutex);
+            simulationWake.wait(lock, [this]() { return simulationStopping || simulationPending; });
+            if (simulationStopping) return;
+        }
+        
+        // The main thread only reads readyFrame and pendingFrame while this is idle
+        SimulateFrame(*pendingFrame, renderFrames[1 - readyFrame].get());
+        
+        {
+            boost::lock_guard<boost::mutex> lock(simulationMutex);
+            simulationPending = false;
+        }
+        simulationDone.notify_one();
+    }
+}
+
+void Game::FinishSimulation() {
+    if (!frameInFlight) return;
+    
+    auto waitStart = std::chrono::steady_clock::now();
+    {
+        boost::unique_lock<boost::mutex> lock(simulationMutex);
+        simulationDone.wait(lock, [this]() { return !simulationPending; });
+    }
+    lastWaitMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    
+    readyFrame = 1 - readyFrame;
+    frameInFlight = false;
+}
+
+void Game::StopSimulationThread() {
+    if (!simulationThread.joinable()) return;
+    
+    FinishSimulation();
+    {
+        boost::lock_guard<boost::mutex> lock(simulationMutex);
+        simulationStopping = true;
+    }
+    simulationWake.notify_one();
+    simulationThread.join();
+}
+
+bool Game::Tick(float deltaTime, InputFrame input) {
+    auto tickStart = std::chrono::steady_clock::now();
+    
+    // Systems run in a fixed order so a tick only depends on the previous
+    // state, the input and the received messages
+    std::pmr::vector<NetworkMessage> messages(frameArena.get());
+    
+    if (replayPlayer) {
+        // Input and messages come from the recording
+        if (!replayPlayer->ReadTick(input, messages)) {
+            return false;
+        }
+    } else if (networkManager) {
+        // Update network
         networkManager->Update();
+        messages = networkManager->GetMessages(frameArena.get());
+    }
+    
+    if (replayRecorder) {
+        replayRecorder->RecordTick(input, messages);
+    }
+    
+    // Keep the state this tick starts from, and its input, for rollback
+    if (snapshots) {
+        SaveSnapshot(tickCount);
+        inputHistory[tickCount % inputHistory.size()] = input;
     }
     
+    Simulate(deltaTime, input);
+    
+    // Update game logic
+    UpdatePlayer(messages);
+    
+    // Zones simulate in parallel, then hand off entities and serve their clients
+    if (zoneManager) {
+        zoneManager->step(deltaTime);
+        if (networkManager) {
+            zoneManager->sendUpdates(*networkManager);
+        }
+    }
+    
+    // Everything queued this tick goes out packed, one set of packets per peer
+    if (networkManager) {
+        networkManager->Flush();
+    }
+    
+    tickCount++;
+    lastTickMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tickStart).count();
+    return true;
+}
+
+void Game::Simulate(float deltaTime, const InputFrame& input) {
     // Handle input
-    HandleInput();
+    HandleInput(input);
     
     // Update ECS systems
     if (ecsSystem) {
+        if (navigationSystem) {
+            navigationSystem->update(ecsSystem->getRegistry(), deltaTime);
+        }
         ecsSystem->updateMovement(deltaTime);
+        if (physicsWorld) {
+            physicsWorld->step(ecsSystem->getRegistry(), deltaTime);
+        }
         ecsSystem->updateCamera(deltaTime);  // Update camera to follow player
         ecsSystem->updateNetworkSync();
     }
+}
+
+void Game::SaveSnapshot(std::uint64_t tick) {
+    SimulationState state;
+    state.rngState = random.getState();
+    state.cameraOffset = ecsSystem->getCameraOffset();
+    snapshots->save(ecsSystem->getRegistry(), tick, state);
+}
+
+bool Game::Rollback(std::uint32_t ticks) {
+    if (!snapshots || ticks == 0 || ticks > tickCount || ticks >= snapshots->getSlotCount()) {
+        return false;
+    }
     
-    // Update game logic
-    UpdatePlayer();
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t targetTick = tickCount - ticks;
     
-    // Update Boost features
-    UpdateBoostFeatures();
+    SimulationState state;
+    if (!snapshots->restore(ecsSystem->getRegistry(), targetTick, state)) {
+        return false;
+    }
+    random.setState(state.rngState);
+    ecsSystem->setCameraOffset(state.cameraOffset);
     
-    // Check for window close
-    if (WindowShouldClose()) {
-        running = false;
+    // Re-simulate with the stored inputs, refreshing the snapshots on the way
+    // so a later rollback starts from the corrected timeline
+    for (std::uint64_t tick = targetTick; tick < tickCount; tick++) {
+        if (tick != targetTick) {
+            SaveSnapshot(tick);
+        }
+        Simulate(fixedTimestep, inputHistory[tick % inputHistory.size()]);
+    }
+    
+    lastRollbackTicks = ticks;
+    lastRollbackMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void Game::DebugRollback() {
+    // Rolling back and re-simulating unchanged inputs must land on the same state
+    std::uint32_t ticks = std::min<std::uint32_t>(8, static_cast<std::uint32_t>(snapshots->getSlotCount() - 1));
+    std::uint64_t before = ecsSystem->computeStateHash();
+    if (!Rollback(ticks)) {
+        std::cout << "Rollback of " << ticks << " ticks not possible yet" << std::endl;
+        return;
+    }
+    std::uint64_t after = ecsSystem->computeStateHash();
+    lastRollbackMatched = (before == after);
+    
+    std::cout << "Rolled back and re-simulated " << ticks << " ticks in " << lastRollbackMicroseconds << " us ("
+              << "restore " << snapshots->getLastRestoreMicroseconds() << " us), state "
+              << (lastRollbackMatched ? "matches" : "DIVERGED") << std::endl;
+}
+
+float Game::GetFrameDelta() {
+    auto now = std::chrono::steady_clock::now();
+    float elapsed = std::chrono::duration<float>(now - lastFrameTime).count();
+    
+    if (windowCreated) {
+        lastFrameTime = now;
+        return GetFrameTime();
+    }
+    
+    // Headless: pace to the tick rate instead of spinning
+    if (elapsed < fixedTimestep) {
+        std::this_thread::sleep_for(std::chrono::duration<float>(fixedTimestep - elapsed));
+        now = std::chrono::steady_clock::now();
+        elapsed = std::chrono::duration<float>(now - lastFrameTime).count();
+    }
+    lastFrameTime = now;
+    return elapsed;
+}
+
+void Game::FinishReplay() {
+    running = false;
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStartTime).count();
+    double simulated = tickCount * static_cast<double>(fixedTimestep);
+    std::uint64_t stateHash = ecsSystem ? ecsSystem->computeStateHash() : 0;
+    
+    std::cout << "Replay finished: " << tickCount << " ticks (" << simulated << " s simulated) in "
+              << seconds << " s, " << (seconds > 0.0 ? simulated / seconds : 0.0) << "x real time" << std::endl;
+    
+    if (!replayPlayer->HasFooter()) {
+        std::cout << "Replay has no footer, cannot verify final state" << std::endl;
+        exitCode = 2;
+    } else if (replayPlayer->GetRecordedTicks() != tickCount || replayPlayer->GetFinalStateHash() != stateHash) {
+        std::cout << "Replay DIVERGED: recorded " << replayPlayer->GetRecordedTicks() << " ticks, state hash "
+                  << std::hex << replayPlayer->GetFinalStateHash() << ", replayed hash " << stateHash
+                  << std::dec << std::endl;
+        exitCode = 1;
+    } else {
+        std::cout << "Replay matched recording (state hash " << std::hex << stateHash << std::dec << ")" << std::endl;
     }
 }
 
 void Game::Render() {
+    if (!windowCreated) return;
+    
+    auto drawStart = std::chrono::steady_clock::now();
+    const RenderFrame& frame = *renderFrames[readyFrame];
+    
     BeginDrawing();
     
     ClearBackground(backgroundColor);
     
     // Set up 3D camera for the scene - fixed position since entities are moved by ECS
     Camera3D camera = { 0 };
-    Vector2 cameraOffset = ecsSystem->getCameraOffset();
     
     // 3D camera stays fixed - entities are moved by the ECS camera system
     //camera.position = { 400.0f, 200.0f, 200.0f };
@@ -188,29 +809,31 @@ void Game::Render() {
     camera.fovy = 45.0f;
     camera.projection = CAMERA_PERSPECTIVE;
     
+    // Static terrain first; chunk textures are built with texture mode, which cannot run inside 3D mode
+    if (tileMap) {
+        tileMap->render(frame.cameraOffset);
+    }
+    
     BeginMode3D(camera);
     
     // Draw a simple ground plane for reference - fixed position
     DrawPlane({ 400.0f, 300.0f, 0.0f }, { 800.0f, 600.0f }, LIGHTGRAY);
     
-    // Render all entities using ECS
-    if (ecsSystem) {
-        ecsSystem->updateRendering();
-    }
+    // Entities recorded by the simulation
+    frame.drawScene();
     
     EndMode3D();
     
-    // Draw UI
-    DrawText("Game Engine - Raylib + ENet + EnTT", 10, 10, 20, WHITE);
-    
-    // Get player position from ECS
-    if (ecsSystem && ecsSystem->hasComponent<ECSTransform>(playerEntity)) {
-        auto& transform = ecsSystem->getComponent<ECSTransform>(playerEntity);
-        DrawText(TextFormat("Player Position: (%.1f, %.1f)", transform.position.x, transform.position.y), 10, 40, 16, WHITE);
+    // Atlas sprites in screen space, over the scene and under the UI
+    if (spriteAtlas) {
+        frame.drawSprites(*spriteAtlas);
     }
     
-    // Camera info
-    DrawText(TextFormat("Camera Offset: (%.1f, %.1f)", cameraOffset.x, cameraOffset.y), 10, 60, 16, WHITE);
+    // Particles over the sprites, one quad batch per material
+    frame.drawParticles();
+    
+    // HUD and overlays
+    frame.drawOverlay();
     
     // Draw a crosshair in the center to show the player is centered
     int centerX = GetScreenWidth() / 2;
@@ -219,48 +842,420 @@ void Game::Render() {
     DrawLine(centerX, centerY - 20, centerX, centerY + 20, WHITE);
     DrawCircle(centerX, centerY, 5, WHITE);
     
+    // Tilemap info; the tile map is drawn and edited on this thread
+    if (tileMap) {
+        const TileMap::Stats& tileStats = tileMap->getStats();
+        DrawText(TextFormat("Tiles: %zu in %zu chunks, %zu visible, %zu cached (%zu KB), %zu rebuilt in %.0f us",
+                            tileStats.tiles, tileStats.chunks, tileStats.visibleChunks, tileStats.residentTextures,
+                            tileStats.textureBytes / 1024, tileStats.rebuilds, tileStats.rebuildMicroseconds),
+                 10, 370, 14, WHITE);
+    }
+    
+    // Submission time only; EndDrawing also waits for the target frame rate
+    lastDrawMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - drawStart).count();
+    
+    EndDrawing();
+}
+
+void Game::BuildRenderFrame(RenderFrame& frame, const FrameInput& input) {
+    frame.clear();
+    frame.screenSize = input.screenSize;
+    frame.cameraOffset = ecsSystem->getCameraOffset();
+    Vector2 cameraOffset = frame.cameraOffset;
+    
+    // Scene and sprites
+    ecsSystem->buildRenderCommands(frame);
+    if (zoneManager) {
+        zoneManager->buildRenderCommands(frame);
+    }
+    ecsSystem->buildSpriteCommands(frame);
+    if (particleSystem) {
+        particleSystem->buildRenderCommands(frame);
+    }
+    
+    // Draw UI
+    frame.text(10, 10, 20, WHITE, "Game Engine - Raylib + ENet + EnTT");
+    
+    // Get player position from ECS
+    if (ecsSystem->hasComponent<ECSTransform>(playerEntity)) {
+        auto& transform = ecsSystem->getComponent<ECSTransform>(playerEntity);
+        frame.text(10, 40, 16, WHITE, "Player Position: (%.1f, %.1f)", transform.position.x, transform.position.y);
+    }
+    
+    // Camera info
+    frame.text(10, 60, 16, WHITE, "Camera Offset: (%.1f, %.1f)", cameraOffset.x, cameraOffset.y);
+    
     // Instructions
-    DrawText("WASD or Arrow Keys to move", 10, 150, 16, GRAY);
-    DrawText("Player stays centered - world moves around you", 10, 170, 16, GRAY);
+    frame.text(10, 150, 16, GRAY, "WASD or Arrow Keys to move");
+    frame.text(10, 170, 16, GRAY, "Player stays centered - world moves around you");
     
     // Network status
     if (networkManager) {
         if (networkManager->IsServer()) {
-            DrawText("Server Mode", 10, 200, 16, GREEN);
+            frame.text(10, 200, 16, GREEN, "Server Mode");
         } else if (networkManager->IsConnected()) {
-            DrawText("Client Mode - Connected", 10, 200, 16, GREEN);
+            frame.text(10, 200, 16, GREEN, "Client Mode - Connected");
         } else {
-            DrawText("Offline Mode", 10, 200, 16, YELLOW);
+            frame.text(10, 200, 16, YELLOW, "Offline Mode");
         }
     }
     
     // ECS info
-    if (ecsSystem) {
-        auto entityCount = ecsSystem->getRegistry().storage<entt::entity>().size();
-        DrawText(TextFormat("Entities: %zu", entityCount), 10, 230, 16, WHITE);
+    auto entityCount = ecsSystem->getRegistry().storage<entt::entity>().size();
+    frame.text(10, 230, 16, WHITE, "Entities: %zu", entityCount);
+    
+    // Zone info
+    if (zoneManager) {
+        const ZoneManager::Stats& zoneStats = zoneManager->getStats();
+        std::size_t zoneEntities = 0;
+        for (std::size_t i = 0; i < zoneManager->getZoneCount(); i++) {
+            zoneEntities += zoneManager->getEntityCount(i);
+        }
+        frame.text(10, 330, 14, WHITE, "Zones: %zu  entities %zu  players %zu  step %.0f us (slowest zone %.0f, handoff %.0f)  "
+                   "migrations %zu  ghosts %zu",
+                   zoneManager->getZoneCount(), zoneEntities, zoneManager->getPlayerCount(),
+                   zoneStats.parallelMicroseconds, zoneStats.slowestZoneMicroseconds, zoneStats.serialMicroseconds,
+                   zoneStats.migrations, zoneStats.ghosts);
+    }
+    
+    // Sprite batching info
+    if (spriteAtlas && spriteAtlas->hasTextures()) {
+        const ECSSystem::SpriteStats& spriteStats = ecsSystem->getSpriteStats();
+        frame.text(10, 350, 14, WHITE, "Sprites: %zu drawn, %zu culled in %zu batches (%zu regions on %zu pages)",
+                   spriteStats.drawn, spriteStats.culled, spriteStats.batches,
+                   spriteAtlas->getRegionCount(), spriteAtlas->getPageCount());
+    }
+    
+    // Physics info
+    if (physicsWorld) {
+        const PhysicsWorld::Stats& physicsStats = physicsWorld->getStats();
+        frame.text(10, 390, 14, WHITE, "Physics: %zu bodies (%zu awake, %zu asleep), %zu pairs, %zu contacts, %zu islands, "
+                   "%.0f us (broad %.0f, narrow %.0f, solve %.0f) on %zu threads",
+                   physicsStats.bodies, physicsStats.awake, physicsStats.sleeping, physicsStats.pairs,
+                   physicsStats.contacts, physicsStats.islands, physicsStats.totalMicroseconds,
+                   physicsStats.broadphaseMicroseconds, physicsStats.narrowphaseMicroseconds,
+                   physicsStats.solveMicroseconds, physicsStats.threads);
+    }
+    
+    // Navigation info
+    if (navigationSystem) {
+        const NavigationSystem::Stats& navigationStats = navigationSystem->getStats();
+        frame.text(10, 430, 14, WHITE, "Navigation: %zu agents, %zu goals (%zu building, %zu cells expanded), %zu fields built, "
+                   "%zu avoidance pairs, build %.0f us, steer %.0f us on %zu threads",
+                   navigationStats.agents, navigationStats.goals, navigationStats.building, navigationStats.cellsExpanded,
+                   navigationStats.fieldsBuilt, navigationStats.avoidancePairs, navigationStats.buildMicroseconds,
+                   navigationStats.steerMicroseconds, navigationStats.threads);
+    }
+    
+    // Particle info; drawn and record time cover this frame's recording
+    if (particleSystem) {
+        const ParticleSystem::Stats& particleStats = particleSystem->getStats();
+        frame.text(10, 450, 14, WHITE, "Particles: %zu / %zu alive in %zu emitters, %zu drawn in %zu batches, "
+                   "update %.0f us (%s), record %.0f us, %zu dropped",
+                   particleStats.alive, particleStats.capacity, particleStats.emitters, particleStats.drawn,
+                   particleStats.batches, particleStats.updateMicroseconds, ParticleSystem::usesSimd() ? "SSE2" : "scalar",
+                   particleStats.recordMicroseconds, particleStats.dropped);
+    }
+    
+    // Frame pipeline info; draw and wait times are the main thread's from the previous frame
+    frame.text(10, 410, 14, WHITE, "Frame: simulate %.2f ms, draw %.2f ms, waited %.2f ms (%s)",
+               lastSimulateMilliseconds, input.drawMilliseconds, input.waitMilliseconds,
+               simulationThread.joinable() ? "render thread" : "serial");
+    
+    // Frame memory info
+    if (frameArena) {
+        frame.text(10, 290, 14, WHITE, "Heap allocs/frame: %zu  Arena: %zu KB peak / %zu KB", heapAllocationsLastFrame,
+                   frameArena->GetPeakBytesUsed() / 1024, frameArena->GetCapacity() / 1024);
+    }
+    
+    // Rollback info
+    if (snapshots) {
+        frame.text(10, 310, 14, lastRollbackMatched ? WHITE : RED, "Snapshot: %zu KB in %.1f us  Last rollback: %u ticks in %.1f us%s (F6)",
+                   snapshots->getLastSnapshotBytes() / 1024, snapshots->getLastSaveMicroseconds(),
+                   lastRollbackTicks, lastRollbackMicroseconds, lastRollbackMatched ? "" : " DIVERGED");
     }
     
     // Boost info
-    DrawText("Boost Libraries: Filesystem, Thread, Chrono, Regex, Date/Time", 10, 250, 14, SKYBLUE);
-    if (boost::filesystem::exists(assetsPath)) {
-        DrawText(TextFormat("Assets Path: %s", assetsPath.string().c_str()), 10, 270, 12, GRAY);
+    frame.text(10, 250, 14, SKYBLUE, "Boost Libraries: Filesystem, Thread, Chrono, Regex, Date/Time");
+    if (assetsPathExists) {
+        frame.text(10, 270, 12, GRAY, "Assets Path: %s", assetsPathText.c_str());
     }
     
-    DrawText("Press ESC to exit", 10, 570, 16, GRAY);
+    frame.text(10, 570, 16, GRAY, "Press ESC to exit");
     
-    EndDrawing();
+    if (showNetworkOverlay) {
+        RecordNetworkOverlay(frame);
+    }
+    if (showMemoryOverlay) {
+        RecordMemoryOverlay(frame);
+    }
+}
+
+void Game::RecordNetworkOverlay(RenderFrame& frame) {
+    const NetworkTelemetry& telemetry = networkManager->GetTelemetry();
+    int x = static_cast<int>(frame.screenSize.x) - 430;
+    int y = 10;
+    frame.panel({static_cast<float>(x - 10), static_cast<float>(y - 5), 430.0f, 340.0f}, Fade(BLACK, 0.7f));
+    
+    const RollingHistogram& rtt = telemetry.GetRttHistogram();
+    frame.text(x, y, 12, WHITE, "Network (F3)  peers: %zu  RTT p50 %.0f / p99 %.0f / max %.0f ms", telemetry.GetConnectedPeerCount(),
+               rtt.GetPercentile(0.5), rtt.GetPercentile(0.99), rtt.GetMax());
+    y += 14;
+    std::uint64_t packets = telemetry.GetPacketsSent();
+    frame.text(x, y, 12, WHITE, "Packets sent: %llu  (%.1f messages/packet)", static_cast<unsigned long long>(packets),
+               packets > 0 ? static_cast<double>(telemetry.GetMessagesSent()) / packets : 0.0);
+    y += 18;
+    
+    // Bandwidth by message type
+    frame.text(x, y, 12, GRAY, "type        sent/s     recv/s     sent total");
+    y += 14;
+    for (const auto& type : telemetry.GetMessageTypes()) {
+        if (y > 150) break;
+        frame.text(x, y, 12, WHITE, "%-10s %7.1f KB %7.1f KB %9.1f KB", type.type.c_str(), type.sendBytesPerSecond / 1024.0,
+                   type.receiveBytesPerSecond / 1024.0, type.sentBytes / 1024.0);
+        y += 14;
+    }
+    
+    // Worst connections first
+    y = 170;
+    frame.text(x, y, 12, GRAY, "peer   rtt  jitter  loss  throttle  queued  out/s");
+    y += 14;
+    for (const auto* peer : telemetry.GetWorstPeers(8)) {
+        Color color = peer->packetLoss > 0.05f || peer->roundTripTime > 150 ? RED : WHITE;
+        frame.text(x, y, 12, color, "%4u %5u %6u %5.1f%% %8.0f%% %7u %5.1f KB", peer->peerId, peer->roundTripTime,
+                   peer->roundTripTimeVariance, peer->packetLoss * 100.0f, peer->packetThrottle * 100.0f,
+                   peer->outgoingQueued + peer->reliableInFlight, peer->sendBytesPerSecond / 1024.0);
+        y += 14;
+    }
+    
+    // Compression savings per channel
+    y = 304;
+    const PacketCompressor& compressor = networkManager->GetCompressor();
+    for (std::size_t channel = 0; channel < MessageChannelCount; channel++) {
+        const auto& stats = compressor.GetStats(static_cast<MessageChannel>(channel));
+        double saved = stats.rawBytes > 0 ? 100.0 * (1.0 - static_cast<double>(stats.wireBytes) / stats.rawBytes) : 0.0;
+        frame.text(x, y, 12, WHITE, "%-8s %-7s saved %5.1f%%  %9.1f -> %9.1f KB  %6.0f us", channel == 0 ? "reliable" : "state",
+                   PacketCompressor::GetCodecName(stats.selected), saved, stats.rawBytes / 1024.0,
+                   stats.wireBytes / 1024.0, stats.encodeMicroseconds);
+        y += 14;
+    }
+}
+
+void Game::RecordMemoryOverlay(RenderFrame& frame) {
+    // With zones the pools of every registry are summed by name
+    ECSSystem::MemoryStats memory;
+    ecsSystem->collectMemoryStats(memory);
+    std::size_t registries = 1;
+    if (zoneManager) {
+        ECSSystem::MemoryStats zoneMemory;
+        for (std::size_t i = 0; i < zoneManager->getZoneCount(); i++) {
+            zoneManager->getZone(i).collectMemoryStats(zoneMemory);
+            for (const auto& pool : zoneMemory.pools) {
+                auto found = std::find_if(memory.pools.begin(), memory.pools.end(),
+                                          [&](const ECSSystem::PoolMemory& existing) { return existing.name == pool.name; });
+                if (found == memory.pools.end()) {
+                    memory.pools.push_back(pool);
+                    continue;
+                }
+                found->count += pool.count;
+                found->capacity += pool.capacity;
+                found->componentBytes += pool.componentBytes;
+                found->packedBytes += pool.packedBytes;
+                found->sparseBytes += pool.sparseBytes;
+                found->heapBytes += pool.heapBytes;
+                found->unusedBytes += pool.unusedBytes;
+            }
+            memory.totalBytes += zoneMemory.totalBytes;
+            memory.unusedBytes += zoneMemory.unusedBytes;
+        }
+        registries += zoneManager->getZoneCount();
+    }
+    
+    int x = static_cast<int>(frame.screenSize.x) - 430;
+    int y = showNetworkOverlay ? 360 : 10;
+    int height = 46 + static_cast<int>(memory.pools.size()) * 14;
+    frame.panel({static_cast<float>(x - 10), static_cast<float>(y - 5), 430.0f, static_cast<float>(height)}, Fade(BLACK, 0.7f));
+    
+    frame.text(x, y, 12, WHITE, "ECS memory (F4)  %.1f KB in %zu registries, %.1f KB unused", memory.totalBytes / 1024.0,
+               registries, memory.unusedBytes / 1024.0);
+    y += 14;
+    frame.text(x, y, 12, GRAY, "pool            count   capacity   data KB  packed  sparse  heap");
+    y += 14;
+    for (const auto& pool : memory.pools) {
+        // Pools holding over half their capacity unused are the ones compaction helps
+        Color color = pool.unusedBytes * 2 > pool.totalBytes() && pool.unusedBytes > 0 ? ORANGE : WHITE;
+        frame.text(x, y, 12, color, "%-14.*s %7zu %9zu %9.1f %7.1f %7.1f %5.1f", static_cast<int>(std::min<std::size_t>(pool.name.size(), 14)),
+                   pool.name.data(), pool.count, pool.capacity, pool.componentBytes / 1024.0,
+                   pool.packedBytes / 1024.0, pool.sparseBytes / 1024.0, pool.heapBytes / 1024.0);
+        y += 14;
+    }
+    if (options.deterministic || options.compactInterval <= 0.0f) {
+        frame.text(x, y, 12, GRAY, "Compaction disabled");
+    } else {
+        frame.text(x, y, 12, GRAY, "Last compaction released %.1f KB in %.0f us", lastCompactionBytes / 1024.0,
+                   lastCompactionMicroseconds);
+    }
+}
+
+void Game::CompactStorageIfIdle() {
+    if (!ecsSystem || options.deterministic || options.compactInterval <= 0.0f) return;
+    
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - lastCompactionCheck).count() < options.compactInterval) return;
+    // Try again next frame rather than stretch a busy tick
+    if (lastTickMicroseconds > fixedTimestep * 1000000.0 * 0.25) return;
+    lastCompactionCheck = now;
+    
+    // Only registries where at least 64 KB and a quarter of the memory is unused,
+    // which is what a despawned wave leaves behind
+    ECSSystem::MemoryStats memory;
+    auto compact = [&](ECSSystem& ecs) -> std::size_t {
+        ecs.collectMemoryStats(memory);
+        if (memory.unusedBytes < 64 * 1024 || memory.unusedBytes * 4 < memory.totalBytes) return 0;
+        return ecs.compactStorage();
+    };
+    
+    std::size_t released = compact(*ecsSystem);
+    if (zoneManager) {
+        for (std::size_t i = 0; i < zoneManager->getZoneCount(); i++) {
+            released += compact(zoneManager->getZone(i));
+        }
+    }
+    if (released == 0) return;
+    
+    lastCompactionBytes = released;
+    lastCompactionMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - now).count();
+    std::cout << "Compacted ECS storage: released " << released / 1024 << " KB in " << lastCompactionMicroseconds
+              << " us" << std::endl;
 }
 
 void Game::Shutdown() {
+    // Nothing else may touch the world while a frame is still being simulated
+    StopSimulationThread();
+    
+    // Its loopback clients go before the network does
+    soakTest.reset();
+    
+    if (replayRecorder) {
+        replayRecorder->Close(ecsSystem ? ecsSystem->computeStateHash() : 0);
+        replayRecorder.reset();
+    }
+    
+    // Joins the zone threads before the registries go away
+    if (zoneManager && windowCreated) {
+        zoneManager->unloadModels();
+    }
+    zoneManager.reset();
+    
     if (networkManager) {
         networkManager->Shutdown();
     }
     
-    CloseWindow();
+    // Atlas, chunk and particle textures need the GL context
+    if (particleSystem) {
+        particleSystem->unloadTextures();
+        particleSystem.reset();
+    }
+    if (tileMap) {
+        tileMap->unloadTextures();
+        tileMap.reset();
+    }
+    if (spriteAtlas) {
+        ecsSystem->setSpriteAtlas(nullptr);
+        spriteAtlas->unloadTextures();
+        spriteAtlas.reset();
+    }
+    
+    if (windowCreated) {
+        if (ecsSystem) {
+            ecsSystem->unloadModels();
+        }
+        CloseWindow();
+        windowCreated = false;
+    }
     running = false;
 }
 
-void Game::HandleInput() {
+InputFrame Game::SampleInput() {
+    InputFrame input;
+    if (!windowCreated) {
+        return input;
+    }
+    
+    if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) {
+        input.buttons |= InputFrame::MoveUp;
+    }
+    if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) {
+        input.buttons |= InputFrame::MoveDown;
+    }
+    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) {
+        input.buttons |= InputFrame::MoveLeft;
+    }
+    if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) {
+        input.buttons |= InputFrame::MoveRight;
+    }
+    if (IsKeyPressed(KEY_SPACE)) {
+        input.buttons |= InputFrame::SpawnWave;
+    }
+    
+    return input;
+}
+
+bool Game::SaveWorld(const std::string& path) {
+    if (!worldSerializer->save(ecsSystem->getRegistry(), path)) {
+        return false;
+    }
+    
+    double seconds = worldSerializer->getLastMilliseconds() / 1000.0;
+    std::cout << "Saved world to " << path << ": " << worldSerializer->getLastBytes() / 1024 << " KB in "
+              << worldSerializer->getLastMilliseconds() << " ms ("
+              << (seconds > 0.0 ? worldSerializer->getLastBytes() / seconds / (1024.0 * 1024.0) : 0.0) << " MB/s)" << std::endl;
+    return true;
+}
+
+bool Game::LoadWorld(const std::string& path) {
+    ecsSystem->unloadModels();
+    bool loaded = worldSerializer->load(ecsSystem->getRegistry(), path);
+    
+    // Entity ids are preserved, but the player may be a different entity in the loaded world
+    playerEntity = entt::null;
+    for (auto entity : ecsSystem->view<Player>()) {
+        playerEntity = entity;
+        break;
+    }
+    ecsSystem->setCameraTarget(playerEntity);
+    
+    // Static colliders may have moved, and the player goal follows the new player
+    if (navigationSystem) {
+        navigationSystem->setGoalTarget(playerGoal, playerEntity);
+        navigationSystem->markObstaclesDirty();
+    }
+    if (particleSystem) {
+        particleSystem->attach(playerTrailEmitter, playerEntity);
+        particleSystem->attach(waveSparkEmitter, playerEntity);
+    }
+    
+    // Models need a GL context; headless runs keep just the paths
+    std::size_t models = windowCreated ? ecsSystem->reloadModels() : 0;
+    
+    // Snapshots belong to the previous timeline
+    if (snapshots) {
+        snapshots->clear();
+    }
+    
+    if (!loaded) {
+        return false;
+    }
+    
+    double seconds = worldSerializer->getLastMilliseconds() / 1000.0;
+    std::cout << "Loaded world from " << path << ": " << ecsSystem->getRegistry().storage<entt::entity>().in_use()
+              << " entities, " << models << " models, " << worldSerializer->getLastBytes() / 1024 << " KB in "
+              << worldSerializer->getLastMilliseconds() << " ms ("
+              << (seconds > 0.0 ? worldSerializer->getLastBytes() / seconds / (1024.0 * 1024.0) : 0.0) << " MB/s)" << std::endl;
+    return true;
+}
+
+void Game::HandleInput(const InputFrame& input) {
     if (!ecsSystem || !ecsSystem->hasComponent<ECSTransform>(playerEntity) || !ecsSystem->hasComponent<Velocity>(playerEntity) || !ecsSystem->hasComponent<Player>(playerEntity)) {
         return;
     }
@@ -272,16 +1267,16 @@ void Game::HandleInput() {
     // Player movement
     Vector2 movement = {0.0f, 0.0f};
     
-    if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) {
+    if (input.isDown(InputFrame::MoveUp)) {
         movement.y -= 1.0f;
     }
-    if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) {
+    if (input.isDown(InputFrame::MoveDown)) {
         movement.y += 1.0f; 
     }
-    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) {
+    if (input.isDown(InputFrame::MoveLeft)) {
         movement.x -= 1.0f;
     }
-    if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) {
+    if (input.isDown(InputFrame::MoveRight)) {
         movement.x += 1.0f;
     }
     
@@ -295,9 +1290,225 @@ void Game::HandleInput() {
     // Update velocity based on input
     velocity.linear.x = movement.x * player.speed;
     velocity.linear.y = movement.y * player.speed;
+    
+    // Spawn a wave of swarm entities around the player
+    if (input.isDown(InputFrame::SpawnWave)) {
+        SpawnWave(transform.position);
+    }
+}
+
+void Game::SpawnWave(Vector2 center) {
+    const Prefab* prefab = prefabLibrary ? prefabLibrary->find("swarm") : nullptr;
+    if (!prefab) {
+        std::cout << "No 'swarm' prefab defined, skipping wave" << std::endl;
+        return;
+    }
+    
+    const std::size_t waveSize = 10000;
+    std::vector<entt::entity> spawned;
+    spawned.reserve(waveSize);
+    
+    auto start = std::chrono::steady_clock::now();
+    ecsSystem->spawnPrefab(*prefab, waveSize, spawned);
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    
+    // Scatter the wave in a ring around the center
+    if (prefab->has<ECSTransform>()) {
+        for (std::size_t i = 0; i < spawned.size(); i++) {
+            float angle = (float)i * (2.0f * PI / (float)waveSize);
+            float distance = 300.0f + (float)random.range(0, 1000);
+            ecsSystem->getComponent<ECSTransform>(spawned[i]).position = {
+                center.x + cosf(angle) * distance,
+                center.y + sinf(angle) * distance
+            };
+        }
+    }
+    
+    if (zoneManager) {
+        zoneManager->adoptEntities(*ecsSystem, playerEntity);
+    }
+    
+    std::cout << "Spawned wave of " << waveSize << " '" << prefab->getName() << "' entities in "
+              << elapsed.count() << " us (" << elapsed.count() / waveSize << " us/entity)" << std::endl;
+}
+
+void Game::InitializeSprites() {
+    #ifdef __EMSCRIPTEN__
+        const std::string assetsRoot = "/assets";
+    #else
+        const std::string assetsRoot = "assets";
+    #endif
+    
+    // Reuse the packed atlas from a previous run unless the sprites changed
+    // since; packing ~800 PNGs is slow
+    std::vector<AtlasSource> sources = SpriteAtlas::getDefaultSources(assetsRoot);
+    spriteAtlas = std::make_unique<SpriteAtlas>();
+    bool cacheCurrent = SpriteAtlas::isCacheCurrent(options.atlasPath, sources);
+    if (!cacheCurrent || !spriteAtlas->load(options.atlasPath)) {
+        if (!cacheCurrent) {
+            std::cout << "Sprite atlas " << options.atlasPath << " is missing or out of date, rebuilding" << std::endl;
+        }
+        if (!spriteAtlas->build(sources)) {
+            std::cout << "Warning: No sprites found under " << assetsRoot << ", sprites disabled" << std::endl;
+            spriteAtlas.reset();
+            return;
+        }
+        spriteAtlas->save(options.atlasPath);
+    }
+    if (!spriteAtlas->uploadTextures()) {
+        spriteAtlas.reset();
+        return;
+    }
+    ecsSystem->setSpriteAtlas(spriteAtlas.get());
+    
+    // Showcase every region in two grids below the start area, Side sprites
+    // behind the larger Isometric tiles
+    std::size_t sideCount = 0;
+    std::size_t isometricCount = 0;
+    for (std::uint32_t id = 0; id < spriteAtlas->getRegionCount(); id++) {
+        const AtlasRegion& region = spriteAtlas->getRegion(id);
+        bool isometric = region.name.compare(0, 10, "Isometric/") == 0;
+        std::size_t index = isometric ? isometricCount++ : sideCount++;
+        
+        Vector2 position = isometric
+            ? Vector2{-800.0f + (index % 24) * 100.0f, 1400.0f + (index / 24) * 80.0f}
+            : Vector2{-800.0f + (index % 30) * 80.0f, 800.0f + (index / 30) * 80.0f};
+        auto entity = ecsSystem->createEntity();
+        ecsSystem->addComponent(entity, ECSTransform{position});
+        ecsSystem->addComponent(entity, Sprite{id, static_cast<std::int16_t>(isometric ? 1 : 0), WHITE, 1.0f});
+    }
+    std::cout << "Spawned " << sideCount + isometricCount << " atlas sprites (" << sideCount << " side, "
+              << isometricCount << " isometric)" << std::endl;
+}
+
+void Game::InitializeTileMap() {
+    std::uint32_t ground = spriteAtlas->findRegion("Isometric/terrain_NE");
+    std::uint32_t crater = spriteAtlas->findRegion("Isometric/crater_NE");
+    std::uint32_t roadA = spriteAtlas->findRegion("Isometric/terrain_roadStraight_NE");
+    std::uint32_t roadB = spriteAtlas->findRegion("Isometric/terrain_roadStraight_NW");
+    std::uint32_t cross = spriteAtlas->findRegion("Isometric/terrain_roadCross_NE");
+    if (ground == SpriteAtlas::InvalidRegion) {
+        std::cout << "Warning: Atlas has no Isometric/terrain_NE tile, tilemap disabled" << std::endl;
+        return;
+    }
+    // Missing detail tiles fall back to plain ground
+    for (std::uint32_t* tile : {&crater, &roadA, &roadB, &cross}) {
+        if (*tile == SpriteAtlas::InvalidRegion) *tile = ground;
+    }
+    
+    // A 64x64 diamond of ground centred on the start position, with two roads
+    // crossing in the middle and a fixed scatter of craters
+    const int mapSize = 64;
+    const int middle = mapSize / 2;
+    TileMapConfig config;
+    config.origin = {400.0f, 300.0f - middle * config.tileHeight};
+    tileMap = std::make_unique<TileMap>(*spriteAtlas, config);
+    
+    auto start = std::chrono::steady_clock::now();
+    tileMap->fill(0, 0, mapSize, mapSize, ground);
+    for (int i = 0; i < mapSize; i++) {
+        tileMap->setTile(middle, i, roadA);
+        tileMap->setTile(i, middle, roadB);
+    }
+    tileMap->setTile(middle, middle, cross);
+    for (int y = 0; y < mapSize; y++) {
+        for (int x = 0; x < mapSize; x++) {
+            std::uint32_t hash = static_cast<std::uint32_t>(x) * 73856093u ^ static_cast<std::uint32_t>(y) * 19349663u;
+            if (x != middle && y != middle && hash % 29 == 0) {
+                tileMap->setTile(x, y, crater);
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    std::cout << "Built " << mapSize << "x" << mapSize << " tilemap in " << elapsed.count() << " us" << std::endl;
 }
 
-void Game::UpdatePlayer() {
+void Game::InitializeParticles() {
+    particleSystem = std::make_unique<ParticleSystem>();
+    if (!particleSystem->uploadTextures()) {
+        particleSystem.reset();
+        return;
+    }
+    
+    // A short soft trail behind the player
+    EmitterConfig trail;
+    trail.capacity = 512;
+    trail.rate = 120.0f;
+    trail.lifeMin = 0.3f;
+    trail.lifeMax = 0.6f;
+    trail.speedMin = 5.0f;
+    trail.speedMax = 15.0f;
+    trail.sizeMin = 6.0f;
+    trail.sizeMax = 10.0f;
+    trail.startColor = {120, 200, 255, 180};
+    trail.endColor = {40, 80, 255, 0};
+    playerTrailEmitter = particleSystem->createEmitter(trail, playerPosition);
+    particleSystem->attach(playerTrailEmitter, playerEntity);
+    
+    // Additive sparks thrown out when a wave spawns around the player
+    EmitterConfig sparks;
+    sparks.capacity = 4096;
+    sparks.rate = 0.0f;
+    sparks.lifeMin = 0.4f;
+    sparks.lifeMax = 1.2f;
+    sparks.speedMin = 150.0f;
+    sparks.speedMax = 450.0f;
+    sparks.sizeMin = 2.0f;
+    sparks.sizeMax = 4.0f;
+    sparks.endScale = 0.5f;
+    sparks.drag = 1.5f;
+    sparks.startColor = {255, 220, 120, 255};
+    sparks.endColor = {255, 60, 20, 0};
+    sparks.additive = true;
+    sparks.soft = false;
+    waveSparkEmitter = particleSystem->createEmitter(sparks, playerPosition);
+    particleSystem->attach(waveSparkEmitter, playerEntity);
+    
+    // An additive fountain below the start area; a full pool of particleCapacity
+    // particles lives about 2.5 seconds, so the rate keeps it close to full
+    if (options.particleCapacity > 0) {
+        EmitterConfig fountain;
+        fountain.capacity = static_cast<std::size_t>(options.particleCapacity);
+        fountain.rate = options.particleCapacity / 2.5f;
+        fountain.lifeMin = 2.0f;
+        fountain.lifeMax = 3.0f;
+        fountain.spread = 0.6f;
+        fountain.speedMin = 250.0f;
+        fountain.speedMax = 400.0f;
+        fountain.sizeMin = 3.0f;
+        fountain.sizeMax = 6.0f;
+        fountain.endScale = 0.3f;
+        fountain.gravity = {0.0f, 300.0f};
+        fountain.drag = 0.2f;
+        fountain.startColor = {80, 160, 255, 200};
+        fountain.endColor = {200, 80, 255, 0};
+        fountain.additive = true;
+        particleSystem->createEmitter(fountain, {400.0f, 520.0f});
+    }
+    
+    std::cout << "Particles: " << particleSystem->getStats().emitters << " emitters, "
+              << (ParticleSystem::usesSimd() ? "SSE2" : "scalar") << " update" << std::endl;
+}
+
+void Game::EditTileMap() {
+    bool paint = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    bool erase = IsMouseButtonPressed(MOUSE_BUTTON_RIGHT);
+    if (!paint && !erase) return;
+    
+    Vector2 mouse = GetMousePosition();
+    Vector2 cameraOffset = ecsSystem->getCameraOffset();
+    int x = 0;
+    int y = 0;
+    tileMap->worldToTile({mouse.x + cameraOffset.x, mouse.y + cameraOffset.y}, x, y);
+    
+    // Only the chunk holding the tile is rebuilt
+    std::uint32_t region = spriteAtlas->findRegion(paint ? "Isometric/crater_NE" : "Isometric/terrain_NE");
+    if (region != SpriteAtlas::InvalidRegion) {
+        tileMap->setTile(x, y, region);
+    }
+}
+
+void Game::UpdatePlayer(const std::pmr::vector<NetworkMessage>& messages) {
     if (!ecsSystem || !ecsSystem->hasComponent<ECSTransform>(playerEntity) || !ecsSystem->hasComponent<Networked>(playerEntity)) {
         return;
     }
@@ -307,20 +1518,42 @@ void Game::UpdatePlayer() {
     
     // Send player position to network if connected
     if (networkManager && networkManager->IsConnected() && networked.needsSync) {
-        networkManager->SendMessage(networked.lastSyncData);
+        // Positions are state: a lost update is superseded by the next one
+        char message[64];
+        int length = std::snprintf(message, sizeof(message), "POS:%f,%f", networked.syncPosition.x, networked.syncPosition.y);
+        if (length > 0) {
+            networkManager->SendMessage(std::string_view(message, std::min<std::size_t>(length, sizeof(message) - 1)),
+                                        MessageChannel::State);
+        }
         networked.needsSync = false;
     }
     
-    // Process incoming network messages
-    if (networkManager) {
-        auto messages = networkManager->GetMessages();
-        for (const auto& msg : messages) {
-            // Handle different message types here
-            if (msg.data.substr(0, 4) == "POS:") {
-                // Handle position updates from other players
-                // This is a simple example - in a real game you'd parse the position
+    // Process incoming network messages (message list lives in the frame arena)
+    for (const auto& msg : messages) {
+        // Handle different message types here
+        if (msg.data.compare(0, 4, "POS:") == 0) {
+            // Handle position updates from other players
+            if (options.verbose) {
                 std::cout << "Received position update: " << msg.data << std::endl;
             }
+            
+            // With zones the server tracks each client's player in its zone
+            Vector2 position;
+            if (zoneManager && msg.peer && std::sscanf(msg.data.c_str(), "POS:%f,%f", &position.x, &position.y) == 2) {
+                zoneManager->setPeerPosition(msg.peer, position);
+            }
+        } else if (msg.data.compare(0, 5, "ZONE:") == 0) {
+            // The server moved this client to another zone
+            std::cout << "Now served by zone " << msg.data.substr(5) << std::endl;
+        } else if (msg.data.compare(0, 5, "PING:") == 0 && networkManager && networkManager->IsServer()) {
+            // Latency probe: echo the payload with the server's tick time and load
+            char reply[160];
+            int length = std::snprintf(reply, sizeof(reply), "PONG:%.*s:%.0f:%zu",
+                                       static_cast<int>(std::min<std::size_t>(msg.data.size() - 5, 96)), msg.data.data() + 5,
+                                       lastTickMicroseconds, networkManager->GetConnectedPeerCount());
+            if (length > 0) {
+                networkManager->SendMessageTo(msg.peer, std::string_view(reply, std::min<std::size_t>(length, sizeof(reply) - 1)));
+            }
         }
     }
 }
@@ -328,6 +1561,8 @@ void Game::UpdatePlayer() {
 void Game::InitializeBoostFeatures() {
     // Initialize Boost filesystem path
     assetsPath = boost::filesystem::current_path() / "assets";
+    assetsPathText = assetsPath.string();
+    assetsPathExists = boost::filesystem::exists(assetsPath);
     
     // Initialize Boost regex for version matching
     versionRegex = boost::regex("v\\d+\\.\\d+\\.\\d+");
@@ -0,0 +1,399 @@
+#include "Game.h"
+#include "MessageBatch.h"
+#include "NetworkManager.h"
+#include "PacketCompressor.h"
+#include <enet/enet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <boost/thread.hpp>
+
+// Load generator: many lightweight bot clients in one process, connected
+// over loopback, sending the same POS messages a real client sends plus
+// PING latency probes. Clients are added in steps; each step reports
+// latency percentiles, server tick time and bandwidth.
+
+namespace po = boost::program_options;
+
+namespace {
+    struct Bot {
+        std::size_t id = 0;
+        ENetPeer* peer = nullptr;
+        bool connected = false;
+        bool failed = false;
+        double nextInputTime = 0.0;
+        double nextPingTime = 0.0;
+        float phase = 0.0f;
+    };
+
+    struct StepStats {
+        std::vector<double> latenciesMs;
+        double serverTickSum = 0.0;
+        double serverTickMax = 0.0;
+        std::size_t serverTickSamples = 0;
+        std::size_t serverPeers = 0;
+        std::size_t messagesSent = 0;
+        std::size_t messagesReceived = 0;
+    };
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    double NowMicroseconds() {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    double Percentile(std::vector<double>& values, double fraction) {
+        if (values.empty()) return 0.0;
+        std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(fraction * values.size()));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    // PONG:<bot>:<send time us>:<server tick us>:<server peers>
+    void HandlePong(const char* payload, std::size_t length, StepStats& stats) {
+        std::string text(payload, length);
+        unsigned long long bot = 0;
+        double sendTime = 0.0;
+        double serverTick = 0.0;
+        unsigned long long peers = 0;
+        if (std::sscanf(text.c_str(), "PONG:%llu:%lf:%lf:%llu", &bot, &sendTime, &serverTick, &peers) != 4) {
+            return;
+        }
+
+        stats.latenciesMs.push_back((NowMicroseconds() - sendTime) / 1000.0);
+        stats.serverTickSum += serverTick;
+        stats.serverTickMax = std::max(stats.serverTickMax, serverTick);
+        stats.serverTickSamples++;
+        stats.serverPeers = std::max<std::size_t>(stats.serverPeers, peers);
+    }
+
+    // Bots use the same batch format, compression and channels as NetworkManager
+    void FlushBatch(ENetPeer* peer, MessageBatch& batch, MessageChannel channel, PacketCompressor& compressor, StepStats& stats) {
+        stats.messagesSent += batch.GetMessageCount();
+        batch.Flush(channel, compressor, [peer, channel](ENetPacket* packet) {
+            if (enet_peer_send(peer, static_cast<enet_uint8>(channel), packet) != 0) {
+                enet_packet_destroy(packet);
+            }
+        });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    po::options_description desc("Load Test Options");
+    desc.add_options()
+        ("help,h", "Show this help message")
+        ("host", po::value<std::string>()->default_value("127.0.0.1"), "Server host (default: 127.0.0.1)")
+        ("port,p", po::value<int>()->default_value(12345), "Server port (default: 12345)")
+        ("clients", po::value<int>()->default_value(1000), "Total bot clients (default: 1000)")
+        ("ramp-step", po::value<int>()->default_value(100), "Clients added per step (default: 100)")
+        ("step-seconds", po::value<double>()->default_value(5.0), "Measurement time per step (default: 5)")
+        ("input-rate", po::value<double>()->default_value(20.0), "POS messages per second per client (default: 20)")
+        ("ping-rate", po::value<double>()->default_value(2.0), "Latency probes per second per client (default: 2)")
+        ("peers-per-host", po::value<int>()->default_value(256), "Bot connections sharing one ENet host/socket (default: 256)")
+        ("embedded-server", "Run a headless game server in this process")
+        ("compression", po::value<std::string>()->default_value("adaptive"), "Bot packet compression: adaptive or off (default: adaptive)")
+        ("range-coder", "Compress datagrams with ENet's range coder (must match the server)")
+        ("zones", po::value<int>()->default_value(1), "Zones (threads) for the embedded server (default: 1)")
+        ("csv", po::value<std::string>(), "Also write per-step results to a CSV file");
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch (const po::error& e) {
+        std::cerr << "Error parsing command line options: " << e.what() << std::endl;
+        std::cout << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    std::string host = vm["host"].as<std::string>();
+    int port = vm["port"].as<int>();
+    std::size_t totalClients = static_cast<std::size_t>(std::max(1, vm["clients"].as<int>()));
+    std::size_t rampStep = static_cast<std::size_t>(std::max(1, vm["ramp-step"].as<int>()));
+    double stepSeconds = std::max(0.5, vm["step-seconds"].as<double>());
+    double inputInterval = 1000000.0 / std::max(0.1, vm["input-rate"].as<double>());
+    double pingInterval = 1000000.0 / std::max(0.1, vm["ping-rate"].as<double>());
+    std::size_t peersPerHost = std::min<std::size_t>(NetworkManager::MaxClientsLimit,
+                                                     static_cast<std::size_t>(std::max(1, vm["peers-per-host"].as<int>())));
+
+    std::string compression = vm["compression"].as<std::string>();
+    if (compression != "adaptive" && compression != "off") {
+        std::cerr << "Compression must be adaptive or off" << std::endl;
+        return 1;
+    }
+    bool rangeCoder = vm.count("range-coder") > 0;
+
+    if (totalClients > NetworkManager::MaxClientsLimit) {
+        std::cerr << "At most " << NetworkManager::MaxClientsLimit << " clients can connect to one server" << std::endl;
+        return 1;
+    }
+
+    if (enet_initialize() != 0) {
+        std::cerr << "Failed to initialize ENet" << std::endl;
+        return 1;
+    }
+
+    // Optional in-process server, sized for every bot
+    Game server;
+    boost::thread serverThread;
+    std::atomic<int> serverState(0);  // 0 starting, 1 running, -1 failed
+    if (vm.count("embedded-server")) {
+        GameOptions options;
+        options.isServer = true;
+        options.headless = true;
+        options.port = port;
+        options.maxClients = static_cast<int>(totalClients);
+        options.compression = compression == "adaptive";
+        options.rangeCoder = rangeCoder;
+        options.zones = std::max(1, vm["zones"].as<int>());
+
+        serverThread = boost::thread([&server, &serverState, options]() {
+            try {
+                server.Initialize(options);
+                serverState = 1;
+                while (server.IsRunning()) {
+                    server.Update();
+                }
+                server.Shutdown();
+            } catch (const std::exception& e) {
+                std::cerr << "Embedded server error: " << e.what() << std::endl;
+                serverState = -1;
+            }
+        });
+
+        while (serverState == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (serverState < 0) {
+            serverThread.join();
+            enet_deinitialize();
+            return 1;
+        }
+        host = "127.0.0.1";
+    }
+
+    ENetAddress serverAddress;
+    if (enet_address_set_host(&serverAddress, host.c_str()) != 0) {
+        std::cerr << "Could not resolve " << host << std::endl;
+        return 1;
+    }
+    serverAddress.port = static_cast<enet_uint16>(port);
+
+    // All bots talk to the same server, so one compressor holds its
+    // dictionary for everyone and pools the bots' own send statistics
+    PacketCompressor compressor;
+    compressor.SetEnabled(compression == "adaptive");
+
+    std::vector<Bot> bots(totalClients);
+    std::vector<ENetHost*> hosts;
+    std::size_t botsStarted = 0;
+
+    std::ofstream csv;
+    if (vm.count("csv")) {
+        csv.open(vm["csv"].as<std::string>());
+        csv << "clients,connected,failed,latency_p50_ms,latency_p90_ms,latency_p99_ms,latency_max_ms,"
+               "server_tick_avg_us,server_tick_max_us,server_peers,up_kbps,down_kbps,sent_per_s,received_per_s\n";
+    }
+
+    std::printf("%8s %9s %6s %8s %8s %8s %8s %10s %10s %10s %10s\n", "clients", "connected", "failed",
+                "p50 ms", "p90 ms", "p99 ms", "max ms", "tick us", "tick max", "up KB/s", "down KB/s");
+
+    while (botsStarted < totalClients) {
+        // Add the next group of bots
+        std::size_t target = std::min(totalClients, botsStarted + rampStep);
+        for (; botsStarted < target; botsStarted++) {
+            if (botsStarted / peersPerHost >= hosts.size()) {
+                ENetHost* botHost = enet_host_create(nullptr, peersPerHost, 2, 0, 0);
+                if (botHost == nullptr) {
+                    std::cerr << "Failed to create client host, stopping at " << botsStarted << " clients" << std::endl;
+                    totalClients = botsStarted;
+                    break;
+                }
+                if (rangeCoder && enet_host_compress_with_range_coder(botHost) != 0) {
+                    std::cerr << "Failed to enable ENet range coder compression" << std::endl;
+                }
+                hosts.push_back(botHost);
+            }
+
+            Bot& bot = bots[botsStarted];
+            bot.id = botsStarted;
+            bot.phase = static_cast<float>(botsStarted) * 0.37f;
+            bot.peer = enet_host_connect(hosts.back(), &serverAddress, 2, 0);
+            if (bot.peer == nullptr) {
+                bot.failed = true;
+                continue;
+            }
+            bot.peer->data = &bot;
+        }
+
+        StepStats stats;
+        for (ENetHost* botHost : hosts) {
+            botHost->totalSentData = 0;
+            botHost->totalReceivedData = 0;
+        }
+
+        MessageBatch stateBatch;
+        MessageBatch reliableBatch;
+
+        double stepStart = NowMicroseconds();
+        double stepEnd = stepStart + stepSeconds * 1000000.0;
+        while (NowMicroseconds() < stepEnd) {
+            for (ENetHost* botHost : hosts) {
+                ENetEvent event;
+                while (enet_host_service(botHost, &event, 0) > 0) {
+                    Bot* bot = event.peer ? static_cast<Bot*>(event.peer->data) : nullptr;
+                    switch (event.type) {
+                        case ENET_EVENT_TYPE_CONNECT:
+                            if (bot) {
+                                // Spread sends over the interval so bots do not fire in lockstep
+                                double now = NowMicroseconds();
+                                bot->connected = true;
+                                bot->nextInputTime = now + inputInterval * (bot->id % 97) / 97.0;
+                                bot->nextPingTime = now + pingInterval * (bot->id % 89) / 89.0;
+                            }
+                            break;
+                        case ENET_EVENT_TYPE_DISCONNECT:
+                            if (bot) {
+                                bot->failed = true;
+                                bot->connected = false;
+                                bot->peer = nullptr;
+                            }
+                            break;
+                        case ENET_EVENT_TYPE_RECEIVE: {
+                            const enet_uint8* data = nullptr;
+                            std::size_t length = 0;
+                            if (!compressor.Decode(event.packet->data, event.packet->dataLength, data, length)) {
+                                enet_packet_destroy(event.packet);
+                                break;
+                            }
+                            MessageBatch::ForEachMessage(data, length,
+                                [&stats](std::string_view message) {
+                                    if (message.compare(0, 5, "PONG:") == 0) {
+                                        HandlePong(message.data(), message.size(), stats);
+                                    }
+                                    stats.messagesReceived++;
+                                });
+                            enet_packet_destroy(event.packet);
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+            }
+
+            // Scripted input: each bot walks a circle and reports its position
+            double now = NowMicroseconds();
+            char message[96];
+            for (std::size_t i = 0; i < botsStarted; i++) {
+                Bot& bot = bots[i];
+                if (!bot.connected) continue;
+
+                if (now >= bot.nextInputTime) {
+                    float angle = bot.phase + static_cast<float>(now / 1000000.0);
+                    int length = std::snprintf(message, sizeof(message), "POS:%.2f,%.2f",
+                                               400.0f + 200.0f * std::cos(angle), 300.0f + 200.0f * std::sin(angle));
+                    stateBatch.Append(std::string_view(message, length));
+                    bot.nextInputTime += inputInterval;
+                }
+                if (now >= bot.nextPingTime) {
+                    int length = std::snprintf(message, sizeof(message), "PING:%zu:%.0f", bot.id, now);
+                    reliableBatch.Append(std::string_view(message, length));
+                    bot.nextPingTime += pingInterval;
+                }
+
+                FlushBatch(bot.peer, stateBatch, MessageChannel::State, compressor, stats);
+                FlushBatch(bot.peer, reliableBatch, MessageChannel::Reliable, compressor, stats);
+            }
+
+            for (ENetHost* botHost : hosts) {
+                enet_host_flush(botHost);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Step report
+        double seconds = (NowMicroseconds() - stepStart) / 1000000.0;
+        std::size_t connected = 0;
+        std::size_t failed = 0;
+        for (std::size_t i = 0; i < botsStarted; i++) {
+            connected += bots[i].connected ? 1 : 0;
+            failed += bots[i].failed ? 1 : 0;
+        }
+        std::uint64_t sentBytes = 0;
+        std::uint64_t receivedBytes = 0;
+        for (ENetHost* botHost : hosts) {
+            sentBytes += botHost->totalSentData;
+            receivedBytes += botHost->totalReceivedData;
+        }
+
+        double p50 = Percentile(stats.latenciesMs, 0.50);
+        double p90 = Percentile(stats.latenciesMs, 0.90);
+        double p99 = Percentile(stats.latenciesMs, 0.99);
+        double maxLatency = stats.latenciesMs.empty() ? 0.0 : *std::max_element(stats.latenciesMs.begin(), stats.latenciesMs.end());
+        double tickAverage = stats.serverTickSamples > 0 ? stats.serverTickSum / stats.serverTickSamples : 0.0;
+        double upKBps = sentBytes / seconds / 1024.0;
+        double downKBps = receivedBytes / seconds / 1024.0;
+
+        std::printf("%8zu %9zu %6zu %8.2f %8.2f %8.2f %8.2f %10.1f %10.1f %10.1f %10.1f\n", botsStarted, connected, failed,
+                    p50, p90, p99, maxLatency, tickAverage, stats.serverTickMax, upKBps, downKBps);
+        std::fflush(stdout);
+
+        if (csv.is_open()) {
+            csv << botsStarted << ',' << connected << ',' << failed << ',' << p50 << ',' << p90 << ',' << p99 << ','
+                << maxLatency << ',' << tickAverage << ',' << stats.serverTickMax << ',' << stats.serverPeers << ','
+                << upKBps << ',' << downKBps << ',' << stats.messagesSent / seconds << ','
+                << stats.messagesReceived / seconds << '\n';
+        }
+    }
+
+    // Bot upload savings; the embedded server's own figures are in its telemetry
+    for (std::size_t channel = 0; channel < MessageChannelCount; channel++) {
+        const auto& stats = compressor.GetStats(static_cast<MessageChannel>(channel));
+        if (stats.rawBytes == 0) continue;
+        std::printf("%s channel: %llu -> %llu bytes (%.1f%% saved, %s selected, %.0f us encoding)\n",
+                    channel == 0 ? "Reliable" : "State", static_cast<unsigned long long>(stats.rawBytes),
+                    static_cast<unsigned long long>(stats.wireBytes),
+                    100.0 * (1.0 - static_cast<double>(stats.wireBytes) / stats.rawBytes),
+                    PacketCompressor::GetCodecName(stats.selected), stats.encodeMicroseconds);
+    }
+
+    // Tear down bots, then the embedded server
+    for (auto& bot : bots) {
+        if (bot.peer) {
+            enet_peer_disconnect_now(bot.peer, 0);
+        }
+    }
+    for (ENetHost* botHost : hosts) {
+        enet_host_flush(botHost);
+        enet_host_destroy(botHost);
+    }
+
+    if (serverThread.joinable()) {
+        server.RequestStop();
+        serverThread.join();
+    }
+
+    enet_deinitialize();
+
+    std::size_t connected = 0;
+    for (const auto& bot : bots) {
+        connected += bot.connected ? 1 : 0;
+    }
+    return connected > 0 ? 0 : 1;
+}
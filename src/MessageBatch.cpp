@@ -0,0 +1,29 @@
+#include "MessageBatch.h"
+
+bool MessageBatch::Append(std::string_view message) {
+    if (message.size() > MaxMessageBytes) {
+        return false;
+    }
+
+    // Close the current packet if this message would overflow it; a message
+    // larger than the budget gets a packet of its own and ENet fragments it
+    std::size_t entryBytes = LengthPrefixBytes + message.size();
+    if (buffer.size() > packetStart && buffer.size() - packetStart + entryBytes > maxPacketBytes) {
+        packetEnds.push_back(buffer.size());
+        packetStart = buffer.size();
+    }
+
+    buffer.push_back(static_cast<char>(message.size() & 0xFF));
+    buffer.push_back(static_cast<char>((message.size() >> 8) & 0xFF));
+    buffer.insert(buffer.end(), message.begin(), message.end());
+    messageCount++;
+    return true;
+}
+
+void MessageBatch::Clear() {
+    // Keep capacity for the next tick
+    buffer.clear();
+    packetEnds.clear();
+    packetStart = 0;
+    messageCount = 0;
+}
@@ -0,0 +1,390 @@
+#include "Navigation.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace {
+    const float Unreachable = std::numeric_limits<float>::max();
+    const float DiagonalCost = 1.41421356f;
+    // Steered velocities slower than this are written as zero so resting agents can sleep
+    const float RestSpeed = 0.5f;
+
+    // Neighbour offsets; the first four are orthogonal
+    const int NeighbourX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+    const int NeighbourY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+    double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+NavigationSystem::NavigationSystem(const NavigationConfig& navigationConfig)
+    : config(navigationConfig)
+    , pool(std::make_unique<ThreadPool>(navigationConfig.threadCount))
+    , neighbourGrid(32.0f) {
+    config.width = std::max(1, config.width);
+    config.height = std::max(1, config.height);
+    config.steeringGrain = std::max<std::size_t>(1, config.steeringGrain);
+    blocked.assign(static_cast<std::size_t>(config.width) * config.height, 0);
+    stats.threads = pool->getThreadCount();
+}
+
+NavigationSystem::~NavigationSystem() = default;
+
+std::uint32_t NavigationSystem::addGoal(Vector2 position) {
+    goals.emplace_back();
+    goals.back().position = position;
+    return static_cast<std::uint32_t>(goals.size() - 1);
+}
+
+void NavigationSystem::setGoalPosition(std::uint32_t goal, Vector2 position) {
+    if (goal < goals.size()) {
+        goals[goal].position = position;
+    }
+}
+
+void NavigationSystem::setGoalTarget(std::uint32_t goal, entt::entity target) {
+    if (goal < goals.size()) {
+        goals[goal].target = target;
+    }
+}
+
+int NavigationSystem::cellAt(Vector2 position) const {
+    int x = static_cast<int>(std::floor((position.x - config.origin.x) / config.cellSize));
+    int y = static_cast<int>(std::floor((position.y - config.origin.y) / config.cellSize));
+    if (x < 0 || y < 0 || x >= config.width || y >= config.height) return -1;
+    return y * config.width + x;
+}
+
+int NavigationSystem::clampedCellAt(Vector2 position) const {
+    int x = static_cast<int>(std::floor((position.x - config.origin.x) / config.cellSize));
+    int y = static_cast<int>(std::floor((position.y - config.origin.y) / config.cellSize));
+    x = std::clamp(x, 0, config.width - 1);
+    y = std::clamp(y, 0, config.height - 1);
+    return y * config.width + x;
+}
+
+void NavigationSystem::update(entt::registry& registry, float deltaTime) {
+    auto buildStart = std::chrono::steady_clock::now();
+
+    if (obstaclesDirty) {
+        rebuildObstacles(registry);
+    }
+    updateGoals(registry);
+
+    // Each goal's build touches only its own field, so goals run in parallel;
+    // the budget is per goal, so the result does not depend on scheduling
+    buildingGoals.clear();
+    for (std::uint32_t i = 0; i < goals.size(); i++) {
+        if (goals[i].buildCell >= 0) {
+            buildingGoals.push_back(i);
+        }
+    }
+    std::size_t budget = config.buildBudget > 0 ? config.buildBudget : std::numeric_limits<std::size_t>::max();
+    pool->parallelFor(buildingGoals.size(), 1, [this, budget](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Goal& goal = goals[buildingGoals[i]];
+            goal.expanded = advanceBuild(goal, budget);
+        }
+    });
+
+    stats.goals = goals.size();
+    stats.building = 0;
+    stats.cellsExpanded = 0;
+    for (std::uint32_t index : buildingGoals) {
+        stats.cellsExpanded += goals[index].expanded;
+        if (goals[index].buildCell >= 0) {
+            stats.building++;
+        } else {
+            stats.fieldsBuilt++;
+        }
+    }
+    stats.buildMicroseconds = MicrosecondsSince(buildStart);
+
+    auto steerStart = std::chrono::steady_clock::now();
+    gatherAgents(registry);
+    pool->parallelFor(agentEntities.size(), config.steeringGrain, [this](std::size_t begin, std::size_t end) {
+        sampleFields(begin, end);
+    });
+    findNeighbours();
+    steer(deltaTime);
+    writeBack(registry);
+    stats.steerMicroseconds = MicrosecondsSince(steerStart);
+}
+
+void NavigationSystem::rebuildObstacles(entt::registry& registry) {
+    obstaclesDirty = false;
+    std::fill(blocked.begin(), blocked.end(), 0);
+
+    // Colliders that never move block every cell whose centre they cover,
+    // grown by half a cell so agents keep clear of the edges
+    float margin = config.cellSize / 2;
+    for (auto [entity, transform, collider] : registry.view<ECSTransform, Collider>().each()) {
+        const RigidBody* rigidBody = registry.try_get<RigidBody>(entity);
+        if (rigidBody && rigidBody->inverseMass > 0.0f) continue;
+
+        Vector2 extents = collider.isCircle ? Vector2{collider.radius, collider.radius} : collider.halfExtents;
+        int minX = static_cast<int>(std::floor((transform.position.x - extents.x - margin - config.origin.x) / config.cellSize));
+        int minY = static_cast<int>(std::floor((transform.position.y - extents.y - margin - config.origin.y) / config.cellSize));
+        int maxX = static_cast<int>(std::floor((transform.position.x + extents.x + margin - config.origin.x) / config.cellSize));
+        int maxY = static_cast<int>(std::floor((transform.position.y + extents.y + margin - config.origin.y) / config.cellSize));
+        minX = std::max(minX, 0);
+        minY = std::max(minY, 0);
+        maxX = std::min(maxX, config.width - 1);
+        maxY = std::min(maxY, config.height - 1);
+
+        for (int y = minY; y <= maxY; y++) {
+            for (int x = minX; x <= maxX; x++) {
+                float dx = config.origin.x + (x + 0.5f) * config.cellSize - transform.position.x;
+                float dy = config.origin.y + (y + 0.5f) * config.cellSize - transform.position.y;
+                bool covered = collider.isCircle
+                    ? dx * dx + dy * dy <= (collider.radius + margin) * (collider.radius + margin)
+                    : std::fabs(dx) <= extents.x + margin && std::fabs(dy) <= extents.y + margin;
+                if (covered) {
+                    blocked[y * config.width + x] = 1;
+                }
+            }
+        }
+    }
+
+    stats.blockedCells = static_cast<std::size_t>(std::count(blocked.begin(), blocked.end(), 1));
+
+    // Every field was built around the old obstacles, and so are builds under way
+    for (Goal& goal : goals) {
+        goal.cell = -1;
+        goal.buildCell = -1;
+    }
+}
+
+void NavigationSystem::updateGoals(entt::registry& registry) {
+    for (Goal& goal : goals) {
+        if (goal.target != entt::null && registry.valid(goal.target)) {
+            if (const ECSTransform* transform = registry.try_get<ECSTransform>(goal.target)) {
+                goal.position = transform->position;
+            }
+        }
+
+        // A new build starts when the goal reaches another cell; one already
+        // heading for that cell carries on, and returning to the active cell
+        // drops it
+        int cell = clampedCellAt(goal.position);
+        if (cell == goal.cell) {
+            goal.buildCell = -1;
+        } else if (cell != goal.buildCell) {
+            startBuild(goal, cell);
+        }
+    }
+}
+
+void NavigationSystem::startBuild(Goal& goal, int cell) {
+    std::size_t cellCount = blocked.size();
+    goal.building.cost.assign(cellCount, Unreachable);
+    goal.building.directionX.resize(cellCount);
+    goal.building.directionY.resize(cellCount);
+    goal.building.cost[cell] = 0.0f;
+    goal.open.clear();
+    goal.open.push_back(OpenCell{0.0f, static_cast<std::uint32_t>(cell)});
+    goal.buildCell = cell;
+}
+
+std::size_t NavigationSystem::advanceBuild(Goal& goal, std::size_t budget) {
+    auto greater = [](const OpenCell& a, const OpenCell& b) {
+        return a.cost != b.cost ? a.cost > b.cost : a.cell > b.cell;
+    };
+    std::vector<float>& cost = goal.building.cost;
+
+    std::size_t expanded = 0;
+    while (!goal.open.empty() && expanded < budget) {
+        std::pop_heap(goal.open.begin(), goal.open.end(), greater);
+        OpenCell current = goal.open.back();
+        goal.open.pop_back();
+        if (current.cost > cost[current.cell]) continue;  // superseded entry
+        expanded++;
+
+        int x = static_cast<int>(current.cell) % config.width;
+        int y = static_cast<int>(current.cell) / config.width;
+        for (int n = 0; n < 8; n++) {
+            int nx = x + NeighbourX[n];
+            int ny = y + NeighbourY[n];
+            if (nx < 0 || ny < 0 || nx >= config.width || ny >= config.height) continue;
+            int neighbour = ny * config.width + nx;
+            if (blocked[neighbour]) continue;
+            // No cutting corners past a blocked cell
+            if (n >= 4 && (blocked[y * config.width + nx] || blocked[ny * config.width + x])) continue;
+
+            float next = current.cost + (n < 4 ? 1.0f : DiagonalCost);
+            if (next < cost[neighbour]) {
+                cost[neighbour] = next;
+                goal.open.push_back(OpenCell{next, static_cast<std::uint32_t>(neighbour)});
+                std::push_heap(goal.open.begin(), goal.open.end(), greater);
+            }
+        }
+    }
+
+    if (goal.open.empty()) {
+        finishBuild(goal);
+    }
+    return expanded;
+}
+
+void NavigationSystem::finishBuild(Goal& goal) {
+    Field& field = goal.building;
+
+    // Every cell points at its cheapest reachable neighbour; blocked cells too,
+    // so agents pushed into an obstacle find their way out
+    for (int y = 0; y < config.height; y++) {
+        for (int x = 0; x < config.width; x++) {
+            int cell = y * config.width + x;
+            float best = field.cost[cell];
+            float bestX = 0.0f;
+            float bestY = 0.0f;
+            for (int n = 0; n < 8; n++) {
+                int nx = x + NeighbourX[n];
+                int ny = y + NeighbourY[n];
+                if (nx < 0 || ny < 0 || nx >= config.width || ny >= config.height) continue;
+                float neighbourCost = field.cost[ny * config.width + nx];
+                if (neighbourCost < best) {
+                    best = neighbourCost;
+                    bestX = static_cast<float>(NeighbourX[n]);
+                    bestY = static_cast<float>(NeighbourY[n]);
+                }
+            }
+            float length = std::sqrt(bestX * bestX + bestY * bestY);
+            field.directionX[cell] = length > 0.0f ? bestX / length : 0.0f;
+            field.directionY[cell] = length > 0.0f ? bestY / length : 0.0f;
+        }
+    }
+
+    std::swap(goal.active, goal.building);
+    goal.cell = goal.buildCell;
+    goal.buildCell = -1;
+    goal.hasField = true;
+}
+
+void NavigationSystem::gatherAgents(entt::registry& registry) {
+    agentEntities.clear();
+    agentGoals.clear();
+    positionX.clear();
+    positionY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    speeds.clear();
+    radii.clear();
+
+    for (auto [entity, transform, velocity, agent] : registry.view<ECSTransform, Velocity, NavAgent>().each()) {
+        agentEntities.push_back(entity);
+        agentGoals.push_back(agent.goal);
+        positionX.push_back(transform.position.x);
+        positionY.push_back(transform.position.y);
+        velocityX.push_back(velocity.linear.x);
+        velocityY.push_back(velocity.linear.y);
+        speeds.push_back(agent.speed);
+        radii.push_back(agent.radius);
+    }
+
+    std::size_t count = agentEntities.size();
+    goalDistance.resize(count);
+    directionX.resize(count);
+    directionY.resize(count);
+    avoidX.assign(count, 0.0f);
+    avoidY.assign(count, 0.0f);
+    stats.agents = count;
+}
+
+void NavigationSystem::sampleFields(std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+        std::uint32_t goalIndex = agentGoals[i];
+        if (goalIndex >= goals.size()) {
+            goalDistance[i] = 0.0f;
+            directionX[i] = 0.0f;
+            directionY[i] = 0.0f;
+            continue;
+        }
+        const Goal& goal = goals[goalIndex];
+
+        float dx = goal.position.x - positionX[i];
+        float dy = goal.position.y - positionY[i];
+        float distance = std::sqrt(dx * dx + dy * dy);
+        goalDistance[i] = distance;
+        directionX[i] = distance > 0.0f ? dx / distance : 0.0f;
+        directionY[i] = distance > 0.0f ? dy / distance : 0.0f;
+
+        // Follow the field, except in the goal's own cell, off the grid, or
+        // where the field has no way on
+        int cell = cellAt({positionX[i], positionY[i]});
+        if (!goal.hasField || cell < 0 || cell == goal.cell) continue;
+        float fieldX = goal.active.directionX[cell];
+        float fieldY = goal.active.directionY[cell];
+        if (fieldX != 0.0f || fieldY != 0.0f) {
+            directionX[i] = fieldX;
+            directionY[i] = fieldY;
+        }
+    }
+}
+
+void NavigationSystem::findNeighbours() {
+    // Agents whose separation ranges overlap; accumulated in pair order on
+    // this thread so the result is deterministic
+    float reach = config.avoidanceDistance / 2;
+    neighbourGrid.clear();
+    for (std::uint32_t i = 0; i < agentEntities.size(); i++) {
+        float extent = radii[i] + reach;
+        neighbourGrid.insert(i, {positionX[i] - extent, positionY[i] - extent, extent * 2, extent * 2});
+    }
+    pairs.clear();
+    neighbourGrid.findPairs(pairs, [](std::uint32_t, std::uint32_t) { return true; });
+    stats.avoidancePairs = pairs.size();
+
+    for (std::uint64_t pair : pairs) {
+        std::uint32_t a = static_cast<std::uint32_t>(pair >> 32);
+        std::uint32_t b = static_cast<std::uint32_t>(pair);
+        float dx = positionX[b] - positionX[a];
+        float dy = positionY[b] - positionY[a];
+        float range = radii[a] + radii[b] + config.avoidanceDistance;
+        float distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared >= range * range) continue;
+
+        // Strength grows linearly as the gap closes; coincident agents split along x
+        float distance = std::sqrt(distanceSquared);
+        float normalX = distance > 1e-4f ? dx / distance : 1.0f;
+        float normalY = distance > 1e-4f ? dy / distance : 0.0f;
+        float strength = (range - distance) / range;
+        avoidX[a] -= normalX * strength;
+        avoidY[a] -= normalY * strength;
+        avoidX[b] += normalX * strength;
+        avoidY[b] += normalY * strength;
+    }
+}
+
+void NavigationSystem::steer(float deltaTime) {
+    // Branch-free arithmetic over the agent arrays, which the compiler can vectorize
+    std::size_t count = agentEntities.size();
+    float arrival = std::max(config.arrivalDistance, 1e-3f);
+    float blend = std::min(1.0f, config.responsiveness * deltaTime);
+    for (std::size_t i = 0; i < count; i++) {
+        float speed = speeds[i] * std::min(1.0f, goalDistance[i] / arrival);
+        float targetX = directionX[i] * speed + avoidX[i] * speeds[i] * config.avoidanceWeight;
+        float targetY = directionY[i] * speed + avoidY[i] * speeds[i] * config.avoidanceWeight;
+
+        // Never faster than the agent's own speed
+        float length = std::sqrt(targetX * targetX + targetY * targetY);
+        float limit = length > speeds[i] ? speeds[i] / length : 1.0f;
+        targetX *= limit;
+        targetY *= limit;
+
+        velocityX[i] += (targetX - velocityX[i]) * blend;
+        velocityY[i] += (targetY - velocityY[i]) * blend;
+    }
+}
+
+void NavigationSystem::writeBack(entt::registry& registry) {
+    for (std::size_t i = 0; i < agentEntities.size(); i++) {
+        Vector2 velocity = {velocityX[i], velocityY[i]};
+        if (velocity.x * velocity.x + velocity.y * velocity.y < RestSpeed * RestSpeed) {
+            velocity = {0.0f, 0.0f};
+        }
+        registry.get<Velocity>(agentEntities[i]).linear = velocity;
+    }
+}
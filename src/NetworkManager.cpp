@@ -6,7 +6,9 @@ NetworkManager::NetworkManager()
     : host(nullptr)
     , peer(nullptr)
     , isServer(false)
-    , isConnected(false) {
+    , isConnected(false)
+    , useRangeCoder(false) {
+    telemetry.SetCompressor(&compressor);
 }
 
 NetworkManager::~NetworkManager() {
@@ -36,7 +38,7 @@ void NetworkManager::Shutdown() {
     std::cout << "ENet shutdown complete" << std::endl;
 }
 
-bool NetworkManager::StartServer(int port) {
+bool NetworkManager::StartServer(int port, std::size_t maxClients) {
     if (isServer || isConnected) {
         std::cerr << "Already running as server or connected as client" << std::endl;
         return false;
@@ -46,14 +48,22 @@ bool NetworkManager::StartServer(int port) {
     address.host = ENET_HOST_ANY;
     address.port = port;
     
-    host = enet_host_create(&address, 32, 2, 0, 0);
+    if (maxClients == 0 || maxClients > MaxClientsLimit) {
+        std::cerr << "Max clients must be between 1 and " << MaxClientsLimit << std::endl;
+        return false;
+    }
+    
+    host = enet_host_create(&address, maxClients, 2, 0, 0);
     if (host == nullptr) {
         std::cerr << "Failed to create server on port " << port << std::endl;
         return false;
     }
     
     isServer = true;
-    std::cout << "Server started on port " << port << std::endl;
+    ConfigureCompression();
+    CreateBatches();
+    telemetry.Reset();
+    std::cout << "Server started on port " << port << " (max " << maxClients << " clients)" << std::endl;
     return true;
 }
 
@@ -90,6 +100,9 @@ bool NetworkManager::ConnectToServer(const std::string& address, int port) {
         return false;
     }
     
+    ConfigureCompression();
+    CreateBatches();
+    telemetry.Reset();
     std::cout << "Connecting to " << address << ":" << port << "..." << std::endl;
     return true;
 }
@@ -121,27 +134,131 @@ void NetworkManager::Disconnect() {
     isConnected = false;
 }
 
-void NetworkManager::SendMessage(const std::string& message) {
-    if (!isConnected && !isServer) return;
+void NetworkManager::SetCompression(bool adaptive, bool rangeCoder) {
+    compressor.SetEnabled(adaptive);
+    useRangeCoder = rangeCoder;
+}
+
+void NetworkManager::ConfigureCompression() {
+    // The range coder works on whole datagrams, so it applies to every
+    // channel and both ends must enable it
+    if (useRangeCoder && enet_host_compress_with_range_coder(host) != 0) {
+        std::cerr << "Failed to enable ENet range coder compression" << std::endl;
+    }
     
-    ENetPacket* packet = enet_packet_create(
-        message.c_str(),
-        message.length() + 1,
-        ENET_PACKET_FLAG_RELIABLE
-    );
+    // Only the server trains a dictionary; its state broadcasts dominate.
+    // Nothing from an earlier server or client session carries over.
+    compressor.Reset();
+    compressor.SetDictionaryTraining(isServer && compressor.IsEnabled());
+    compressor.SetAcceptDictionaries(!isServer);
+}
+
+void NetworkManager::CreateBatches() {
+    // Budget each packet to the host MTU so a batch packet is one datagram
+    std::size_t overhead = MessageBatch::PacketOverheadBytes + PacketCompressor::MaxHeaderBytes;
+    std::size_t maxPacketBytes = host->mtu > overhead * 2
+        ? host->mtu - overhead
+        : MessageBatch::DefaultMaxPacketBytes;
+    
+    for (auto& batch : broadcastBatches) {
+        batch.Clear();
+        batch.SetMaxPacketBytes(maxPacketBytes);
+    }
+    peerBatches.assign(host->peerCount, ChannelBatches{});
+    for (auto& batches : peerBatches) {
+        for (auto& batch : batches) {
+            batch.SetMaxPacketBytes(maxPacketBytes);
+        }
+    }
+    peersWithQueuedMessages.clear();
+}
+
+void NetworkManager::QueueForPeer(ENetPeer* target, std::string_view message, MessageChannel channel) {
+    std::size_t index = static_cast<std::size_t>(target - host->peers);
+    ChannelBatches& batches = peerBatches[index];
+    
+    bool wasEmpty = batches[0].IsEmpty() && batches[1].IsEmpty();
+    if (!batches[static_cast<std::size_t>(channel)].Append(message)) {
+        std::cerr << "Message too long to send (" << message.size() << " bytes)" << std::endl;
+        return;
+    }
+    if (wasEmpty) {
+        peersWithQueuedMessages.push_back(static_cast<std::uint16_t>(index));
+    }
+    telemetry.RecordSent(message);
+}
+
+void NetworkManager::SendMessage(std::string_view message, MessageChannel channel) {
+    if (!isConnected && !isServer) return;
     
     if (isServer) {
         // Broadcast to all connected peers
-        enet_host_broadcast(host, 0, packet);
+        if (!broadcastBatches[static_cast<std::size_t>(channel)].Append(message)) {
+            std::cerr << "Message too long to send (" << message.size() << " bytes)" << std::endl;
+            return;
+        }
+        telemetry.RecordSent(message, host->connectedPeers);
     } else if (peer) {
         // Send to server
-        enet_peer_send(peer, 0, packet);
+        QueueForPeer(peer, message, channel);
+    }
+}
+
+void NetworkManager::SendMessageTo(ENetPeer* target, std::string_view message, MessageChannel channel) {
+    if (!isServer || target == nullptr || target->state != ENET_PEER_STATE_CONNECTED) return;
+    
+    QueueForPeer(target, message, channel);
+}
+
+void NetworkManager::Flush() {
+    if (!host) return;
+    
+    // A newly trained dictionary goes out ahead of the packets that use it
+    if (isServer && compressor.TakeDictionaryAnnouncement(dictionaryPacket)) {
+        ENetPacket* packet = enet_packet_create(dictionaryPacket.data(), dictionaryPacket.size(), ENET_PACKET_FLAG_RELIABLE);
+        if (packet != nullptr) {
+            enet_host_broadcast(host, static_cast<enet_uint8>(MessageChannel::Reliable), packet);
+        }
     }
+    
+    for (std::size_t channel = 0; channel < MessageChannelCount; channel++) {
+        MessageChannel messageChannel = static_cast<MessageChannel>(channel);
+        
+        // One packet per segment for all peers; ENet reference counts it
+        std::size_t copies = host->connectedPeers;
+        std::size_t packets = broadcastBatches[channel].Flush(messageChannel, compressor, [this, channel](ENetPacket* packet) {
+            enet_host_broadcast(host, static_cast<enet_uint8>(channel), packet);
+        });
+        telemetry.RecordPacketsSent(packets * copies);
+        
+        for (std::uint16_t index : peersWithQueuedMessages) {
+            ENetPeer* target = &host->peers[index];
+            packets = peerBatches[index][channel].Flush(messageChannel, compressor, [target, channel](ENetPacket* packet) {
+                if (enet_peer_send(target, static_cast<enet_uint8>(channel), packet) != 0) {
+                    enet_packet_destroy(packet);
+                }
+            });
+            telemetry.RecordPacketsSent(packets);
+        }
+    }
+    peersWithQueuedMessages.clear();
+    
+    enet_host_flush(host);
 }
 
-std::vector<NetworkMessage> NetworkManager::GetMessages() {
-    std::vector<NetworkMessage> messages;
-    std::swap(messages, messageQueue);
+std::pmr::vector<NetworkMessage> NetworkManager::GetMessages(std::pmr::memory_resource* resource) {
+    std::pmr::vector<NetworkMessage> messages(resource);
+    messages.reserve(messageQueue.size());
+    
+    for (const auto& pending : messageQueue) {
+        auto& msg = messages.emplace_back();
+        msg.data.assign(receiveBuffer.data() + pending.offset, pending.length);
+        msg.peer = pending.peer;
+    }
+    
+    // Keep capacity for the next frame
+    messageQueue.clear();
+    receiveBuffer.clear();
     return messages;
 }
 
@@ -149,6 +266,7 @@ void NetworkManager::Update() {
     if (!host) return;
     
     ProcessEvents();
+    telemetry.Sample(host);
 }
 
 void NetworkManager::ProcessEvents() {
@@ -161,6 +279,14 @@ void NetworkManager::ProcessEvents() {
                     std::cout << "Client connected from " 
                               << event.peer->address.host << ":" 
                               << event.peer->address.port << std::endl;
+                    
+                    // Late joiners need the current dictionary too
+                    if (compressor.BuildDictionaryPacket(dictionaryPacket)) {
+                        ENetPacket* packet = enet_packet_create(dictionaryPacket.data(), dictionaryPacket.size(), ENET_PACKET_FLAG_RELIABLE);
+                        if (packet != nullptr && enet_peer_send(event.peer, static_cast<enet_uint8>(MessageChannel::Reliable), packet) != 0) {
+                            enet_packet_destroy(packet);
+                        }
+                    }
                 } else {
                     std::cout << "Connected to server" << std::endl;
                     isConnected = true;
@@ -176,14 +302,32 @@ void NetworkManager::ProcessEvents() {
                     isConnected = false;
                 }
                 event.peer->data = nullptr;
+                
+                // Drop anything still queued for the departed peer
+                for (auto& batch : peerBatches[static_cast<std::size_t>(event.peer - host->peers)]) {
+                    batch.Clear();
+                }
                 break;
             }
             
             case ENET_EVENT_TYPE_RECEIVE: {
-                NetworkMessage msg;
-                msg.data = std::string((char*)event.packet->data);
-                msg.peer = event.peer;
-                messageQueue.push_back(msg);
+                // Every packet is a compressed batch of length-prefixed messages
+                const enet_uint8* data = nullptr;
+                std::size_t length = 0;
+                bool valid = compressor.Decode(event.packet->data, event.packet->dataLength, data, length)
+                    && MessageBatch::ForEachMessage(data, length,
+                    [this, &event](std::string_view payload) {
+                        PendingMessage msg;
+                        msg.offset = receiveBuffer.size();
+                        msg.length = payload.size();
+                        msg.peer = event.peer;
+                        receiveBuffer.insert(receiveBuffer.end(), payload.begin(), payload.end());
+                        messageQueue.push_back(msg);
+                        telemetry.RecordReceived(payload);
+                    });
+                if (!valid) {
+                    std::cerr << "Dropped malformed packet on channel " << static_cast<int>(event.channelID) << std::endl;
+                }
                 enet_packet_destroy(event.packet);
                 break;
             }
@@ -0,0 +1,407 @@
+#include "NetworkTelemetry.h"
+#include "MessageBatch.h"
+#include "PacketCompressor.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    // Round-trip time buckets in milliseconds
+    const std::array<double, RollingHistogram::BucketCount - 1> RttBounds = {
+        1.0, 2.0, 5.0, 10.0, 20.0, 35.0, 50.0, 75.0, 100.0, 200.0, 500.0
+    };
+
+    double SecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return std::chrono::duration<double>(to - from).count();
+    }
+
+    // Message type names come from the network, so escape them for JSON
+    std::string JsonEscape(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                result += escaped;
+            } else {
+                result += c;
+            }
+        }
+        return result;
+    }
+}
+
+RollingHistogram::RollingHistogram(const std::array<double, BucketCount - 1>& bounds)
+    : bounds(bounds) {
+}
+
+void RollingHistogram::Add(double value) {
+    std::size_t bucket = std::upper_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    Slice& slice = slices[currentSecond % SliceCount];
+    slice.buckets[bucket]++;
+    slice.max = std::max(slice.max, value);
+}
+
+void RollingHistogram::Advance(std::uint64_t second) {
+    if (second <= currentSecond) return;
+
+    // Clear every slice skipped over, but never more than the whole window
+    std::uint64_t steps = std::min<std::uint64_t>(second - currentSecond, SliceCount);
+    for (std::uint64_t i = 1; i <= steps; i++) {
+        slices[(currentSecond + i) % SliceCount] = Slice{};
+    }
+    currentSecond = second;
+}
+
+void RollingHistogram::Clear() {
+    slices.fill(Slice{});
+    // Telemetry restarts its clock on reset, so later seconds start from 0 again
+    currentSecond = 0;
+}
+
+std::array<std::uint64_t, RollingHistogram::BucketCount> RollingHistogram::GetBuckets() const {
+    std::array<std::uint64_t, BucketCount> total{};
+    for (const auto& slice : slices) {
+        for (std::size_t i = 0; i < BucketCount; i++) {
+            total[i] += slice.buckets[i];
+        }
+    }
+    return total;
+}
+
+std::uint64_t RollingHistogram::GetCount() const {
+    std::uint64_t count = 0;
+    for (auto bucket : GetBuckets()) {
+        count += bucket;
+    }
+    return count;
+}
+
+double RollingHistogram::GetMax() const {
+    double max = 0.0;
+    for (const auto& slice : slices) {
+        max = std::max(max, slice.max);
+    }
+    return max;
+}
+
+double RollingHistogram::GetPercentile(double fraction) const {
+    auto buckets = GetBuckets();
+    std::uint64_t count = 0;
+    for (auto bucket : buckets) {
+        count += bucket;
+    }
+    if (count == 0) return 0.0;
+
+    std::uint64_t target = static_cast<std::uint64_t>(fraction * count);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BucketCount - 1; i++) {
+        seen += buckets[i];
+        if (seen > target) {
+            return bounds[i];
+        }
+    }
+    return GetMax();
+}
+
+NetworkTelemetry::PeerStats::PeerStats()
+    : rttHistogram(RttBounds) {
+}
+
+NetworkTelemetry::NetworkTelemetry()
+    : rttHistogram(RttBounds) {
+    Reset();
+}
+
+void NetworkTelemetry::Reset() {
+    peers.clear();
+    messageTypes.clear();
+    rttHistogram.Clear();
+    connectedPeers = 0;
+    packetsSent = 0;
+    startTime = std::chrono::steady_clock::now();
+    lastSampleTime = startTime;
+    rateWindowStart = startTime;
+    lastDumpTime = startTime;
+}
+
+NetworkTelemetry::MessageTypeStats& NetworkTelemetry::FindMessageType(std::string_view message) {
+    std::string_view type = message.substr(0, std::min(message.find(':'), std::size_t(16)));
+    for (auto& stats : messageTypes) {
+        if (stats.type == type) {
+            return stats;
+        }
+    }
+
+    // Type names come from the network, so unknown ones share one entry once the table is full
+    if (messageTypes.size() >= MaxMessageTypes - 1) {
+        type = "(other)";
+        for (auto& stats : messageTypes) {
+            if (stats.type == type) {
+                return stats;
+            }
+        }
+    }
+
+    auto& stats = messageTypes.emplace_back();
+    stats.type.assign(type.data(), type.size());
+    return stats;
+}
+
+void NetworkTelemetry::RecordSent(std::string_view message, std::size_t copies) {
+    if (copies == 0) return;
+    MessageTypeStats& stats = FindMessageType(message);
+    stats.sentCount += copies;
+    // Each message carries a length prefix inside its batch packet
+    stats.sentBytes += (message.size() + MessageBatch::LengthPrefixBytes) * copies;
+}
+
+void NetworkTelemetry::RecordReceived(std::string_view message) {
+    MessageTypeStats& stats = FindMessageType(message);
+    stats.receivedCount++;
+    stats.receivedBytes += message.size() + MessageBatch::LengthPrefixBytes;
+}
+
+std::uint64_t NetworkTelemetry::GetMessagesSent() const {
+    std::uint64_t messages = 0;
+    for (const auto& stats : messageTypes) {
+        messages += stats.sentCount;
+    }
+    return messages;
+}
+
+void NetworkTelemetry::Sample(ENetHost* host) {
+    if (!host) return;
+
+    auto now = std::chrono::steady_clock::now();
+    std::uint64_t second = static_cast<std::uint64_t>(SecondsBetween(startTime, now));
+    double elapsed = SecondsBetween(lastSampleTime, now);
+    lastSampleTime = now;
+
+    if (peers.size() < host->peerCount) {
+        peers.resize(host->peerCount);
+    }
+
+    rttHistogram.Advance(second);
+    connectedPeers = 0;
+
+    for (std::size_t i = 0; i < host->peerCount; i++) {
+        ENetPeer& peer = host->peers[i];
+        PeerStats& stats = peers[i];
+
+        if (peer.state != ENET_PEER_STATE_CONNECTED) {
+            stats.connected = false;
+            continue;
+        }
+
+        // A new connection in this slot starts from scratch
+        if (!stats.connected || stats.connectId != peer.connectID) {
+            stats = PeerStats();
+            stats.connected = true;
+            stats.peerId = peer.incomingPeerID;
+            stats.connectId = peer.connectID;
+            stats.lastOutgoingDataTotal = peer.outgoingDataTotal;
+            stats.lastIncomingDataTotal = peer.incomingDataTotal;
+
+            char ip[64];
+            if (enet_address_get_host_ip(&peer.address, ip, sizeof(ip)) == 0) {
+                stats.address = std::string(ip) + ":" + std::to_string(peer.address.port);
+            }
+        } else {
+            stats.connectedSeconds += elapsed;
+        }
+        connectedPeers++;
+
+        stats.roundTripTime = peer.roundTripTime;
+        stats.roundTripTimeVariance = peer.roundTripTimeVariance;
+        stats.packetLoss = static_cast<float>(peer.packetLoss) / ENET_PEER_PACKET_LOSS_SCALE;
+        stats.packetThrottle = static_cast<float>(peer.packetThrottle) / ENET_PEER_PACKET_THROTTLE_SCALE;
+        stats.reliableInFlight = static_cast<std::uint32_t>(enet_list_size(&peer.sentReliableCommands));
+        stats.outgoingQueued = static_cast<std::uint32_t>(enet_list_size(&peer.outgoingCommands));
+        stats.reliableBytesInTransit = peer.reliableDataInTransit;
+
+        // ENet zeroes the data totals once per bandwidth throttle interval
+        std::uint32_t outgoing = peer.outgoingDataTotal;
+        std::uint32_t incoming = peer.incomingDataTotal;
+        stats.bytesSent += outgoing >= stats.lastOutgoingDataTotal ? outgoing - stats.lastOutgoingDataTotal : outgoing;
+        stats.bytesReceived += incoming >= stats.lastIncomingDataTotal ? incoming - stats.lastIncomingDataTotal : incoming;
+        stats.lastOutgoingDataTotal = outgoing;
+        stats.lastIncomingDataTotal = incoming;
+
+        stats.rttHistogram.Advance(second);
+        stats.rttHistogram.Add(peer.roundTripTime);
+        rttHistogram.Add(peer.roundTripTime);
+    }
+
+    double windowSeconds = SecondsBetween(rateWindowStart, now);
+    if (windowSeconds >= 1.0) {
+        UpdateRates(windowSeconds);
+        rateWindowStart = now;
+    }
+
+    if (dumpIntervalSeconds > 0.0 && SecondsBetween(lastDumpTime, now) >= dumpIntervalSeconds) {
+        Dump();
+        lastDumpTime = now;
+    }
+}
+
+void NetworkTelemetry::UpdateRates(double seconds) {
+    for (auto& stats : peers) {
+        if (!stats.connected) continue;
+        stats.sendBytesPerSecond = (stats.bytesSent - stats.windowBytesSent) / seconds;
+        stats.receiveBytesPerSecond = (stats.bytesReceived - stats.windowBytesReceived) / seconds;
+        stats.windowBytesSent = stats.bytesSent;
+        stats.windowBytesReceived = stats.bytesReceived;
+    }
+    for (auto& stats : messageTypes) {
+        stats.sendBytesPerSecond = (stats.sentBytes - stats.windowSentBytes) / seconds;
+        stats.receiveBytesPerSecond = (stats.receivedBytes - stats.windowReceivedBytes) / seconds;
+        stats.windowSentBytes = stats.sentBytes;
+        stats.windowReceivedBytes = stats.receivedBytes;
+    }
+}
+
+std::vector<const NetworkTelemetry::PeerStats*> NetworkTelemetry::GetWorstPeers(std::size_t count) const {
+    std::vector<const PeerStats*> result;
+    for (const auto& stats : peers) {
+        if (stats.connected) {
+            result.push_back(&stats);
+        }
+    }
+
+    auto worse = [](const PeerStats* a, const PeerStats* b) {
+        if (a->packetLoss != b->packetLoss) return a->packetLoss > b->packetLoss;
+        return a->roundTripTime > b->roundTripTime;
+    };
+    count = std::min(count, result.size());
+    std::partial_sort(result.begin(), result.begin() + count, result.end(), worse);
+    result.resize(count);
+    return result;
+}
+
+void NetworkTelemetry::SetDumpTarget(const std::string& basePath, double intervalSeconds) {
+    dumpBasePath = basePath;
+    dumpIntervalSeconds = basePath.empty() ? 0.0 : intervalSeconds;
+    lastDumpTime = std::chrono::steady_clock::now();
+}
+
+void NetworkTelemetry::Dump() {
+    WriteCsv(dumpBasePath + ".csv");
+    WriteJson(dumpBasePath + ".json");
+}
+
+bool NetworkTelemetry::WriteCsv(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to write network telemetry to " << path << std::endl;
+        return false;
+    }
+
+    // Two tables: one row per connected peer, then one per message type
+    file << "peer,address,connected_s,rtt_ms,rtt_variance_ms,rtt_p50_ms,rtt_p99_ms,packet_loss,throttle,"
+            "reliable_in_flight,outgoing_queued,reliable_bytes_in_transit,bytes_sent,bytes_received,send_Bps,receive_Bps\n";
+    for (const auto& stats : peers) {
+        if (!stats.connected) continue;
+        file << stats.peerId << ',' << stats.address << ',' << stats.connectedSeconds << ','
+             << stats.roundTripTime << ',' << stats.roundTripTimeVariance << ','
+             << stats.rttHistogram.GetPercentile(0.5) << ',' << stats.rttHistogram.GetPercentile(0.99) << ','
+             << stats.packetLoss << ',' << stats.packetThrottle << ','
+             << stats.reliableInFlight << ',' << stats.outgoingQueued << ',' << stats.reliableBytesInTransit << ','
+             << stats.bytesSent << ',' << stats.bytesReceived << ','
+             << stats.sendBytesPerSecond << ',' << stats.receiveBytesPerSecond << '\n';
+    }
+
+    file << "\ntype,sent_count,sent_bytes,received_count,received_bytes,send_Bps,receive_Bps\n";
+    for (const auto& stats : messageTypes) {
+        file << stats.type << ',' << stats.sentCount << ',' << stats.sentBytes << ','
+             << stats.receivedCount << ',' << stats.receivedBytes << ','
+             << stats.sendBytesPerSecond << ',' << stats.receiveBytesPerSecond << '\n';
+    }
+
+    if (compressor != nullptr) {
+        file << "\nchannel,packets,raw_bytes,wire_bytes,raw_packets,lz_packets,lz_dict_packets,selected,encode_us\n";
+        for (std::size_t channel = 0; channel < MessageChannelCount; channel++) {
+            const auto& stats = compressor->GetStats(static_cast<MessageChannel>(channel));
+            file << channel << ',' << stats.packets << ',' << stats.rawBytes << ',' << stats.wireBytes << ','
+                 << stats.packetsByCodec[0] << ',' << stats.packetsByCodec[1] << ',' << stats.packetsByCodec[2] << ','
+                 << PacketCompressor::GetCodecName(stats.selected) << ',' << stats.encodeMicroseconds << '\n';
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+bool NetworkTelemetry::WriteJson(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to write network telemetry to " << path << std::endl;
+        return false;
+    }
+
+    file << "{\n  \"connectedPeers\": " << connectedPeers << ",\n";
+
+    file << "  \"rttHistogram\": {\"boundsMs\": [";
+    const auto& bounds = rttHistogram.GetBounds();
+    for (std::size_t i = 0; i < bounds.size(); i++) {
+        file << (i ? ", " : "") << bounds[i];
+    }
+    file << "], \"counts\": [";
+    auto buckets = rttHistogram.GetBuckets();
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+        file << (i ? ", " : "") << buckets[i];
+    }
+    file << "], \"maxMs\": " << rttHistogram.GetMax() << "},\n";
+
+    file << "  \"peers\": [";
+    bool first = true;
+    for (const auto& stats : peers) {
+        if (!stats.connected) continue;
+        file << (first ? "\n" : ",\n")
+             << "    {\"peer\": " << stats.peerId << ", \"address\": \"" << stats.address << "\""
+             << ", \"connectedSeconds\": " << stats.connectedSeconds
+             << ", \"rttMs\": " << stats.roundTripTime << ", \"rttVarianceMs\": " << stats.roundTripTimeVariance
+             << ", \"rttP50Ms\": " << stats.rttHistogram.GetPercentile(0.5)
+             << ", \"rttP99Ms\": " << stats.rttHistogram.GetPercentile(0.99)
+             << ", \"packetLoss\": " << stats.packetLoss << ", \"throttle\": " << stats.packetThrottle
+             << ", \"reliableInFlight\": " << stats.reliableInFlight << ", \"outgoingQueued\": " << stats.outgoingQueued
+             << ", \"reliableBytesInTransit\": " << stats.reliableBytesInTransit
+             << ", \"bytesSent\": " << stats.bytesSent << ", \"bytesReceived\": " << stats.bytesReceived
+             << ", \"sendBytesPerSecond\": " << stats.sendBytesPerSecond
+             << ", \"receiveBytesPerSecond\": " << stats.receiveBytesPerSecond << "}";
+        first = false;
+    }
+    file << (first ? "],\n" : "\n  ],\n");
+
+    file << "  \"messageTypes\": [";
+    for (std::size_t i = 0; i < messageTypes.size(); i++) {
+        const auto& stats = messageTypes[i];
+        file << (i ? ",\n" : "\n")
+             << "    {\"type\": \"" << JsonEscape(stats.type) << "\""
+             << ", \"sentCount\": " << stats.sentCount << ", \"sentBytes\": " << stats.sentBytes
+             << ", \"receivedCount\": " << stats.receivedCount << ", \"receivedBytes\": " << stats.receivedBytes
+             << ", \"sendBytesPerSecond\": " << stats.sendBytesPerSecond
+             << ", \"receiveBytesPerSecond\": " << stats.receiveBytesPerSecond << "}";
+    }
+    file << (messageTypes.empty() ? "]" : "\n  ]");
+
+    if (compressor != nullptr) {
+        file << ",\n  \"compression\": [";
+        for (std::size_t channel = 0; channel < MessageChannelCount; channel++) {
+            const auto& stats = compressor->GetStats(static_cast<MessageChannel>(channel));
+            file << (channel ? ",\n" : "\n")
+                 << "    {\"channel\": " << channel << ", \"packets\": " << stats.packets
+                 << ", \"rawBytes\": " << stats.rawBytes << ", \"wireBytes\": " << stats.wireBytes
+                 << ", \"packetsByCodec\": {\"raw\": " << stats.packetsByCodec[0] << ", \"lz\": " << stats.packetsByCodec[1]
+                 << ", \"lzDict\": " << stats.packetsByCodec[2] << "}"
+                 << ", \"selected\": \"" << PacketCompressor::GetCodecName(stats.selected) << "\""
+                 << ", \"encodeMicroseconds\": " << stats.encodeMicroseconds << "}";
+        }
+        file << "\n  ],\n  \"decodeMicroseconds\": " << compressor->GetDecodeMicroseconds()
+             << ",\n  \"decodeFailures\": " << compressor->GetDecodeFailures();
+    }
+    file << "\n}\n";
+    return static_cast<bool>(file);
+}
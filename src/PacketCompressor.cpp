@@ -0,0 +1,455 @@
+#include "PacketCompressor.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    constexpr std::size_t MinMatchBytes = 4;
+    constexpr std::size_t MaxOffset = 0xFFFF;
+    constexpr std::size_t HashBits = 12;
+    constexpr std::uint32_t EmptySlot = std::numeric_limits<std::uint32_t>::max();
+
+    // Weight of a new measurement in the smoothed ratio and cost
+    constexpr double SmoothingFactor = 0.25;
+
+    // Dictionary training: substrings are scored in 8-byte shingles and
+    // copied into the dictionary in 32-byte segments
+    constexpr std::size_t ShingleBytes = 8;
+    constexpr std::size_t SegmentBytes = 32;
+
+    std::uint32_t Read32(const enet_uint8* data) {
+        std::uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    std::uint64_t Read64(const enet_uint8* data) {
+        std::uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    std::size_t HashPosition(const enet_uint8* data) {
+        return (Read32(data) * 2654435761u) >> (32 - HashBits);
+    }
+
+    void WriteLengthExtension(std::vector<enet_uint8>& out, std::size_t length) {
+        while (length >= 255) {
+            out.push_back(255);
+            length -= 255;
+        }
+        out.push_back(static_cast<enet_uint8>(length));
+    }
+
+    bool ReadLengthExtension(const enet_uint8* data, std::size_t length, std::size_t& offset, std::size_t& value) {
+        enet_uint8 byte;
+        do {
+            if (offset >= length) return false;
+            byte = data[offset++];
+            value += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    void WriteSequence(std::vector<enet_uint8>& out, const enet_uint8* literals, std::size_t literalLength,
+                       std::size_t offset, std::size_t matchLength) {
+        std::size_t matchCode = matchLength ? matchLength - MinMatchBytes : 0;
+        out.push_back(static_cast<enet_uint8>((std::min<std::size_t>(literalLength, 15) << 4) |
+                                              std::min<std::size_t>(matchCode, 15)));
+        if (literalLength >= 15) WriteLengthExtension(out, literalLength - 15);
+        out.insert(out.end(), literals, literals + literalLength);
+
+        if (matchLength == 0) return;
+        out.push_back(static_cast<enet_uint8>(offset & 0xFF));
+        out.push_back(static_cast<enet_uint8>((offset >> 8) & 0xFF));
+        if (matchCode >= 15) WriteLengthExtension(out, matchCode - 15);
+    }
+
+    void WriteU32(std::vector<enet_uint8>& out, std::uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(static_cast<enet_uint8>((value >> shift) & 0xFF));
+        }
+    }
+
+    std::uint32_t ReadU32(const enet_uint8* data) {
+        return static_cast<std::uint32_t>(data[0]) | static_cast<std::uint32_t>(data[1]) << 8 |
+               static_cast<std::uint32_t>(data[2]) << 16 | static_cast<std::uint32_t>(data[3]) << 24;
+    }
+
+    double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+PacketCompressor::PacketCompressor() {
+    Reset();
+}
+
+void PacketCompressor::Reset() {
+    for (auto& stats : channels) {
+        stats = ChannelStats{};
+        stats.ratio[static_cast<std::size_t>(Codec::Raw)] = 1.0;
+    }
+    packetsSinceProbe.fill(0);
+
+    samples.clear();
+    dictionary.clear();
+    dictionaryId = 0;
+    announcementPending = false;
+    for (auto& remote : remoteDictionaries) {
+        remote.clear();
+    }
+
+    decodeFailures = 0;
+    decodeMicroseconds = 0.0;
+}
+
+const char* PacketCompressor::GetCodecName(Codec codec) {
+    switch (codec) {
+        case Codec::Raw: return "raw";
+        case Codec::Lz: return "lz";
+        case Codec::LzDictionary: return "lz+dict";
+        case Codec::Dictionary: return "dict";
+    }
+    return "unknown";
+}
+
+void PacketCompressor::Encode(MessageChannel channel, const char* data, std::size_t length, std::vector<enet_uint8>& out) {
+    std::size_t channelIndex = static_cast<std::size_t>(channel);
+    ChannelStats& stats = channels[channelIndex];
+
+    if (trainDictionary && channel == MessageChannel::State && dictionary.empty()) {
+        CollectSample(data, length);
+    }
+
+    Codec codec = Codec::Raw;
+    std::size_t size = 0;
+    if (enabled && length >= MinCompressBytes) {
+        bool dictionaryUsable = channel == MessageChannel::State && !dictionary.empty() &&
+                                std::chrono::steady_clock::now() >= dictionaryUsableAt;
+
+        if (packetsSinceProbe[channelIndex]++ % ProbeInterval == 0) {
+            // Measure every codec on this packet and send the smallest output
+            size = EncodeWith(Codec::Raw, data, length, out);
+            for (Codec tried : {Codec::Lz, Codec::LzDictionary}) {
+                if (tried == Codec::LzDictionary && !dictionaryUsable) continue;
+
+                auto start = std::chrono::steady_clock::now();
+                std::size_t triedSize = EncodeWith(tried, data, length, candidate);
+                double micros = MicrosecondsSince(start);
+                stats.encodeMicroseconds += micros;
+
+                std::size_t index = static_cast<std::size_t>(tried);
+                double ratio = static_cast<double>(triedSize) / static_cast<double>(length + 1);
+                double cost = micros * 1000.0 / static_cast<double>(length);
+                bool firstSample = stats.ratio[index] == 0.0;
+                stats.ratio[index] = firstSample ? ratio : stats.ratio[index] + SmoothingFactor * (ratio - stats.ratio[index]);
+                stats.nanosecondsPerByte[index] = firstSample ? cost
+                    : stats.nanosecondsPerByte[index] + SmoothingFactor * (cost - stats.nanosecondsPerByte[index]);
+
+                if (triedSize < size) {
+                    out.swap(candidate);
+                    size = triedSize;
+                    codec = tried;
+                }
+            }
+
+            // Cheapest codec by size plus weighted CPU cost from here on
+            double bestScore = stats.ratio[static_cast<std::size_t>(Codec::Raw)];
+            stats.selected = Codec::Raw;
+            for (Codec option : {Codec::Lz, Codec::LzDictionary}) {
+                std::size_t index = static_cast<std::size_t>(option);
+                if (stats.ratio[index] == 0.0 || (option == Codec::LzDictionary && !dictionaryUsable)) continue;
+                double score = stats.ratio[index] + cpuWeight * stats.nanosecondsPerByte[index];
+                if (score < bestScore) {
+                    bestScore = score;
+                    stats.selected = option;
+                }
+            }
+        } else if (stats.selected != Codec::Raw) {
+            auto start = std::chrono::steady_clock::now();
+            size = EncodeWith(stats.selected, data, length, out);
+            stats.encodeMicroseconds += MicrosecondsSince(start);
+            codec = stats.selected;
+
+            // Incompressible packet: raw is never more than one byte over
+            if (size > length + 1) {
+                codec = Codec::Raw;
+                size = 0;
+            }
+        }
+    }
+
+    if (size == 0) {
+        size = EncodeWith(Codec::Raw, data, length, out);
+    }
+
+    stats.packets++;
+    stats.rawBytes += length;
+    stats.wireBytes += size;
+    stats.packetsByCodec[static_cast<std::size_t>(codec)]++;
+}
+
+std::size_t PacketCompressor::EncodeWith(Codec codec, const char* data, std::size_t length, std::vector<enet_uint8>& out) {
+    const enet_uint8* bytes = reinterpret_cast<const enet_uint8*>(data);
+    out.clear();
+    out.push_back(static_cast<enet_uint8>(codec));
+
+    switch (codec) {
+        case Codec::Raw:
+            out.insert(out.end(), bytes, bytes + length);
+            break;
+
+        case Codec::Lz:
+            WriteU32(out, static_cast<std::uint32_t>(length));
+            CompressBlock(bytes, 0, length, out, hashTable);
+            break;
+
+        case Codec::LzDictionary:
+            // Compress the payload as if it followed the dictionary, so early
+            // matches can reach back into dictionary content
+            out.push_back(dictionaryId);
+            WriteU32(out, static_cast<std::uint32_t>(length));
+            window.assign(dictionary.begin(), dictionary.end());
+            window.insert(window.end(), bytes, bytes + length);
+            CompressBlock(window.data(), dictionary.size(), window.size(), out, hashTable);
+            break;
+
+        case Codec::Dictionary:
+            break;
+    }
+    return out.size();
+}
+
+bool PacketCompressor::Decode(const enet_uint8* data, std::size_t length, const enet_uint8*& payload, std::size_t& payloadLength) {
+    payload = nullptr;
+    payloadLength = 0;
+    if (length == 0) {
+        decodeFailures++;
+        return false;
+    }
+
+    switch (static_cast<Codec>(data[0])) {
+        case Codec::Raw:
+            payload = data + 1;
+            payloadLength = length - 1;
+            return true;
+
+        case Codec::Lz: {
+            std::size_t rawSize = length >= 5 ? ReadU32(data + 1) : MaxDecodedBytes + 1;
+            if (rawSize > MaxDecodedBytes) break;
+
+            auto start = std::chrono::steady_clock::now();
+            decoded.clear();
+            bool valid = DecompressBlock(data + 5, length - 5, decoded, rawSize);
+            decodeMicroseconds += MicrosecondsSince(start);
+            if (!valid) break;
+
+            payload = decoded.data();
+            payloadLength = decoded.size();
+            return true;
+        }
+
+        case Codec::LzDictionary: {
+            if (length < 6) break;
+            const std::vector<enet_uint8>& remote = remoteDictionaries[data[1]];
+            std::size_t rawSize = ReadU32(data + 2);
+            if (remote.empty() || rawSize > MaxDecodedBytes) break;
+
+            auto start = std::chrono::steady_clock::now();
+            decoded.assign(remote.begin(), remote.end());
+            bool valid = DecompressBlock(data + 6, length - 6, decoded, remote.size() + rawSize);
+            decodeMicroseconds += MicrosecondsSince(start);
+            if (!valid) break;
+
+            payload = decoded.data() + remote.size();
+            payloadLength = rawSize;
+            return true;
+        }
+
+        case Codec::Dictionary:
+            if (!acceptDictionaries || length < 2) break;
+            remoteDictionaries[data[1]].assign(data + 2, data + length);
+            std::cout << "Received " << (length - 2) << " byte compression dictionary " << static_cast<int>(data[1]) << std::endl;
+            return true;
+    }
+
+    decodeFailures++;
+    return false;
+}
+
+bool PacketCompressor::TakeDictionaryAnnouncement(std::vector<enet_uint8>& out) {
+    if (!announcementPending) return false;
+    announcementPending = false;
+    return BuildDictionaryPacket(out);
+}
+
+bool PacketCompressor::BuildDictionaryPacket(std::vector<enet_uint8>& out) const {
+    if (dictionary.empty()) return false;
+
+    out.clear();
+    out.push_back(static_cast<enet_uint8>(Codec::Dictionary));
+    out.push_back(dictionaryId);
+    out.insert(out.end(), dictionary.begin(), dictionary.end());
+    return true;
+}
+
+void PacketCompressor::CollectSample(const char* data, std::size_t length) {
+    const enet_uint8* bytes = reinterpret_cast<const enet_uint8*>(data);
+    samples.emplace_back(bytes, bytes + length);
+    if (samples.size() < TrainingSampleCount) return;
+
+    dictionary = TrainDictionary(samples, DictionaryCapacity);
+    samples.clear();
+    samples.shrink_to_fit();
+    if (dictionary.empty()) {
+        // Nothing recurs across packets; don't keep sampling
+        trainDictionary = false;
+        return;
+    }
+
+    dictionaryId++;
+    announcementPending = true;
+    dictionaryUsableAt = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    std::cout << "Trained " << dictionary.size() << " byte compression dictionary from "
+              << TrainingSampleCount << " state packets" << std::endl;
+}
+
+std::vector<enet_uint8> PacketCompressor::TrainDictionary(const std::vector<std::vector<enet_uint8>>& samples, std::size_t capacity) {
+    // Count how many samples each shingle appears in
+    std::unordered_map<std::uint64_t, std::uint32_t> frequency;
+    std::unordered_set<std::uint64_t> seen;
+    for (const auto& sample : samples) {
+        if (sample.size() < SegmentBytes) continue;
+        seen.clear();
+        for (std::size_t i = 0; i + ShingleBytes <= sample.size(); i++) {
+            std::uint64_t shingle = Read64(sample.data() + i);
+            if (seen.insert(shingle).second) {
+                frequency[shingle]++;
+            }
+        }
+    }
+
+    // Repeatedly take the best scoring segment, then zero its shingles so the
+    // next pick covers different content
+    std::vector<std::vector<enet_uint8>> segments;
+    std::size_t totalBytes = 0;
+    constexpr std::size_t ShinglesPerSegment = SegmentBytes - ShingleBytes + 1;
+    while (totalBytes + SegmentBytes <= capacity) {
+        std::uint64_t bestScore = 0;
+        const enet_uint8* bestSegment = nullptr;
+
+        for (const auto& sample : samples) {
+            if (sample.size() < SegmentBytes) continue;
+
+            // Sliding sum of shingle counts over each segment-sized window
+            std::uint64_t score = 0;
+            for (std::size_t i = 0; i + ShingleBytes <= sample.size(); i++) {
+                auto found = frequency.find(Read64(sample.data() + i));
+                score += found != frequency.end() ? found->second : 0;
+                if (i >= ShinglesPerSegment) {
+                    auto leaving = frequency.find(Read64(sample.data() + i - ShinglesPerSegment));
+                    score -= leaving != frequency.end() ? leaving->second : 0;
+                }
+                if (i + 1 >= ShinglesPerSegment && score > bestScore) {
+                    bestScore = score;
+                    bestSegment = sample.data() + i + 1 - ShinglesPerSegment;
+                }
+            }
+        }
+
+        // A segment only helps if its content shows up in other packets
+        if (bestSegment == nullptr || bestScore < ShinglesPerSegment * 2) break;
+
+        segments.emplace_back(bestSegment, bestSegment + SegmentBytes);
+        totalBytes += SegmentBytes;
+        for (std::size_t i = 0; i < ShinglesPerSegment; i++) {
+            frequency[Read64(bestSegment + i)] = 0;
+        }
+    }
+
+    // Best segments last, closest to the payload that references them
+    std::vector<enet_uint8> result;
+    result.reserve(totalBytes);
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        result.insert(result.end(), it->begin(), it->end());
+    }
+    return result;
+}
+
+std::size_t PacketCompressor::CompressBlock(const enet_uint8* window, std::size_t start, std::size_t end,
+                                            std::vector<enet_uint8>& out, std::vector<std::uint32_t>& hashTable) {
+    std::size_t initialSize = out.size();
+    hashTable.assign(std::size_t(1) << HashBits, EmptySlot);
+
+    // Index the prefix (dictionary) so matches can start there
+    std::size_t indexFrom = start > MaxOffset ? start - MaxOffset : 0;
+    for (std::size_t position = indexFrom; position + MinMatchBytes <= start; position++) {
+        hashTable[HashPosition(window + position)] = static_cast<std::uint32_t>(position);
+    }
+
+    std::size_t anchor = start;
+    std::size_t position = start;
+    while (position + MinMatchBytes <= end) {
+        std::size_t slot = HashPosition(window + position);
+        std::uint32_t candidate = hashTable[slot];
+        hashTable[slot] = static_cast<std::uint32_t>(position);
+
+        if (candidate == EmptySlot || position - candidate > MaxOffset ||
+            Read32(window + candidate) != Read32(window + position)) {
+            position++;
+            continue;
+        }
+
+        std::size_t matchLength = MinMatchBytes;
+        while (position + matchLength < end && window[candidate + matchLength] == window[position + matchLength]) {
+            matchLength++;
+        }
+
+        WriteSequence(out, window + anchor, position - anchor, position - candidate, matchLength);
+        position += matchLength;
+        anchor = position;
+    }
+
+    if (anchor < end) {
+        WriteSequence(out, window + anchor, end - anchor, 0, 0);
+    }
+    return out.size() - initialSize;
+}
+
+bool PacketCompressor::DecompressBlock(const enet_uint8* data, std::size_t length, std::vector<enet_uint8>& out,
+                                       std::size_t expectedEnd) {
+    out.reserve(expectedEnd);
+    std::size_t offset = 0;
+    while (offset < length) {
+        enet_uint8 token = data[offset++];
+
+        std::size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLengthExtension(data, length, offset, literalLength)) return false;
+        if (length - offset < literalLength || expectedEnd - out.size() < literalLength) return false;
+        out.insert(out.end(), data + offset, data + offset + literalLength);
+        offset += literalLength;
+
+        // The last sequence carries literals only
+        if (offset == length) break;
+
+        if (length - offset < 2) return false;
+        std::size_t matchOffset = static_cast<std::size_t>(data[offset]) | static_cast<std::size_t>(data[offset + 1]) << 8;
+        offset += 2;
+        std::size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !ReadLengthExtension(data, length, offset, matchLength)) return false;
+        matchLength += MinMatchBytes;
+
+        if (matchOffset == 0 || matchOffset > out.size() || expectedEnd - out.size() < matchLength) return false;
+
+        // Byte by byte: the source may overlap what is being written
+        std::size_t from = out.size() - matchOffset;
+        for (std::size_t i = 0; i < matchLength; i++) {
+            out.push_back(out[from + i]);
+        }
+    }
+    return out.size() == expectedEnd;
+}
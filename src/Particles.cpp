@@ -0,0 +1,282 @@
+#include "Particles.h"
+#include "ECS.h"
+#include "RenderFrame.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLES_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // xorshift32: particles are visual only, so they keep the game's RNG untouched
+    float RandomRange(std::uint32_t& state, float low, float high) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return low + (high - low) * static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    unsigned char LerpChannel(unsigned char from, unsigned char to, float t) {
+        return static_cast<unsigned char>(from + (static_cast<float>(to) - from) * t);
+    }
+}
+
+ParticleSystem::~ParticleSystem() {
+    // Textures must be released with the GL context; see unloadTextures()
+}
+
+bool ParticleSystem::usesSimd() {
+#ifdef PARTICLES_USE_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::uint32_t ParticleSystem::createEmitter(const EmitterConfig& config, Vector2 position) {
+    emitters.emplace_back();
+    Emitter& emitter = emitters.back();
+    emitter.config = config;
+    emitter.position = position;
+    emitter.randomState = 0x9E3779B9u ^ static_cast<std::uint32_t>(emitters.size() * 2654435761u);
+
+    // Every array is allocated once, at the full padded capacity
+    std::size_t padded = (config.capacity + 3) & ~static_cast<std::size_t>(3);
+    emitter.positionX.assign(padded, 0.0f);
+    emitter.positionY.assign(padded, 0.0f);
+    emitter.velocityX.assign(padded, 0.0f);
+    emitter.velocityY.assign(padded, 0.0f);
+    emitter.remaining.assign(padded, 0.0f);
+    emitter.inverseLife.assign(padded, 1.0f);
+    emitter.size.assign(padded, 0.0f);
+    stats.emitters = emitters.size();
+    return static_cast<std::uint32_t>(emitters.size() - 1);
+}
+
+void ParticleSystem::setPosition(std::uint32_t emitter, Vector2 position) {
+    if (emitter < emitters.size()) {
+        emitters[emitter].position = position;
+    }
+}
+
+void ParticleSystem::attach(std::uint32_t emitter, entt::entity entity, Vector2 offset) {
+    if (emitter < emitters.size()) {
+        emitters[emitter].attached = entity;
+        emitters[emitter].offset = offset;
+    }
+}
+
+void ParticleSystem::setActive(std::uint32_t emitter, bool active) {
+    if (emitter < emitters.size()) {
+        emitters[emitter].active = active;
+    }
+}
+
+void ParticleSystem::burst(std::uint32_t emitter, std::size_t count) {
+    if (emitter < emitters.size()) {
+        emitters[emitter].pendingBurst += count;
+    }
+}
+
+void ParticleSystem::update(entt::registry& registry, float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+    stats.emitters = emitters.size();
+    stats.alive = 0;
+    stats.capacity = 0;
+    stats.spawned = 0;
+    stats.dropped = 0;
+
+    for (Emitter& emitter : emitters) {
+        // Follow the attached entity while it exists
+        bool following = emitter.attached != entt::null;
+        if (following && registry.valid(emitter.attached)) {
+            if (const ECSTransform* transform = registry.try_get<ECSTransform>(emitter.attached)) {
+                emitter.position = {transform->position.x + emitter.offset.x, transform->position.y + emitter.offset.y};
+                following = false;
+            }
+        }
+        bool spawning = emitter.active && !following;
+
+        if (emitter.count > 0 && integrate(emitter, deltaTime)) {
+            compact(emitter);
+        }
+
+        std::size_t wanted = emitter.pendingBurst;
+        emitter.pendingBurst = 0;
+        if (spawning) {
+            emitter.spawnAccumulator += emitter.config.rate * deltaTime;
+            std::size_t due = static_cast<std::size_t>(emitter.spawnAccumulator);
+            emitter.spawnAccumulator -= static_cast<float>(due);
+            wanted += due;
+        }
+        std::size_t room = emitter.config.capacity - emitter.count;
+        spawn(emitter, std::min(wanted, room));
+        stats.spawned += std::min(wanted, room);
+        stats.dropped += wanted > room ? wanted - room : 0;
+
+        stats.alive += emitter.count;
+        stats.capacity += emitter.config.capacity;
+    }
+    stats.updateMicroseconds = MicrosecondsSince(start);
+}
+
+void ParticleSystem::spawn(Emitter& emitter, std::size_t count) {
+    const EmitterConfig& config = emitter.config;
+    for (std::size_t n = 0; n < count; n++) {
+        std::size_t i = emitter.count++;
+        float angle = config.direction + RandomRange(emitter.randomState, -0.5f, 0.5f) * config.spread;
+        float speed = RandomRange(emitter.randomState, config.speedMin, config.speedMax);
+        float life = std::max(RandomRange(emitter.randomState, config.lifeMin, config.lifeMax), 1e-3f);
+        emitter.positionX[i] = emitter.position.x;
+        emitter.positionY[i] = emitter.position.y;
+        emitter.velocityX[i] = std::cos(angle) * speed;
+        emitter.velocityY[i] = std::sin(angle) * speed;
+        emitter.remaining[i] = life;
+        emitter.inverseLife[i] = 1.0f / life;
+        emitter.size[i] = RandomRange(emitter.randomState, config.sizeMin, config.sizeMax);
+    }
+}
+
+bool ParticleSystem::integrate(Emitter& emitter, float deltaTime) {
+    const float damping = std::max(0.0f, 1.0f - emitter.config.drag * deltaTime);
+    const float gravityX = emitter.config.gravity.x * deltaTime;
+    const float gravityY = emitter.config.gravity.y * deltaTime;
+    float* positionX = emitter.positionX.data();
+    float* positionY = emitter.positionY.data();
+    float* velocityX = emitter.velocityX.data();
+    float* velocityY = emitter.velocityY.data();
+    float* remaining = emitter.remaining.data();
+
+#ifdef PARTICLES_USE_SSE2
+    // Pools are padded, so the last group of four may run past count into unused slots
+    const std::size_t count = (emitter.count + 3) & ~static_cast<std::size_t>(3);
+    const __m128 delta = _mm_set1_ps(deltaTime);
+    const __m128 dampingLanes = _mm_set1_ps(damping);
+    const __m128 gravityXLanes = _mm_set1_ps(gravityX);
+    const __m128 gravityYLanes = _mm_set1_ps(gravityY);
+    const __m128 zero = _mm_setzero_ps();
+    int expired = 0;
+    for (std::size_t i = 0; i < count; i += 4) {
+        __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityX + i), gravityXLanes), dampingLanes);
+        __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityY + i), gravityYLanes), dampingLanes);
+        _mm_storeu_ps(velocityX + i, vx);
+        _mm_storeu_ps(velocityY + i, vy);
+        _mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, delta)));
+        _mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, delta)));
+        __m128 left = _mm_sub_ps(_mm_loadu_ps(remaining + i), delta);
+        _mm_storeu_ps(remaining + i, left);
+        int mask = _mm_movemask_ps(_mm_cmple_ps(left, zero));
+        if (i + 4 > emitter.count) {
+            mask &= (1 << (emitter.count - i)) - 1;  // ignore the padding lanes
+        }
+        expired |= mask;
+    }
+    return expired != 0;
+#else
+    bool expired = false;
+    for (std::size_t i = 0; i < emitter.count; i++) {
+        velocityX[i] = (velocityX[i] + gravityX) * damping;
+        velocityY[i] = (velocityY[i] + gravityY) * damping;
+        positionX[i] += velocityX[i] * deltaTime;
+        positionY[i] += velocityY[i] * deltaTime;
+        remaining[i] -= deltaTime;
+        expired |= remaining[i] <= 0.0f;
+    }
+    return expired;
+#endif
+}
+
+void ParticleSystem::compact(Emitter& emitter) {
+    // Swap-remove: the last live particle takes the expired one's slot
+    std::size_t i = 0;
+    while (i < emitter.count) {
+        if (emitter.remaining[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        std::size_t last = --emitter.count;
+        emitter.positionX[i] = emitter.positionX[last];
+        emitter.positionY[i] = emitter.positionY[last];
+        emitter.velocityX[i] = emitter.velocityX[last];
+        emitter.velocityY[i] = emitter.velocityY[last];
+        emitter.remaining[i] = emitter.remaining[last];
+        emitter.inverseLife[i] = emitter.inverseLife[last];
+        emitter.size[i] = emitter.size[last];
+    }
+}
+
+void ParticleSystem::buildRenderCommands(RenderFrame& frame) {
+    auto start = std::chrono::steady_clock::now();
+    stats.drawn = 0;
+    stats.batches = 0;
+
+    float screenWidth = frame.screenSize.x;
+    float screenHeight = frame.screenSize.y;
+    Vector2 camera = frame.cameraOffset;
+
+    // Materials in a fixed order: alpha before additive, solid before soft
+    for (int material = 0; material < 4; material++) {
+        bool additive = material >= 2;
+        bool soft = (material & 1) != 0;
+        std::size_t first = frame.particles.size();
+
+        for (const Emitter& emitter : emitters) {
+            const EmitterConfig& config = emitter.config;
+            if (config.additive != additive || config.soft != soft || emitter.count == 0) continue;
+
+            for (std::size_t i = 0; i < emitter.count; i++) {
+                float x = emitter.positionX[i] - camera.x;
+                float y = emitter.positionY[i] - camera.y;
+                float age = 1.0f - emitter.remaining[i] * emitter.inverseLife[i];
+                float halfSize = emitter.size[i] * (1.0f + (config.endScale - 1.0f) * age) * 0.5f;
+                if (x + halfSize < 0.0f || y + halfSize < 0.0f || x - halfSize > screenWidth || y - halfSize > screenHeight) {
+                    continue;
+                }
+
+                Color color = {
+                    LerpChannel(config.startColor.r, config.endColor.r, age),
+                    LerpChannel(config.startColor.g, config.endColor.g, age),
+                    LerpChannel(config.startColor.b, config.endColor.b, age),
+                    LerpChannel(config.startColor.a, config.endColor.a, age)
+                };
+                frame.particles.push_back(RenderFrame::ParticleQuad{{x, y}, halfSize, color});
+            }
+        }
+
+        std::size_t count = frame.particles.size() - first;
+        if (count == 0) continue;
+        frame.particleBatches.push_back(RenderFrame::ParticleBatch{
+            soft ? softTexture.id : 0u, additive, static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(count)});
+        stats.drawn += count;
+        stats.batches++;
+    }
+    stats.recordMicroseconds = MicrosecondsSince(start);
+}
+
+bool ParticleSystem::uploadTextures() {
+    // White disc fading to transparent at the edge; tinted per particle
+    Image image = GenImageGradientRadial(64, 64, 0.0f, WHITE, BLANK);
+    softTexture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    if (softTexture.id == 0) {
+        std::cerr << "Failed to create particle texture" << std::endl;
+        return false;
+    }
+    SetTextureFilter(softTexture, TEXTURE_FILTER_BILINEAR);
+    return true;
+}
+
+void ParticleSystem::unloadTextures() {
+    if (softTexture.id != 0) {
+        UnloadTexture(softTexture);
+        softTexture = {};
+    }
+}
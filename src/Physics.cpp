@@ -0,0 +1,482 @@
+#include "Physics.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace {
+    // Only contacts hitting faster than this bounce; slower ones just stop
+    const float BounceSpeed = 1.0f;
+
+    enum IslandFlag : std::uint8_t {
+        IslandAwake = 1,
+        IslandRestless = 2
+    };
+
+    double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+Collider makeCollider(const CircleShape& circle) {
+    Collider collider;
+    collider.isCircle = true;
+    collider.radius = circle.radius;
+    collider.halfExtents = {circle.radius, circle.radius};
+    return collider;
+}
+
+Collider makeCollider(const BoxShape& box) {
+    Collider collider;
+    collider.isCircle = false;
+    collider.radius = std::sqrt(box.size.x * box.size.x + box.size.y * box.size.y) / 2;
+    collider.halfExtents = {box.size.x / 2, box.size.y / 2};
+    return collider;
+}
+
+void runPhysicsBenchmark(std::size_t bodyCount, std::size_t threadCount, int steps) {
+    const float deltaTime = 1.0f / 60.0f;
+    const float radius = 6.0f;
+    const float spacing = radius * 2.5f;
+    std::size_t columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(bodyCount))));
+    float side = columns * spacing;
+
+    entt::registry registry;
+    std::uint32_t random = 12345;
+    auto nextSpeed = [&random]() {
+        random = random * 1664525u + 1013904223u;
+        return static_cast<float>(random >> 8) / 16777216.0f * 200.0f - 100.0f;
+    };
+    for (std::size_t i = 0; i < bodyCount; i++) {
+        entt::entity entity = registry.create();
+        registry.emplace<ECSTransform>(entity).position = {(i % columns + 0.5f) * spacing, (i / columns + 0.5f) * spacing};
+        registry.emplace<Velocity>(entity).linear = {nextSpeed(), nextSpeed()};
+        registry.emplace<Collider>(entity, makeCollider(CircleShape{radius}));
+        registry.emplace<RigidBody>(entity);
+    }
+
+    // Walls, and a kinematic box that sweeps back and forth through the crowd
+    const float wall = 20.0f;
+    const Vector2 wallCentres[4] = {{side / 2, -wall}, {side / 2, side + wall}, {-wall, side / 2}, {side + wall, side / 2}};
+    for (int i = 0; i < 4; i++) {
+        entt::entity entity = registry.create();
+        registry.emplace<ECSTransform>(entity).position = wallCentres[i];
+        BoxShape box;
+        box.size = i < 2 ? Vector2{side + 4 * wall, 2 * wall} : Vector2{2 * wall, side + 4 * wall};
+        registry.emplace<Collider>(entity, makeCollider(box));
+    }
+    entt::entity sweeper = registry.create();
+    registry.emplace<ECSTransform>(sweeper).position = {0.0f, side / 2};
+    registry.emplace<Velocity>(sweeper).linear = {side / 4, 0.0f};
+    BoxShape sweeperBox;
+    sweeperBox.size = {4 * radius, side / 2};
+    registry.emplace<Collider>(sweeper, makeCollider(sweeperBox));
+
+    PhysicsConfig config;
+    config.threadCount = threadCount;
+    PhysicsWorld world(config);
+
+    std::vector<double> milliseconds;
+    milliseconds.reserve(static_cast<std::size_t>(std::max(steps, 0)));
+    for (int step = 0; step < steps; step++) {
+        // The same integration ECSSystem::updateMovement does before physics
+        for (auto [entity, transform, velocity] : registry.view<ECSTransform, Velocity>().each()) {
+            transform.position.x += velocity.linear.x * deltaTime;
+            transform.position.y += velocity.linear.y * deltaTime;
+        }
+        auto& sweep = registry.get<Velocity>(sweeper).linear;
+        float sweeperX = registry.get<ECSTransform>(sweeper).position.x;
+        if ((sweeperX > side && sweep.x > 0.0f) || (sweeperX < 0.0f && sweep.x < 0.0f)) {
+            sweep.x = -sweep.x;
+        }
+
+        world.step(registry, deltaTime);
+        milliseconds.push_back(world.getStats().totalMicroseconds / 1000.0);
+    }
+    if (milliseconds.empty()) return;
+
+    double total = 0.0;
+    for (double value : milliseconds) {
+        total += value;
+    }
+    std::sort(milliseconds.begin(), milliseconds.end());
+    const PhysicsWorld::Stats& stats = world.getStats();
+    std::cout << "Physics benchmark: " << bodyCount << " bodies, " << stats.threads << " threads, " << steps << " steps" << std::endl;
+    std::cout << "  step ms: mean " << total / milliseconds.size()
+              << ", p50 " << milliseconds[milliseconds.size() / 2]
+              << ", p99 " << milliseconds[milliseconds.size() * 99 / 100]
+              << ", max " << milliseconds.back() << " (60 Hz budget 16.7)" << std::endl;
+    std::cout << "  last step: " << stats.awake << " awake, " << stats.sleeping << " sleeping, " << stats.pairs << " pairs, "
+              << stats.contacts << " contacts, " << stats.islands << " islands; broadphase "
+              << stats.broadphaseMicroseconds << " us, narrowphase " << stats.narrowphaseMicroseconds
+              << " us, solve " << stats.solveMicroseconds << " us" << std::endl;
+}
+
+SpatialGrid::SpatialGrid(float size)
+    : cellSize(size) {
+}
+
+void SpatialGrid::clear() {
+    entries.clear();
+    bounds.clear();
+}
+
+void SpatialGrid::insert(std::uint32_t id, Rectangle area) {
+    if (bounds.size() <= id) {
+        bounds.resize(id + 1);
+    }
+    bounds[id] = area;
+
+    int minX = static_cast<int>(std::floor(area.x / cellSize));
+    int minY = static_cast<int>(std::floor(area.y / cellSize));
+    int maxX = static_cast<int>(std::floor((area.x + area.width) / cellSize));
+    int maxY = static_cast<int>(std::floor((area.y + area.height) / cellSize));
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            entries.push_back(Entry{cellKey(x, y), id});
+        }
+    }
+}
+
+PhysicsWorld::PhysicsWorld(const PhysicsConfig& physicsConfig)
+    : config(physicsConfig)
+    , pool(std::make_unique<ThreadPool>(physicsConfig.threadCount))
+    , grid(physicsConfig.cellSize) {
+    config.iterations = std::max(1, config.iterations);
+    config.narrowphaseGrain = std::max<std::size_t>(1, config.narrowphaseGrain);
+    stats.threads = pool->getThreadCount();
+}
+
+PhysicsWorld::~PhysicsWorld() = default;
+
+void PhysicsWorld::step(entt::registry& registry, float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+
+    gatherBodies(registry);
+    findPairs();
+    stats.broadphaseMicroseconds = MicrosecondsSince(start);
+
+    auto narrowStart = std::chrono::steady_clock::now();
+    findContacts();
+    stats.narrowphaseMicroseconds = MicrosecondsSince(narrowStart);
+
+    auto solveStart = std::chrono::steady_clock::now();
+    buildIslands();
+    wakeIslands();
+    solve();
+    sleepIslands(deltaTime);
+    writeBack(registry);
+    stats.solveMicroseconds = MicrosecondsSince(solveStart);
+
+    stats.totalMicroseconds = MicrosecondsSince(start);
+}
+
+void PhysicsWorld::gatherBodies(entt::registry& registry) {
+    bodies.clear();
+
+    for (auto [entity, transform, collider] : registry.view<ECSTransform, Collider>().each()) {
+        Body body;
+        body.entity = entity;
+        body.position = transform.position;
+        body.halfExtents = collider.halfExtents;
+        body.radius = collider.radius;
+        body.restitution = collider.restitution;
+        body.isCircle = collider.isCircle;
+
+        const Velocity* velocity = registry.try_get<Velocity>(entity);
+        body.hasVelocity = velocity != nullptr;
+        body.velocity = velocity ? velocity->linear : Vector2{0.0f, 0.0f};
+
+        const RigidBody* rigidBody = registry.try_get<RigidBody>(entity);
+        body.dynamic = rigidBody && rigidBody->inverseMass > 0.0f;
+        body.inverseMass = body.dynamic ? rigidBody->inverseMass : 0.0f;
+        body.sleeping = body.dynamic && rigidBody->sleeping;
+        body.sleepTime = body.dynamic ? rigidBody->sleepTime : 0.0f;
+        body.kinematic = !body.dynamic && (body.velocity.x != 0.0f || body.velocity.y != 0.0f);
+
+        // Sleeping bodies have zero velocity; anything else was set from outside
+        if (body.sleeping && (body.velocity.x != 0.0f || body.velocity.y != 0.0f)) {
+            body.sleeping = false;
+            body.sleepTime = 0.0f;
+        }
+        bodies.push_back(body);
+    }
+    stats.bodies = bodies.size();
+}
+
+void PhysicsWorld::findPairs() {
+    grid.setCellSize(config.cellSize);
+    grid.clear();
+    for (std::uint32_t i = 0; i < bodies.size(); i++) {
+        const Body& body = bodies[i];
+        Vector2 extents = body.isCircle ? Vector2{body.radius, body.radius} : body.halfExtents;
+        grid.insert(i, {body.position.x - extents.x, body.position.y - extents.y, extents.x * 2, extents.y * 2});
+    }
+
+    // Static and sleeping bodies only matter when an awake body reaches them;
+    // a moving collider without a RigidBody reaches every dynamic body, asleep or not
+    pairs.clear();
+    grid.findPairs(pairs, [this](std::uint32_t a, std::uint32_t b) {
+        const Body& bodyA = bodies[a];
+        const Body& bodyB = bodies[b];
+        return (bodyA.dynamic && !bodyA.sleeping) || (bodyB.dynamic && !bodyB.sleeping) ||
+               (bodyA.kinematic && bodyB.dynamic) || (bodyB.kinematic && bodyA.dynamic);
+    });
+    stats.pairs = pairs.size();
+}
+
+void PhysicsWorld::findContacts() {
+    // One output list per range, joined in range order, so the contact order
+    // is the pair order whichever thread ran a range
+    const std::size_t grain = config.narrowphaseGrain;
+    std::size_t rangeCount = (pairs.size() + grain - 1) / grain;
+    if (rangeContacts.size() < rangeCount) {
+        rangeContacts.resize(rangeCount);
+    }
+
+    pool->parallelFor(pairs.size(), grain, [this, grain](std::size_t begin, std::size_t end) {
+        std::vector<Contact>& out = rangeContacts[begin / grain];
+        out.clear();
+        for (std::size_t i = begin; i < end; i++) {
+            Contact contact;
+            contact.a = static_cast<std::uint32_t>(pairs[i] >> 32);
+            contact.b = static_cast<std::uint32_t>(pairs[i]);
+            if (collide(bodies[contact.a], bodies[contact.b], contact)) {
+                out.push_back(contact);
+            }
+        }
+    });
+
+    contacts.clear();
+    for (std::size_t range = 0; range < rangeCount; range++) {
+        contacts.insert(contacts.end(), rangeContacts[range].begin(), rangeContacts[range].end());
+    }
+    stats.contacts = contacts.size();
+}
+
+bool PhysicsWorld::collide(const Body& a, const Body& b, Contact& contact) {
+    float dx = b.position.x - a.position.x;
+    float dy = b.position.y - a.position.y;
+
+    if (a.isCircle && b.isCircle) {
+        float radii = a.radius + b.radius;
+        float distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared >= radii * radii) return false;
+
+        float distance = std::sqrt(distanceSquared);
+        contact.normal = distance > 1e-6f ? Vector2{dx / distance, dy / distance} : Vector2{1.0f, 0.0f};
+        contact.penetration = radii - distance;
+        return true;
+    }
+
+    if (!a.isCircle && !b.isCircle) {
+        float overlapX = a.halfExtents.x + b.halfExtents.x - std::fabs(dx);
+        float overlapY = a.halfExtents.y + b.halfExtents.y - std::fabs(dy);
+        if (overlapX <= 0.0f || overlapY <= 0.0f) return false;
+
+        // Separate along the axis of least overlap
+        if (overlapX < overlapY) {
+            contact.normal = {dx < 0.0f ? -1.0f : 1.0f, 0.0f};
+            contact.penetration = overlapX;
+        } else {
+            contact.normal = {0.0f, dy < 0.0f ? -1.0f : 1.0f};
+            contact.penetration = overlapY;
+        }
+        return true;
+    }
+
+    // Circle against box, worked out from the box towards the circle
+    const Body& circle = a.isCircle ? a : b;
+    const Body& box = a.isCircle ? b : a;
+    float offsetX = circle.position.x - box.position.x;
+    float offsetY = circle.position.y - box.position.y;
+    float closestX = std::clamp(offsetX, -box.halfExtents.x, box.halfExtents.x);
+    float closestY = std::clamp(offsetY, -box.halfExtents.y, box.halfExtents.y);
+
+    Vector2 boxToCircle;
+    if (closestX == offsetX && closestY == offsetY) {
+        // Centre inside the box: push out through the nearest face
+        float faceX = box.halfExtents.x - std::fabs(offsetX);
+        float faceY = box.halfExtents.y - std::fabs(offsetY);
+        if (faceX < faceY) {
+            boxToCircle = {offsetX < 0.0f ? -1.0f : 1.0f, 0.0f};
+            contact.penetration = circle.radius + faceX;
+        } else {
+            boxToCircle = {0.0f, offsetY < 0.0f ? -1.0f : 1.0f};
+            contact.penetration = circle.radius + faceY;
+        }
+    } else {
+        float edgeX = offsetX - closestX;
+        float edgeY = offsetY - closestY;
+        float distanceSquared = edgeX * edgeX + edgeY * edgeY;
+        if (distanceSquared >= circle.radius * circle.radius) return false;
+
+        float distance = std::sqrt(distanceSquared);
+        boxToCircle = {edgeX / distance, edgeY / distance};
+        contact.penetration = circle.radius - distance;
+    }
+    contact.normal = a.isCircle ? Vector2{-boxToCircle.x, -boxToCircle.y} : boxToCircle;
+    return true;
+}
+
+std::uint32_t PhysicsWorld::findRoot(std::uint32_t body) {
+    while (islandParent[body] != body) {
+        islandParent[body] = islandParent[islandParent[body]];
+        body = islandParent[body];
+    }
+    return body;
+}
+
+void PhysicsWorld::buildIslands() {
+    // Dynamic bodies connected through contacts; static bodies do not join islands
+    islandParent.resize(bodies.size());
+    islandFlags.assign(bodies.size(), 0);
+    for (std::uint32_t i = 0; i < bodies.size(); i++) {
+        islandParent[i] = i;
+    }
+    for (const Contact& contact : contacts) {
+        if (!bodies[contact.a].dynamic || !bodies[contact.b].dynamic) continue;
+        std::uint32_t rootA = findRoot(contact.a);
+        std::uint32_t rootB = findRoot(contact.b);
+        if (rootA != rootB) {
+            // Lower index as root keeps the result independent of contact order details
+            islandParent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    stats.islands = 0;
+    for (std::uint32_t i = 0; i < bodies.size(); i++) {
+        if (bodies[i].dynamic && findRoot(i) == i) {
+            stats.islands++;
+        }
+    }
+}
+
+void PhysicsWorld::wakeIslands() {
+    // An awake body wakes everything it touches, directly or through others,
+    // and so does a moving kinematic collider
+    for (std::uint32_t i = 0; i < bodies.size(); i++) {
+        if (bodies[i].dynamic && !bodies[i].sleeping) {
+            islandFlags[findRoot(i)] |= IslandAwake;
+        }
+    }
+    for (const Contact& contact : contacts) {
+        if (bodies[contact.a].kinematic || bodies[contact.b].kinematic) {
+            std::uint32_t body = bodies[contact.a].dynamic ? contact.a : contact.b;
+            islandFlags[findRoot(body)] |= IslandAwake;
+        }
+    }
+    for (std::uint32_t i = 0; i < bodies.size(); i++) {
+        Body& body = bodies[i];
+        if (body.dynamic && body.sleeping && (islandFlags[findRoot(i)] & IslandAwake)) {
+            body.sleeping = false;
+            body.sleepTime = 0.0f;
+        }
+    }
+}
+
+void PhysicsWorld::solve() {
+    auto inverseMass = [](const Body& body) {
+        return body.dynamic && !body.sleeping ? body.inverseMass : 0.0f;
+    };
+
+    for (Contact& contact : contacts) {
+        const Body& a = bodies[contact.a];
+        const Body& b = bodies[contact.b];
+        float approach = (b.velocity.x - a.velocity.x) * contact.normal.x + (b.velocity.y - a.velocity.y) * contact.normal.y;
+        float restitution = std::min(a.restitution, b.restitution);
+        contact.targetSpeed = approach < -BounceSpeed ? -restitution * approach : 0.0f;
+        contact.impulse = 0.0f;
+    }
+
+    // Sequential impulses with clamped accumulated impulse per contact
+    for (int iteration = 0; iteration < config.iterations; iteration++) {
+        for (Contact& contact : contacts) {
+            Body& a = bodies[contact.a];
+            Body& b = bodies[contact.b];
+            float inverseA = inverseMass(a);
+            float inverseB = inverseMass(b);
+            float inverseSum = inverseA + inverseB;
+            if (inverseSum <= 0.0f) continue;
+
+            float speed = (b.velocity.x - a.velocity.x) * contact.normal.x + (b.velocity.y - a.velocity.y) * contact.normal.y;
+            float lambda = (contact.targetSpeed - speed) / inverseSum;
+            float impulse = std::max(contact.impulse + lambda, 0.0f);
+            lambda = impulse - contact.impulse;
+            contact.impulse = impulse;
+
+            a.velocity.x -= lambda * inverseA * contact.normal.x;
+            a.velocity.y -= lambda * inverseA * contact.normal.y;
+            b.velocity.x += lambda * inverseB * contact.normal.x;
+            b.velocity.y += lambda * inverseB * contact.normal.y;
+        }
+    }
+
+    // Push overlapping bodies apart, beyond a small slop that keeps stacks stable
+    for (const Contact& contact : contacts) {
+        Body& a = bodies[contact.a];
+        Body& b = bodies[contact.b];
+        float inverseA = inverseMass(a);
+        float inverseB = inverseMass(b);
+        float inverseSum = inverseA + inverseB;
+        float depth = contact.penetration - config.slop;
+        if (inverseSum <= 0.0f || depth <= 0.0f) continue;
+
+        float push = depth * config.correction / inverseSum;
+        a.position.x -= push * inverseA * contact.normal.x;
+        a.position.y -= push * inverseA * contact.normal.y;
+        b.position.x += push * inverseB * contact.normal.x;
+        b.position.y += push * inverseB * contact.normal.y;
+    }
+}
+
+void PhysicsWorld::sleepIslands(float deltaTime) {
+    float sleepSpeedSquared = config.sleepSpeed * config.sleepSpeed;
+    for (std::uint32_t i = 0; i < bodies.size(); i++) {
+        Body& body = bodies[i];
+        if (!body.dynamic || body.sleeping) continue;
+
+        float speedSquared = body.velocity.x * body.velocity.x + body.velocity.y * body.velocity.y;
+        body.sleepTime = speedSquared < sleepSpeedSquared ? body.sleepTime + deltaTime : 0.0f;
+        if (body.sleepTime < config.timeToSleep) {
+            islandFlags[findRoot(i)] |= IslandRestless;
+        }
+    }
+    // Deep overlaps and kinematic pushers keep an island awake
+    for (const Contact& contact : contacts) {
+        if (contact.penetration > config.sleepPenetration || bodies[contact.a].kinematic || bodies[contact.b].kinematic) {
+            std::uint32_t body = bodies[contact.a].dynamic ? contact.a : contact.b;
+            islandFlags[findRoot(body)] |= IslandRestless;
+        }
+    }
+
+    stats.awake = 0;
+    stats.sleeping = 0;
+    for (std::uint32_t i = 0; i < bodies.size(); i++) {
+        Body& body = bodies[i];
+        if (!body.dynamic) continue;
+        if (!body.sleeping && !(islandFlags[findRoot(i)] & IslandRestless)) {
+            body.sleeping = true;
+            body.velocity = {0.0f, 0.0f};
+        }
+        if (body.sleeping) {
+            stats.sleeping++;
+        } else {
+            stats.awake++;
+        }
+    }
+}
+
+void PhysicsWorld::writeBack(entt::registry& registry) {
+    for (const Body& body : bodies) {
+        if (!body.dynamic) continue;
+
+        registry.get<ECSTransform>(body.entity).position = body.position;
+        if (body.hasVelocity) {
+            registry.get<Velocity>(body.entity).linear = body.velocity;
+        }
+        auto& rigidBody = registry.get<RigidBody>(body.entity);
+        rigidBody.sleeping = body.sleeping;
+        rigidBody.sleepTime = body.sleepTime;
+    }
+}
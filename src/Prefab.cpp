@@ -0,0 +1,285 @@
+#include "Prefab.h"
+#include "ECS.h"
+#include "Physics.h"
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace po = boost::program_options;
+
+Prefab::Prefab(const Prefab& other)
+    : name(other.name) {
+    components.reserve(other.components.size());
+    for (const auto& slot : other.components) {
+        components.push_back(slot->clone());
+    }
+}
+
+Prefab& Prefab::operator=(const Prefab& other) {
+    if (this != &other) {
+        Prefab copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+Prefab::ComponentSlot* Prefab::find(entt::id_type type) const {
+    for (const auto& slot : components) {
+        if (slot->type() == type) {
+            return slot.get();
+        }
+    }
+    return nullptr;
+}
+
+void Prefab::instantiate(entt::registry& registry, const entt::entity* first, const entt::entity* last) const {
+    if (first == last) return;
+
+    for (const auto& slot : components) {
+        slot->insert(registry, first, last);
+    }
+}
+
+Prefab& PrefabLibrary::define(const std::string& name) {
+    auto& prefab = prefabs[name];
+    prefab = Prefab(name);
+    return prefab;
+}
+
+const Prefab* PrefabLibrary::find(const std::string& name) const {
+    auto it = prefabs.find(name);
+    return it != prefabs.end() ? &it->second : nullptr;
+}
+
+namespace {
+    // Fields of one prefab section, keyed by "component.field"
+    class FieldReader {
+    public:
+        FieldReader(const std::string& prefabName, const std::map<std::string, std::string>& fields)
+            : prefabName(prefabName), fields(fields), valid(true) {}
+
+        bool hasComponent(const std::string& component) const {
+            for (const auto& field : fields) {
+                const std::string& key = field.first;
+                if (key == component || key.compare(0, component.size() + 1, component + ".") == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        float getFloat(const std::string& key, float fallback) {
+            auto it = fields.find(key);
+            if (it == fields.end()) return fallback;
+            try {
+                return std::stof(it->second);
+            } catch (const std::exception&) {
+                Error(key, it->second);
+                return fallback;
+            }
+        }
+
+        int getInt(const std::string& key, int fallback) {
+            auto it = fields.find(key);
+            if (it == fields.end()) return fallback;
+            try {
+                return std::stoi(it->second);
+            } catch (const std::exception&) {
+                Error(key, it->second);
+                return fallback;
+            }
+        }
+
+        bool getBool(const std::string& key, bool fallback) {
+            auto it = fields.find(key);
+            if (it == fields.end()) return fallback;
+            const std::string& value = it->second;
+            if (value == "true" || value == "1" || value == "yes") return true;
+            if (value == "false" || value == "0" || value == "no") return false;
+            Error(key, value);
+            return fallback;
+        }
+
+        std::string getString(const std::string& key, const std::string& fallback) const {
+            auto it = fields.find(key);
+            return it != fields.end() ? it->second : fallback;
+        }
+
+        // "r,g,b" or "r,g,b,a" with 0-255 channels
+        Color getColor(const std::string& key, Color fallback) {
+            auto it = fields.find(key);
+            if (it == fields.end()) return fallback;
+
+            int channels[4] = {0, 0, 0, 255};
+            int count = 0;
+            std::stringstream stream(it->second);
+            std::string part;
+            while (std::getline(stream, part, ',') && count < 4) {
+                try {
+                    channels[count++] = std::stoi(part);
+                } catch (const std::exception&) {
+                    Error(key, it->second);
+                    return fallback;
+                }
+            }
+            if (count < 3) {
+                Error(key, it->second);
+                return fallback;
+            }
+            return Color{(unsigned char)channels[0], (unsigned char)channels[1],
+                         (unsigned char)channels[2], (unsigned char)channels[3]};
+        }
+
+        bool isValid() const { return valid; }
+
+    private:
+        void Error(const std::string& key, const std::string& value) {
+            std::cerr << "Prefab '" << prefabName << "': invalid value '" << value << "' for " << key << std::endl;
+            valid = false;
+        }
+
+        const std::string& prefabName;
+        const std::map<std::string, std::string>& fields;
+        bool valid;
+    };
+
+    bool BuildPrefab(Prefab& prefab, const std::map<std::string, std::string>& fields) {
+        FieldReader reader(prefab.getName(), fields);
+
+        if (reader.hasComponent("transform")) {
+            ECSTransform transform;
+            transform.position.x = reader.getFloat("transform.x", transform.position.x);
+            transform.position.y = reader.getFloat("transform.y", transform.position.y);
+            transform.rotation = reader.getFloat("transform.rotation", transform.rotation);
+            transform.scale.x = reader.getFloat("transform.scale.x", transform.scale.x);
+            transform.scale.y = reader.getFloat("transform.scale.y", transform.scale.y);
+            prefab.with(transform);
+        }
+
+        if (reader.hasComponent("velocity")) {
+            Velocity velocity;
+            velocity.linear.x = reader.getFloat("velocity.x", velocity.linear.x);
+            velocity.linear.y = reader.getFloat("velocity.y", velocity.linear.y);
+            velocity.angular = reader.getFloat("velocity.angular", velocity.angular);
+            prefab.with(velocity);
+        }
+
+        if (reader.hasComponent("renderable")) {
+            Renderable renderable;
+            renderable.color = reader.getColor("renderable.color", renderable.color);
+            prefab.with(renderable);
+
+            // The shape goes into its own pool
+            if (reader.getBool("renderable.circle", true)) {
+                CircleShape circle;
+                circle.radius = reader.getFloat("renderable.radius", circle.radius);
+                prefab.with(circle);
+            } else {
+                BoxShape box;
+                box.size.x = reader.getFloat("renderable.width", box.size.x);
+                box.size.y = reader.getFloat("renderable.height", box.size.y);
+                prefab.with(box);
+            }
+        }
+
+        if (reader.hasComponent("collider")) {
+            // Defaults to the renderable's shape, so "collider = true" is enough
+            Collider collider;
+            if (const CircleShape* circle = prefab.get<CircleShape>()) {
+                collider = makeCollider(*circle);
+            } else if (const BoxShape* box = prefab.get<BoxShape>()) {
+                collider = makeCollider(*box);
+            }
+            collider.isCircle = reader.getBool("collider.circle", collider.isCircle);
+            collider.radius = reader.getFloat("collider.radius", collider.radius);
+            collider.halfExtents.x = reader.getFloat("collider.width", collider.halfExtents.x * 2) / 2;
+            collider.halfExtents.y = reader.getFloat("collider.height", collider.halfExtents.y * 2) / 2;
+            collider.restitution = reader.getFloat("collider.restitution", collider.restitution);
+            prefab.with(collider);
+        }
+
+        if (reader.hasComponent("rigidbody")) {
+            float mass = reader.getFloat("rigidbody.mass", 1.0f);
+            prefab.with(RigidBody{mass > 0.0f ? 1.0f / mass : 0.0f});
+        }
+
+        if (reader.hasComponent("navagent")) {
+            NavAgent agent;
+            agent.goal = static_cast<std::uint32_t>(reader.getInt("navagent.goal", static_cast<int>(agent.goal)));
+            agent.speed = reader.getFloat("navagent.speed", agent.speed);
+            // Defaults to the collider or circle radius
+            if (const Collider* collider = prefab.get<Collider>()) {
+                agent.radius = collider->radius;
+            } else if (const CircleShape* circle = prefab.get<CircleShape>()) {
+                agent.radius = circle->radius;
+            }
+            agent.radius = reader.getFloat("navagent.radius", agent.radius);
+            prefab.with(agent);
+        }
+
+        if (reader.hasComponent("alien3d")) {
+            Alien3D alien;
+            alien.color = reader.getColor("alien3d.color", alien.color);
+            alien.size = reader.getFloat("alien3d.size", alien.size);
+            prefab.with(alien);
+        }
+
+        if (reader.hasComponent("player")) {
+            Player player;
+            player.speed = reader.getFloat("player.speed", player.speed);
+            prefab.with(player);
+
+            PlayerName playerName;
+            playerName.name = reader.getString("player.name", playerName.name);
+            prefab.with(playerName);
+        }
+
+        if (reader.hasComponent("networked")) {
+            prefab.with(Networked{});
+        }
+
+        return reader.isValid();
+    }
+}
+
+bool PrefabLibrary::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open prefab file: " << path << std::endl;
+        return false;
+    }
+
+    // Section headers become key prefixes: [enemy] velocity.x -> enemy.velocity.x
+    po::parsed_options parsed(nullptr);
+    try {
+        po::options_description desc;
+        parsed = po::parse_config_file(file, desc, true);
+    } catch (const po::error& e) {
+        std::cerr << "Failed to parse prefab file " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    std::map<std::string, std::map<std::string, std::string>> sections;
+    for (const auto& option : parsed.options) {
+        auto dot = option.string_key.find('.');
+        if (dot == std::string::npos || option.value.empty()) {
+            std::cerr << "Ignoring prefab entry outside a section: " << option.string_key << std::endl;
+            continue;
+        }
+        sections[option.string_key.substr(0, dot)][option.string_key.substr(dot + 1)] = option.value.front();
+    }
+
+    bool success = true;
+    for (const auto& section : sections) {
+        Prefab prefab(section.first);
+        if (!BuildPrefab(prefab, section.second)) {
+            success = false;
+            continue;
+        }
+        prefabs[section.first] = std::move(prefab);
+    }
+
+    std::cout << "Loaded " << sections.size() << " prefabs from " << path << std::endl;
+    return success;
+}
@@ -0,0 +1,188 @@
+#include "RenderFrame.h"
+#include "SpriteAtlas.h"
+#include "rlgl.h"
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+    void DrawAlien(const RenderFrame::Alien& alien) {
+        // Body, with a smaller head on top
+        DrawSphere(alien.position, alien.size * 15.0f, alien.color);
+        Vector3 headPos = {alien.position.x, alien.position.y - alien.size * 20.0f, alien.position.z};
+        DrawSphere(headPos, alien.size * 8.0f, alien.color);
+
+        // Eyes
+        Vector3 leftEye = {headPos.x - 3.0f, headPos.y - 2.0f, headPos.z + 5.0f};
+        Vector3 rightEye = {headPos.x + 3.0f, headPos.y - 2.0f, headPos.z + 5.0f};
+        DrawSphere(leftEye, 2.0f, BLACK);
+        DrawSphere(rightEye, 2.0f, BLACK);
+
+        // Antennae
+        Vector3 leftAntenna = {headPos.x - 4.0f, headPos.y - 8.0f, headPos.z};
+        Vector3 rightAntenna = {headPos.x + 4.0f, headPos.y - 8.0f, headPos.z};
+        DrawCylinder(leftAntenna, 1.0f, 1.0f, 8.0f, 8, alien.color);
+        DrawCylinder(rightAntenna, 1.0f, 1.0f, 8.0f, 8, alien.color);
+    }
+}
+
+void RenderFrame::clear() {
+    circles.clear();
+    boxes.clear();
+    models.clear();
+    aliens.clear();
+    sprites.clear();
+    particles.clear();
+    particleBatches.clear();
+    overlay.clear();
+    textBuffer.clear();
+}
+
+void RenderFrame::text(int x, int y, int fontSize, Color color, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list measureArgs;
+    va_copy(measureArgs, args);
+    int length = std::vsnprintf(nullptr, 0, format, measureArgs);
+    va_end(measureArgs);
+    if (length < 0) {
+        va_end(args);
+        return;
+    }
+
+    // Each string keeps its terminator so DrawText can read it in place
+    std::size_t offset = textBuffer.size();
+    textBuffer.resize(offset + static_cast<std::size_t>(length) + 1);
+    std::vsnprintf(textBuffer.data() + offset, static_cast<std::size_t>(length) + 1, format, args);
+    va_end(args);
+
+    OverlayItem item = {};
+    item.kind = OverlayItem::Text;
+    item.color = color;
+    item.fontSize = fontSize;
+    item.rect = {static_cast<float>(x), static_cast<float>(y), 0.0f, 0.0f};
+    item.textOffset = static_cast<std::uint32_t>(offset);
+    item.textLength = static_cast<std::uint32_t>(length);
+    overlay.push_back(item);
+}
+
+void RenderFrame::panel(Rectangle rect, Color color) {
+    OverlayItem item = {};
+    item.kind = OverlayItem::Panel;
+    item.color = color;
+    item.rect = rect;
+    overlay.push_back(item);
+}
+
+void RenderFrame::drawScene() const {
+    for (const Circle& circle : circles) {
+        DrawCircleV(circle.position, circle.radius, circle.color);
+    }
+    for (const Box& box : boxes) {
+        DrawRectangleRec(box.rect, box.color);
+    }
+
+    for (const ModelDraw& draw : models) {
+        if (draw.loaded) {
+            DrawModel(draw.model, draw.position, draw.scale, WHITE);
+            // Wireframe bounding box for debugging
+            DrawBoundingBox(GetModelBoundingBox(draw.model), RED);
+        } else {
+            DrawSphere(draw.position, 10.0f, YELLOW);
+        }
+    }
+
+    for (const Alien& alien : aliens) {
+        DrawAlien(alien);
+    }
+}
+
+void RenderFrame::drawSprites(const SpriteAtlas& atlas) const {
+    if (sprites.empty() || !atlas.hasTextures()) return;
+
+    // One texture bind and quad batch per run of sprites on the same page
+    float texelScale = 1.0f / static_cast<float>(atlas.getPageSize());
+    std::size_t runStart = 0;
+    while (runStart < sprites.size()) {
+        std::size_t runEnd = runStart;
+        std::uint16_t page = sprites[runStart].page;
+        std::int16_t layer = sprites[runStart].layer;
+        while (runEnd < sprites.size() && sprites[runEnd].page == page && sprites[runEnd].layer == layer) {
+            runEnd++;
+        }
+
+        rlSetTexture(atlas.getPageTexture(page).id);
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (std::size_t i = runStart; i < runEnd; i++) {
+            const SpriteQuad& quad = sprites[i];
+            const Rectangle& dest = quad.destination;
+            float u0 = quad.source.x * texelScale;
+            float v0 = quad.source.y * texelScale;
+            float u1 = (quad.source.x + quad.source.width) * texelScale;
+            float v1 = (quad.source.y + quad.source.height) * texelScale;
+
+            // Flushes and reopens the batch with the same texture when it is full
+            rlCheckRenderBatchLimit(4);
+            rlColor4ub(quad.tint.r, quad.tint.g, quad.tint.b, quad.tint.a);
+            rlTexCoord2f(u0, v0);
+            rlVertex2f(dest.x, dest.y);
+            rlTexCoord2f(u0, v1);
+            rlVertex2f(dest.x, dest.y + dest.height);
+            rlTexCoord2f(u1, v1);
+            rlVertex2f(dest.x + dest.width, dest.y + dest.height);
+            rlTexCoord2f(u1, v0);
+            rlVertex2f(dest.x + dest.width, dest.y);
+        }
+        rlEnd();
+        rlSetTexture(0);
+        runStart = runEnd;
+    }
+}
+
+void RenderFrame::drawParticles() const {
+    for (const ParticleBatch& batch : particleBatches) {
+        if (batch.additive) {
+            BeginBlendMode(BLEND_ADDITIVE);
+        }
+
+        // One quad batch per material; rlgl flushes it in place when it fills up
+        rlSetTexture(batch.texture != 0 ? batch.texture : rlGetTextureIdDefault());
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (std::uint32_t i = batch.first; i < batch.first + batch.count; i++) {
+            const ParticleQuad& quad = particles[i];
+            float left = quad.position.x - quad.halfSize;
+            float top = quad.position.y - quad.halfSize;
+            float right = quad.position.x + quad.halfSize;
+            float bottom = quad.position.y + quad.halfSize;
+
+            rlCheckRenderBatchLimit(4);
+            rlColor4ub(quad.color.r, quad.color.g, quad.color.b, quad.color.a);
+            rlTexCoord2f(0.0f, 0.0f);
+            rlVertex2f(left, top);
+            rlTexCoord2f(0.0f, 1.0f);
+            rlVertex2f(left, bottom);
+            rlTexCoord2f(1.0f, 1.0f);
+            rlVertex2f(right, bottom);
+            rlTexCoord2f(1.0f, 0.0f);
+            rlVertex2f(right, top);
+        }
+        rlEnd();
+        rlSetTexture(0);
+
+        if (batch.additive) {
+            EndBlendMode();
+        }
+    }
+}
+
+void RenderFrame::drawOverlay() const {
+    for (const OverlayItem& item : overlay) {
+        if (item.kind == OverlayItem::Panel) {
+            DrawRectangleRec(item.rect, item.color);
+        } else {
+            DrawText(textBuffer.data() + item.textOffset, static_cast<int>(item.rect.x), static_cast<int>(item.rect.y),
+                     item.fontSize, item.color);
+        }
+    }
+}
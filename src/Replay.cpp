@@ -0,0 +1,174 @@
+#include "Replay.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const char ReplayMagic[4] = {'G', 'E', 'R', 'P'};
+    const std::uint32_t ReplayVersion = 2;
+    const std::uint8_t HasMessagesFlag = 0x80;
+    const std::uint8_t EndMarker = 0xFF;
+
+    template<typename T>
+    void WriteValue(std::ofstream& file, T value) {
+        char bytes[sizeof(T)];
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            bytes[i] = static_cast<char>((static_cast<std::uint64_t>(value) >> (i * 8)) & 0xFF);
+        }
+        file.write(bytes, sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadValue(std::ifstream& file, T& value) {
+        unsigned char bytes[sizeof(T)];
+        if (!file.read(reinterpret_cast<char*>(bytes), sizeof(T))) {
+            return false;
+        }
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            result |= static_cast<std::uint64_t>(bytes[i]) << (i * 8);
+        }
+        value = static_cast<T>(result);
+        return true;
+    }
+}
+
+ReplayRecorder::~ReplayRecorder() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+bool ReplayRecorder::Open(const std::string& path, std::uint64_t seed, float tickSeconds) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to open replay file for writing: " << path << std::endl;
+        return false;
+    }
+
+    file.write(ReplayMagic, sizeof(ReplayMagic));
+    WriteValue<std::uint32_t>(file, ReplayVersion);
+    WriteValue<std::uint64_t>(file, seed);
+    std::uint32_t tickBits = 0;
+    std::memcpy(&tickBits, &tickSeconds, sizeof(tickBits));
+    WriteValue<std::uint32_t>(file, tickBits);
+    tickCount = 0;
+
+    std::cout << "Recording replay to " << path << " (seed " << seed << ")" << std::endl;
+    return true;
+}
+
+void ReplayRecorder::RecordTick(const InputFrame& input, const std::pmr::vector<NetworkMessage>& messages) {
+    if (!file.is_open()) return;
+
+    std::uint8_t flags = input.buttons & 0x7F;
+    if (!messages.empty()) {
+        flags |= HasMessagesFlag;
+    }
+    WriteValue<std::uint8_t>(file, flags);
+
+    if (!messages.empty()) {
+        WriteValue<std::uint16_t>(file, static_cast<std::uint16_t>(messages.size()));
+        for (const auto& msg : messages) {
+            std::uint16_t peerId = msg.peer ? msg.peer->incomingPeerID : 0xFFFF;
+            std::uint16_t length = static_cast<std::uint16_t>(std::min<std::size_t>(msg.data.size(), 0xFFFF));
+            WriteValue<std::uint16_t>(file, peerId);
+            WriteValue<std::uint16_t>(file, length);
+            file.write(msg.data.data(), length);
+        }
+    }
+
+    tickCount++;
+}
+
+void ReplayRecorder::Close(std::uint64_t finalStateHash) {
+    if (!file.is_open()) return;
+
+    WriteValue<std::uint8_t>(file, EndMarker);
+    WriteValue<std::uint32_t>(file, tickCount);
+    WriteValue<std::uint64_t>(file, finalStateHash);
+    file.close();
+
+    std::cout << "Replay recording closed after " << tickCount << " ticks" << std::endl;
+}
+
+bool ReplayPlayer::Open(const std::string& path) {
+    file.open(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open replay file: " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    std::uint32_t version = 0;
+    std::uint32_t tickBits = 0;
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, ReplayMagic) ||
+        !ReadValue(file, version) || version != ReplayVersion ||
+        !ReadValue(file, seed) || !ReadValue(file, tickBits)) {
+        std::cerr << "Invalid or unsupported replay file: " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    std::memcpy(&tickSeconds, &tickBits, sizeof(tickSeconds));
+    if (!std::isfinite(tickSeconds) || tickSeconds <= 0.0f) {
+        std::cerr << "Replay file has an invalid tick length: " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    ticksRead = 0;
+    hasFooter = false;
+    return true;
+}
+
+bool ReplayPlayer::ReadTick(InputFrame& input, std::pmr::vector<NetworkMessage>& messages) {
+    messages.clear();
+    if (!file.is_open()) return false;
+
+    std::uint8_t flags = 0;
+    if (!ReadValue(file, flags)) {
+        std::cerr << "Replay ended without footer (truncated recording?)" << std::endl;
+        file.close();
+        return false;
+    }
+
+    if (flags == EndMarker) {
+        hasFooter = ReadValue(file, recordedTicks) && ReadValue(file, finalStateHash);
+        file.close();
+        return false;
+    }
+
+    input.buttons = flags & 0x7F;
+
+    if (flags & HasMessagesFlag) {
+        std::uint16_t count = 0;
+        if (!ReadValue(file, count)) {
+            file.close();
+            return false;
+        }
+        messages.reserve(count);
+        for (std::uint16_t i = 0; i < count; i++) {
+            std::uint16_t peerId = 0;
+            std::uint16_t length = 0;
+            if (!ReadValue(file, peerId) || !ReadValue(file, length)) {
+                file.close();
+                return false;
+            }
+            auto& msg = messages.emplace_back();
+            msg.data.resize(length);
+            if (!file.read(msg.data.data(), length)) {
+                std::cerr << "Replay ended inside a tick (truncated recording?)" << std::endl;
+                messages.clear();
+                file.close();
+                return false;
+            }
+            // Recorded peers no longer exist; handlers must not dereference them
+            msg.peer = nullptr;
+        }
+    }
+
+    ticksRead++;
+    return true;
+}
@@ -0,0 +1,129 @@
+#include "SnapshotRing.h"
+#include <chrono>
+#include <iostream>
+
+namespace {
+    const std::size_t SlotAlignment = alignof(std::max_align_t);
+}
+
+std::size_t SnapshotRing::Slot::allocate(std::size_t bytes) {
+    std::size_t offset = (used + SlotAlignment - 1) & ~(SlotAlignment - 1);
+    if (offset + bytes > block.size()) {
+        // Grow geometrically so a growing world settles after a few snapshots
+        block.resize(std::max(offset + bytes, block.size() * 2));
+    }
+    used = offset + bytes;
+    return offset;
+}
+
+SnapshotRing::SnapshotRing(std::size_t slotCount, std::size_t bytesPerSlot)
+    : slots(slotCount > 0 ? slotCount : 1) {
+    for (auto& slot : slots) {
+        slot.block.resize(bytesPerSlot);
+    }
+}
+
+bool SnapshotRing::contains(std::uint64_t tick) const {
+    const Slot& slot = slots[tick % slots.size()];
+    return slot.valid && slot.tick == tick;
+}
+
+void SnapshotRing::clear() {
+    for (auto& slot : slots) {
+        slot.valid = false;
+    }
+}
+
+bool SnapshotRing::checkRegistered(const entt::registry& registry) const {
+    for (auto [id, storage] : registry.storage()) {
+        if (storage.empty() || id == entt::type_hash<entt::entity>::value()) continue;
+
+        bool registered = false;
+        for (const auto& handler : handlers) {
+            if (handler.id == id) {
+                registered = true;
+                break;
+            }
+        }
+        if (!registered) {
+            std::cerr << "SnapshotRing: component pool '" << storage.type().name()
+                      << "' is not registered for snapshots" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void SnapshotRing::saveSlot(const entt::registry& registry, std::uint64_t tick, const void* extra, std::size_t extraBytes) {
+    auto start = std::chrono::steady_clock::now();
+
+    Slot& slot = slots[tick % slots.size()];
+    slot.valid = false;
+    slot.tick = tick;
+    slot.used = 0;
+    slot.pools.resize(handlers.size());
+    slot.objects.resize(handlers.size());
+
+    // Entity pool: packed array including released entities, so ids and
+    // versions handed out after a restore match the original timeline
+    const auto* entities = registry.storage<entt::entity>();
+    slot.entityCount = entities ? entities->size() : 0;
+    slot.entitiesInUse = entities ? entities->in_use() : 0;
+    slot.entityOffset = slot.allocate(slot.entityCount * sizeof(entt::entity));
+    if (slot.entityCount > 0) {
+        std::memcpy(slot.block.data() + slot.entityOffset, entities->data(), slot.entityCount * sizeof(entt::entity));
+    }
+
+    for (std::size_t i = 0; i < handlers.size(); i++) {
+        handlers[i].save(registry, slot, i);
+    }
+
+    slot.extraBytes = extraBytes;
+    slot.extraOffset = slot.allocate(extraBytes);
+    if (extraBytes > 0) {
+        std::memcpy(slot.block.data() + slot.extraOffset, extra, extraBytes);
+    }
+
+    slot.valid = true;
+    lastSnapshotBytes = slot.used;
+    lastSaveMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool SnapshotRing::restoreSlot(entt::registry& registry, std::uint64_t tick, void* extra, std::size_t extraBytes) const {
+    if (!contains(tick)) {
+        std::cerr << "SnapshotRing: no snapshot for tick " << tick << std::endl;
+        return false;
+    }
+
+    const Slot& slot = slots[tick % slots.size()];
+    if (slot.extraBytes != extraBytes || !checkRegistered(registry)) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Components first, then the entities they belong to
+    for (auto it = handlers.rbegin(); it != handlers.rend(); ++it) {
+        it->clear(registry);
+    }
+
+    auto& entities = registry.storage<entt::entity>();
+    entities.clear();
+    entities.reserve(slot.entityCount);
+    const auto* savedEntities = reinterpret_cast<const entt::entity*>(slot.block.data() + slot.entityOffset);
+    for (std::size_t i = 0; i < slot.entityCount; i++) {
+        entities.emplace(savedEntities[i]);
+    }
+    entities.in_use(slot.entitiesInUse);
+
+    for (std::size_t i = 0; i < handlers.size(); i++) {
+        handlers[i].restore(registry, slot, i);
+    }
+
+    if (extraBytes > 0) {
+        std::memcpy(extra, slot.block.data() + slot.extraOffset, extraBytes);
+    }
+
+    lastRestoreMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
@@ -0,0 +1,403 @@
+#include "Soak.h"
+#include "FrameArena.h"
+#include "MessageBatch.h"
+#include "Prefab.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <boost/filesystem.hpp>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace {
+    // Scenario timeline within one cycle, in seconds
+    constexpr double ModelTime = 2.0;
+    constexpr double ReleaseTime = 5.0;
+    constexpr double SettleTime = 8.0;
+    constexpr double CycleSeconds = 10.0;
+
+    double SecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double Percentile(std::vector<double>& values, double fraction) {
+        if (values.empty()) return 0.0;
+        std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(fraction * values.size()));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    // One tracked metric, read from a sample and shown in the given unit
+    struct Metric {
+        const char* name;
+        const char* unit;
+        double scale;
+        double (*value)(const SoakTest::Sample&);
+        double absoluteLimit;  // in raw units
+        double fractionLimit;
+    };
+}
+
+SoakTest::SoakTest(const SoakConfig& config)
+    : config(config)
+    , startTime(std::chrono::steady_clock::now())
+    , cycleStart(startTime)
+    , lastSampleTime(startTime) {
+    compressor.SetEnabled(config.compression);
+
+    if (!config.reportPath.empty()) {
+        report.open(config.reportPath);
+        if (!report.is_open()) {
+            std::cerr << "Failed to open soak report " << config.reportPath << std::endl;
+        } else {
+            report << "seconds,cycles,resident_bytes,live_allocations,handles,entities,loaded_models,ecs_bytes,"
+                      "bots_connected,frames,frame_p50_ms,frame_p99_ms,frame_max_ms\n";
+        }
+    }
+
+    std::cout << "Soak test: " << config.durationSeconds << " s in " << CycleSeconds << " s cycles of "
+              << config.waveSize << " entities, " << config.botCount << " loopback clients and "
+              << (config.modelPaths.empty() ? "no models" : "one model") << ", sampled every "
+              << config.sampleSeconds << " s" << std::endl;
+}
+
+SoakTest::~SoakTest() {
+    DestroyBots();
+}
+
+bool SoakTest::Step(ECSSystem& ecs, const Prefab* swarm) {
+    ServiceBots();
+
+    double cycleTime = SecondsSince(cycleStart);
+    switch (phase) {
+        case Phase::Idle:
+            break;
+        case Phase::Spawn:
+            if (cycleTime >= ModelTime) {
+                LoadModel(ecs);
+                phase = Phase::LoadModel;
+            }
+            return false;
+        case Phase::LoadModel:
+            if (cycleTime >= ReleaseTime) {
+                DisconnectBots();
+                phase = Phase::Release;
+                return ReleaseWorld(ecs);
+            }
+            return false;
+        case Phase::Release:
+            if (cycleTime >= SettleTime) {
+                DestroyBots();
+                phase = Phase::Settle;
+            }
+            return false;
+        case Phase::Settle:
+            if (cycleTime < CycleSeconds) return false;
+
+            // The world should be back where it was when the cycle started
+            cycles++;
+            if (SecondsSince(lastSampleTime) >= config.sampleSeconds) {
+                TakeSample(ecs);
+            }
+            phase = Phase::Idle;
+            break;
+    }
+
+    if (SecondsSince(startTime) >= config.durationSeconds) return false;
+
+    cycleStart = std::chrono::steady_clock::now();
+    SpawnWave(ecs, swarm);
+    ConnectBots();
+    phase = Phase::Spawn;
+    return false;
+}
+
+void SoakTest::AddFrameTime(double milliseconds) {
+    frameTimes.push_back(milliseconds);
+}
+
+bool SoakTest::IsFinished() const {
+    return phase == Phase::Idle && SecondsSince(startTime) >= config.durationSeconds;
+}
+
+void SoakTest::SpawnWave(ECSSystem& ecs, const Prefab* swarm) {
+    if (!swarm || config.waveSize == 0) return;
+
+    // A fixed ring around the start area, so every cycle spawns the same world
+    waveEntities.clear();
+    ecs.spawnPrefab(*swarm, config.waveSize, waveEntities);
+    if (!swarm->has<ECSTransform>()) return;
+    for (std::size_t i = 0; i < waveEntities.size(); i++) {
+        float angle = static_cast<float>(i) * (2.0f * PI / static_cast<float>(waveEntities.size()));
+        float distance = 300.0f + static_cast<float>((i * 37) % 1000);
+        ecs.getComponent<ECSTransform>(waveEntities[i]).position = {
+            400.0f + std::cos(angle) * distance,
+            300.0f + std::sin(angle) * distance
+        };
+    }
+}
+
+void SoakTest::LoadModel(ECSSystem& ecs) {
+    if (config.modelPaths.empty()) return;
+
+    const std::string& path = config.modelPaths[cycles % config.modelPaths.size()];
+    modelEntity = ecs.createEntity();
+    ecs.addComponent(modelEntity, ECSTransform{{400.0f, 200.0f}});
+    ecs.addComponent(modelEntity, Model3D{});
+    if (!ecs.loadModel3D(modelEntity, path, 20.0f)) {
+        ecs.destroyEntity(modelEntity);
+        modelEntity = entt::null;
+    }
+}
+
+bool SoakTest::ReleaseWorld(ECSSystem& ecs) {
+    entt::registry& registry = ecs.getRegistry();
+    for (entt::entity entity : waveEntities) {
+        if (registry.valid(entity)) {
+            registry.destroy(entity);
+        }
+    }
+    waveEntities.clear();
+
+    if (modelEntity != entt::null && registry.valid(modelEntity)) {
+        registry.destroy(modelEntity);
+    }
+    modelEntity = entt::null;
+    return ecs.releaseUnusedModels() > 0;
+}
+
+void SoakTest::ConnectBots() {
+    if (config.botCount == 0) return;
+
+    botHost = enet_host_create(nullptr, config.botCount, 2, 0, 0);
+    if (botHost == nullptr) {
+        std::cerr << "Soak test: failed to create client host" << std::endl;
+        return;
+    }
+
+    ENetAddress address;
+    enet_address_set_host(&address, "127.0.0.1");
+    address.port = static_cast<enet_uint16>(config.port);
+    for (std::size_t i = 0; i < config.botCount; i++) {
+        enet_host_connect(botHost, &address, 2, 0);
+    }
+}
+
+void SoakTest::DisconnectBots() {
+    if (!botHost) return;
+
+    // Graceful where connected; attempts still in progress are dropped
+    for (std::size_t i = 0; i < botHost->peerCount; i++) {
+        ENetPeer* peer = &botHost->peers[i];
+        if (peer->state == ENET_PEER_STATE_CONNECTED) {
+            enet_peer_disconnect(peer, 0);
+        } else if (peer->state != ENET_PEER_STATE_DISCONNECTED) {
+            enet_peer_reset(peer);
+        }
+    }
+    enet_host_flush(botHost);
+}
+
+void SoakTest::DestroyBots() {
+    if (!botHost) return;
+
+    enet_host_destroy(botHost);
+    botHost = nullptr;
+    botsConnected = 0;
+}
+
+void SoakTest::ServiceBots() {
+    if (!botHost) return;
+
+    ENetEvent event;
+    while (enet_host_service(botHost, &event, 0) > 0) {
+        switch (event.type) {
+            case ENET_EVENT_TYPE_CONNECT: {
+                botsConnected++;
+                peakBotsConnected = std::max(peakBotsConnected, botsConnected);
+
+                // One position update, through the same batch format as real clients
+                MessageBatch batch;
+                batch.Append("POS:400.00,300.00");
+                ENetPeer* peer = event.peer;
+                batch.Flush(MessageChannel::State, compressor, [peer](ENetPacket* packet) {
+                    if (enet_peer_send(peer, static_cast<enet_uint8>(MessageChannel::State), packet) != 0) {
+                        enet_packet_destroy(packet);
+                    }
+                });
+                break;
+            }
+            case ENET_EVENT_TYPE_DISCONNECT:
+                botsConnected = botsConnected > 0 ? botsConnected - 1 : 0;
+                break;
+            case ENET_EVENT_TYPE_RECEIVE:
+                enet_packet_destroy(event.packet);
+                break;
+            default:
+                break;
+        }
+    }
+    enet_host_flush(botHost);
+}
+
+void SoakTest::TakeSample(ECSSystem& ecs) {
+    Sample sample;
+    sample.seconds = SecondsSince(startTime);
+    sample.cycles = cycles;
+    sample.residentBytes = GetResidentBytes();
+    sample.liveAllocations = FrameArena::GetHeapAllocationCount() - FrameArena::GetHeapFreeCount();
+    sample.handles = GetOpenHandleCount();
+    sample.entities = ecs.getRegistry().storage<entt::entity>().in_use();
+    sample.loadedModels = ecs.getLoadedModelCount();
+    ecs.collectMemoryStats(memoryStats);
+    sample.ecsBytes = memoryStats.totalBytes;
+    sample.botsConnected = peakBotsConnected;
+    sample.frames = frameTimes.size();
+    sample.frameP50 = Percentile(frameTimes, 0.50);
+    sample.frameP99 = Percentile(frameTimes, 0.99);
+    sample.frameMax = frameTimes.empty() ? 0.0 : *std::max_element(frameTimes.begin(), frameTimes.end());
+    samples.push_back(sample);
+
+    frameTimes.clear();
+    peakBotsConnected = 0;
+    lastSampleTime = std::chrono::steady_clock::now();
+
+    if (samples.size() == 1) {
+        std::printf("%8s %7s %9s %10s %7s %8s %6s %9s %5s %8s %8s %8s\n", "seconds", "cycles", "RSS MB", "live allocs",
+                    "handles", "entities", "models", "ECS KB", "bots", "p50 ms", "p99 ms", "max ms");
+    }
+    std::printf("%8.0f %7zu %9.1f %10zu %7zu %8zu %6zu %9zu %5zu %8.2f %8.2f %8.2f\n", sample.seconds, sample.cycles,
+                sample.residentBytes / (1024.0 * 1024.0), sample.liveAllocations, sample.handles, sample.entities,
+                sample.loadedModels, sample.ecsBytes / 1024, sample.botsConnected, sample.frameP50, sample.frameP99,
+                sample.frameMax);
+    std::fflush(stdout);
+
+    if (report.is_open()) {
+        report << sample.seconds << ',' << sample.cycles << ',' << sample.residentBytes << ',' << sample.liveAllocations << ','
+               << sample.handles << ',' << sample.entities << ',' << sample.loadedModels << ',' << sample.ecsBytes << ','
+               << sample.botsConnected << ',' << sample.frames << ',' << sample.frameP50 << ',' << sample.frameP99 << ','
+               << sample.frameMax << '\n';
+        report.flush();
+    }
+}
+
+bool SoakTest::Finish(ECSSystem& ecs) {
+    ReleaseWorld(ecs);
+    DestroyBots();
+    phase = Phase::Idle;
+
+    // The first fifth of the run is warm-up (pools, caches and the frame
+    // arena growing to their working size); what is left is split in thirds
+    // and the median of the last third is compared with the first
+    std::size_t warmup = std::max<std::size_t>(1, samples.size() / 5);
+    std::size_t measured = samples.size() > warmup ? samples.size() - warmup : 0;
+    if (measured < 6) {
+        std::cout << "Soak test: " << samples.size() << " samples, too few to judge trends (run for at least "
+                  << 8 * std::max(config.sampleSeconds, CycleSeconds) << " s)" << std::endl;
+        return true;
+    }
+    std::size_t third = measured / 3;
+
+    const SoakThresholds& limits = config.thresholds;
+    const Metric metrics[] = {
+        {"resident memory", "MB", 1.0 / (1024 * 1024), [](const Sample& s) { return static_cast<double>(s.residentBytes); },
+         limits.residentBytes, limits.residentFraction},
+        {"live heap allocations", "", 1.0, [](const Sample& s) { return static_cast<double>(s.liveAllocations); },
+         limits.liveAllocations, limits.allocationFraction},
+        {"open handles", "", 1.0, [](const Sample& s) { return static_cast<double>(s.handles); },
+         limits.handles, 0.0},
+        {"entities", "", 1.0, [](const Sample& s) { return static_cast<double>(s.entities); },
+         limits.entities, 0.0},
+        {"loaded models", "", 1.0, [](const Sample& s) { return static_cast<double>(s.loadedModels); },
+         limits.loadedModels, 0.0},
+        {"ECS pool memory", "KB", 1.0 / 1024, [](const Sample& s) { return static_cast<double>(s.ecsBytes); },
+         limits.ecsBytes, limits.ecsFraction},
+        {"p99 frame time", "ms", 1.0, [](const Sample& s) { return s.frameP99; },
+         limits.frameMilliseconds, limits.frameFraction},
+    };
+
+    bool passed = true;
+    std::vector<double> values;
+    for (const Metric& metric : metrics) {
+        values.clear();
+        for (std::size_t i = warmup; i < warmup + third; i++) {
+            values.push_back(metric.value(samples[i]));
+        }
+        double start = Percentile(values, 0.5);
+        values.clear();
+        for (std::size_t i = samples.size() - third; i < samples.size(); i++) {
+            values.push_back(metric.value(samples[i]));
+        }
+        double end = Percentile(values, 0.5);
+
+        double growth = end - start;
+        double limit = std::max(metric.absoluteLimit, metric.fractionLimit * start);
+        bool regressed = growth > limit;
+        passed = passed && !regressed;
+        std::printf("Soak %-22s %10.1f -> %10.1f %-2s (%+.1f, limit +%.1f) %s\n", metric.name, start * metric.scale,
+                    end * metric.scale, metric.unit, growth * metric.scale, limit * metric.scale,
+                    regressed ? "REGRESSED" : "ok");
+    }
+    std::fflush(stdout);
+
+    std::cout << "Soak test " << (passed ? "passed" : "FAILED") << " after " << cycles << " cycles" << std::endl;
+    return passed;
+}
+
+std::size_t SoakTest::GetResidentBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<std::size_t>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return static_cast<std::size_t>(info.resident_size);
+    }
+    return 0;
+#elif defined(__linux__)
+    // Second field of statm: resident pages
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    int fields = std::fscanf(statm, "%llu %llu", &size, &resident);
+    std::fclose(statm);
+    return fields == 2 ? static_cast<std::size_t>(resident * static_cast<unsigned long long>(sysconf(_SC_PAGESIZE))) : 0;
+#else
+    return 0;
+#endif
+}
+
+std::size_t SoakTest::GetOpenHandleCount() {
+#if defined(_WIN32)
+    DWORD handles = 0;
+    return GetProcessHandleCount(GetCurrentProcess(), &handles) ? static_cast<std::size_t>(handles) : 0;
+#elif defined(__linux__) || defined(__APPLE__)
+    // Open file descriptors, which include sockets
+#if defined(__linux__)
+    const char* directory = "/proc/self/fd";
+#else
+    const char* directory = "/dev/fd";
+#endif
+    boost::system::error_code error;
+    std::size_t count = 0;
+    for (boost::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        count++;
+    }
+    return count;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,380 @@
+#include "SpriteAtlas.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <boost/filesystem.hpp>
+
+namespace {
+    const char* AtlasMagic = "GEATLAS";
+    const int AtlasVersion = 1;
+
+    // Bottom-left skyline packer: the top edge of the packed area is a list of
+    // horizontal segments, and each rectangle goes where its top ends lowest
+    class Skyline {
+    public:
+        Skyline(int width, int height) : width(width), height(height) {
+            nodes.push_back(Node{0, 0, width});
+        }
+
+        bool insert(int rectWidth, int rectHeight, int& outX, int& outY) {
+            int bestTop = INT_MAX;
+            int bestWidth = INT_MAX;
+            std::size_t bestIndex = nodes.size();
+            for (std::size_t i = 0; i < nodes.size(); i++) {
+                int y = 0;
+                if (!fits(i, rectWidth, rectHeight, y)) continue;
+                if (y + rectHeight < bestTop || (y + rectHeight == bestTop && nodes[i].width < bestWidth)) {
+                    bestTop = y + rectHeight;
+                    bestWidth = nodes[i].width;
+                    bestIndex = i;
+                    outX = nodes[i].x;
+                    outY = y;
+                }
+            }
+            if (bestIndex == nodes.size()) return false;
+
+            nodes.insert(nodes.begin() + bestIndex, Node{outX, outY + rectHeight, rectWidth});
+
+            // Cut back the segments now covered by the new one
+            for (std::size_t i = bestIndex + 1; i < nodes.size();) {
+                const Node& previous = nodes[i - 1];
+                int shrink = previous.x + previous.width - nodes[i].x;
+                if (shrink <= 0) break;
+                nodes[i].x += shrink;
+                nodes[i].width -= shrink;
+                if (nodes[i].width > 0) break;
+                nodes.erase(nodes.begin() + i);
+            }
+
+            // Merge neighbours at the same height
+            for (std::size_t i = 0; i + 1 < nodes.size();) {
+                if (nodes[i].y == nodes[i + 1].y) {
+                    nodes[i].width += nodes[i + 1].width;
+                    nodes.erase(nodes.begin() + i + 1);
+                } else {
+                    i++;
+                }
+            }
+            return true;
+        }
+
+    private:
+        struct Node {
+            int x;
+            int y;
+            int width;
+        };
+
+        bool fits(std::size_t index, int rectWidth, int rectHeight, int& y) const {
+            if (nodes[index].x + rectWidth > width) return false;
+
+            y = nodes[index].y;
+            int remaining = rectWidth;
+            for (std::size_t i = index; remaining > 0; i++) {
+                if (i == nodes.size()) return false;
+                y = std::max(y, nodes[i].y);
+                if (y + rectHeight > height) return false;
+                remaining -= nodes[i].width;
+            }
+            return true;
+        }
+
+        int width;
+        int height;
+        std::vector<Node> nodes;
+    };
+
+    std::string PagePath(const std::string& basePath, std::size_t page) {
+        return basePath + "_" + std::to_string(page) + ".png";
+    }
+
+    // Written that way, NaN coordinates fail every comparison
+    bool InsidePage(const Rectangle& rect, int pageSize) {
+        float size = static_cast<float>(pageSize);
+        return rect.x >= 0.0f && rect.y >= 0.0f && rect.width >= 1.0f && rect.height >= 1.0f &&
+               rect.x + rect.width <= size && rect.y + rect.height <= size;
+    }
+}
+
+SpriteAtlas::~SpriteAtlas() {
+    // Textures belong to the GL context; the owner unloads them before closing the window
+    for (Image& image : pageImages) {
+        UnloadImage(image);
+    }
+}
+
+std::vector<AtlasSource> SpriteAtlas::getDefaultSources(const std::string& assetsRoot) {
+    return {
+        {assetsRoot + "/Side", "Side/", 1.0f},
+        {assetsRoot + "/Isometric", "Isometric/", 0.25f}
+    };
+}
+
+void SpriteAtlas::clear() {
+    for (Image& image : pageImages) {
+        UnloadImage(image);
+    }
+    pageImages.clear();
+    unloadTextures();
+    regions.clear();
+    regionIds.clear();
+    pageCount = 0;
+}
+
+bool SpriteAtlas::isCacheCurrent(const std::string& basePath, const std::vector<AtlasSource>& sources) {
+    boost::system::error_code error;
+    std::time_t cacheTime = boost::filesystem::last_write_time(basePath + ".atlas", error);
+    if (error) return false;
+
+    // A directory's time changes when files are added or removed, a file's when it is edited
+    for (const AtlasSource& source : sources) {
+        if (!boost::filesystem::is_directory(source.directory, error)) continue;
+        if (boost::filesystem::last_write_time(source.directory, error) > cacheTime) return false;
+        for (const auto& entry : boost::filesystem::directory_iterator(source.directory, error)) {
+            if (entry.path().extension() == ".png" && boost::filesystem::last_write_time(entry.path(), error) > cacheTime) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool SpriteAtlas::build(const std::vector<AtlasSource>& sources, int size) {
+    auto start = std::chrono::steady_clock::now();
+    clear();
+    pageSize = size;
+
+    // Load, scale and trim every image; region ids follow the sorted file order
+    std::vector<Image> images;
+    for (const AtlasSource& source : sources) {
+        if (!boost::filesystem::is_directory(source.directory)) {
+            std::cerr << "Atlas source directory not found: " << source.directory << std::endl;
+            continue;
+        }
+
+        std::vector<boost::filesystem::path> files;
+        for (const auto& entry : boost::filesystem::directory_iterator(source.directory)) {
+            if (boost::filesystem::is_regular_file(entry) && entry.path().extension() == ".png") {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files) {
+            Image image = LoadImage(file.string().c_str());
+            if (image.data == nullptr) {
+                std::cerr << "Failed to load sprite " << file.string() << std::endl;
+                continue;
+            }
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            if (source.scale != 1.0f) {
+                ImageResize(&image, std::max(1, static_cast<int>(std::lround(image.width * source.scale))),
+                            std::max(1, static_cast<int>(std::lround(image.height * source.scale))));
+            }
+
+            AtlasRegion region;
+            region.name = source.prefix + file.stem().string();
+            region.size = {static_cast<float>(image.width), static_cast<float>(image.height)};
+
+            // Fully transparent images keep one texel so they still have a region
+            Rectangle opaque = GetImageAlphaBorder(image, 0.0f);
+            if (opaque.width < 1.0f || opaque.height < 1.0f) {
+                opaque = {0.0f, 0.0f, 1.0f, 1.0f};
+            }
+            ImageCrop(&image, opaque);
+            region.trimOffset = {opaque.x, opaque.y};
+
+            if (image.width + 2 * Padding > pageSize || image.height + 2 * Padding > pageSize) {
+                std::cerr << "Sprite " << region.name << " does not fit a " << pageSize << " px atlas page" << std::endl;
+                UnloadImage(image);
+                continue;
+            }
+
+            regions.push_back(region);
+            images.push_back(image);
+        }
+    }
+
+    // Tallest first packs tighter; each sprite goes on the first page with room
+    std::vector<std::size_t> order(regions.size());
+    for (std::size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&images](std::size_t a, std::size_t b) {
+        return images[a].height != images[b].height ? images[a].height > images[b].height : images[a].width > images[b].width;
+    });
+
+    std::vector<Skyline> pages;
+    for (std::size_t index : order) {
+        // Padding on the right and bottom of every sprite, plus once at the page's top-left
+        int width = images[index].width + Padding;
+        int height = images[index].height + Padding;
+        int x = 0;
+        int y = 0;
+        std::size_t page = 0;
+        while (page < pages.size() && !pages[page].insert(width, height, x, y)) {
+            page++;
+        }
+        if (page == pages.size()) {
+            pages.emplace_back(pageSize - Padding, pageSize - Padding);
+            pages.back().insert(width, height, x, y);
+        }
+
+        AtlasRegion& region = regions[index];
+        region.page = static_cast<std::uint16_t>(page);
+        region.source = {static_cast<float>(x + Padding), static_cast<float>(y + Padding),
+                         static_cast<float>(images[index].width), static_cast<float>(images[index].height)};
+    }
+
+    // Copy each sprite's rows into its page
+    pageCount = pages.size();
+    for (std::size_t page = 0; page < pageCount; page++) {
+        pageImages.push_back(GenImageColor(pageSize, pageSize, BLANK));
+    }
+    for (std::size_t i = 0; i < regions.size(); i++) {
+        const AtlasRegion& region = regions[i];
+        Image& page = pageImages[region.page];
+        const auto* from = static_cast<const unsigned char*>(images[i].data);
+        auto* to = static_cast<unsigned char*>(page.data);
+        std::size_t rowBytes = static_cast<std::size_t>(images[i].width) * 4;
+        for (int row = 0; row < images[i].height; row++) {
+            std::size_t target = (static_cast<std::size_t>(region.source.y) + row) * pageSize * 4 +
+                                 static_cast<std::size_t>(region.source.x) * 4;
+            std::memcpy(to + target, from + row * rowBytes, rowBytes);
+        }
+        UnloadImage(images[i]);
+        regionIds[region.name] = static_cast<std::uint32_t>(i);
+    }
+
+    lastMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Built sprite atlas: " << regions.size() << " sprites on " << pageCount << " pages of "
+              << pageSize << " px in " << lastMilliseconds << " ms" << std::endl;
+    return !regions.empty();
+}
+
+bool SpriteAtlas::save(const std::string& basePath) const {
+    if (pageImages.size() != pageCount) {
+        std::cerr << "Atlas pages are already on the GPU, cannot save" << std::endl;
+        return false;
+    }
+
+    for (std::size_t page = 0; page < pageCount; page++) {
+        if (!ExportImage(pageImages[page], PagePath(basePath, page).c_str())) {
+            std::cerr << "Failed to write atlas page " << PagePath(basePath, page) << std::endl;
+            return false;
+        }
+    }
+
+    // Text index: header, then one line per region (names contain no spaces)
+    std::ofstream index(basePath + ".atlas", std::ios::trunc);
+    if (!index) {
+        std::cerr << "Failed to write atlas index " << basePath << ".atlas" << std::endl;
+        return false;
+    }
+    index << AtlasMagic << ' ' << AtlasVersion << ' ' << pageCount << ' ' << pageSize << ' ' << regions.size() << '\n';
+    for (const AtlasRegion& region : regions) {
+        index << region.name << ' ' << region.page << ' '
+              << region.source.x << ' ' << region.source.y << ' ' << region.source.width << ' ' << region.source.height << ' '
+              << region.trimOffset.x << ' ' << region.trimOffset.y << ' ' << region.size.x << ' ' << region.size.y << '\n';
+    }
+    return static_cast<bool>(index);
+}
+
+bool SpriteAtlas::load(const std::string& basePath) {
+    auto start = std::chrono::steady_clock::now();
+    clear();
+
+    std::ifstream index(basePath + ".atlas");
+    if (!index) {
+        return false;
+    }
+
+    std::string magic;
+    int version = 0;
+    std::size_t regionCount = 0;
+    if (!(index >> magic >> version >> pageCount >> pageSize >> regionCount) || magic != AtlasMagic || version != AtlasVersion) {
+        std::cerr << "Unsupported atlas index " << basePath << ".atlas" << std::endl;
+        clear();
+        return false;
+    }
+    // Every page holds at least one region
+    if (pageSize <= 2 * Padding || pageSize > MaxPageSize || pageCount == 0 || pageCount > regionCount) {
+        std::cerr << "Malformed atlas index " << basePath << ".atlas" << std::endl;
+        clear();
+        return false;
+    }
+
+    // The count is only trusted as far as the index actually has lines for it
+    regions.reserve(std::min<std::size_t>(regionCount, 4096));
+    for (std::size_t i = 0; i < regionCount; i++) {
+        AtlasRegion region;
+        if (!(index >> region.name >> region.page >> region.source.x >> region.source.y >> region.source.width >> region.source.height
+                    >> region.trimOffset.x >> region.trimOffset.y >> region.size.x >> region.size.y) ||
+            region.page >= pageCount || !InsidePage(region.source, pageSize) ||
+            !(region.trimOffset.x >= 0.0f && region.trimOffset.y >= 0.0f) ||
+            !(region.size.x >= region.trimOffset.x + region.source.width && region.size.y >= region.trimOffset.y + region.source.height)) {
+            std::cerr << "Malformed atlas index " << basePath << ".atlas" << std::endl;
+            clear();
+            return false;
+        }
+        regionIds[region.name] = static_cast<std::uint32_t>(i);
+        regions.push_back(std::move(region));
+    }
+
+    for (std::size_t page = 0; page < pageCount; page++) {
+        Image image = LoadImage(PagePath(basePath, page).c_str());
+        if (image.data == nullptr) {
+            std::cerr << "Failed to load atlas page " << PagePath(basePath, page) << std::endl;
+            clear();
+            return false;
+        }
+        if (image.width != pageSize || image.height != pageSize) {
+            std::cerr << "Atlas page " << PagePath(basePath, page) << " is not " << pageSize << " px" << std::endl;
+            UnloadImage(image);
+            clear();
+            return false;
+        }
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        pageImages.push_back(image);
+    }
+
+    lastMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Loaded sprite atlas " << basePath << ": " << regions.size() << " sprites on " << pageCount
+              << " pages in " << lastMilliseconds << " ms" << std::endl;
+    return true;
+}
+
+bool SpriteAtlas::uploadTextures() {
+    unloadTextures();
+    for (const Image& image : pageImages) {
+        Texture2D texture = LoadTextureFromImage(image);
+        if (texture.id == 0) {
+            std::cerr << "Failed to upload atlas page texture" << std::endl;
+            unloadTextures();
+            return false;
+        }
+        SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+        pageTextures.push_back(texture);
+    }
+
+    for (Image& image : pageImages) {
+        UnloadImage(image);
+    }
+    pageImages.clear();
+    return true;
+}
+
+void SpriteAtlas::unloadTextures() {
+    for (const Texture2D& texture : pageTextures) {
+        UnloadTexture(texture);
+    }
+    pageTextures.clear();
+}
+
+std::uint32_t SpriteAtlas::findRegion(const std::string& name) const {
+    auto found = regionIds.find(name);
+    return found != regionIds.end() ? found->second : InvalidRegion;
+}
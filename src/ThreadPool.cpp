@@ -0,0 +1,86 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+    : nextIndex(0) {
+#ifndef __EMSCRIPTEN__
+    if (threadCount == 0) {
+        threadCount = std::max(1u, boost::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 1; i < threadCount; i++) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+#else
+    (void)threadCount;
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain, const RangeTask& rangeTask) {
+    if (count == 0) return;
+    grain = std::max<std::size_t>(1, grain);
+
+    // Not worth waking anyone for a single range
+    if (workers.empty() || count <= grain) {
+        rangeTask(0, count);
+        return;
+    }
+
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        task = &rangeTask;
+        taskCount = count;
+        taskGrain = grain;
+        nextIndex = 0;
+        busyWorkers = workers.size();
+        generation++;
+    }
+    workReady.notify_all();
+
+    runRanges();
+
+    boost::unique_lock<boost::mutex> lock(mutex);
+    workDone.wait(lock, [this]() { return busyWorkers == 0; });
+    task = nullptr;
+}
+
+void ThreadPool::runRanges() {
+    for (;;) {
+        std::size_t begin = nextIndex.fetch_add(taskGrain);
+        if (begin >= taskCount) break;
+        (*task)(begin, std::min(begin + taskGrain, taskCount));
+    }
+}
+
+void ThreadPool::workerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            workReady.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        runRanges();
+
+        bool last = false;
+        {
+            boost::lock_guard<boost::mutex> lock(mutex);
+            last = --busyWorkers == 0;
+        }
+        if (last) {
+            workDone.notify_one();
+        }
+    }
+}
@@ -0,0 +1,249 @@
+#include "TileMap.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // Rounds towards negative infinity so tiles left of or above 0 get their own chunks
+    int FloorDiv(int value, int divisor) {
+        int quotient = value / divisor;
+        return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+    }
+
+    Rectangle Union(Rectangle a, Rectangle b) {
+        float left = std::min(a.x, b.x);
+        float top = std::min(a.y, b.y);
+        float right = std::max(a.x + a.width, b.x + b.width);
+        float bottom = std::max(a.y + a.height, b.y + b.height);
+        return {left, top, right - left, bottom - top};
+    }
+}
+
+TileMap::TileMap(const SpriteAtlas& spriteAtlas, const TileMapConfig& tileConfig)
+    : atlas(spriteAtlas)
+    , config(tileConfig) {
+    config.chunkSize = std::max(1, config.chunkSize);
+    config.maxRebuildsPerFrame = std::max(1, config.maxRebuildsPerFrame);
+}
+
+std::uint64_t TileMap::chunkKey(int chunkX, int chunkY) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32) | static_cast<std::uint32_t>(chunkY);
+}
+
+Vector2 TileMap::tileToWorld(int x, int y) const {
+    if (config.isometric) {
+        return {config.origin.x + (x - y) * config.tileWidth * 0.5f,
+                config.origin.y + (x + y) * config.tileHeight * 0.5f};
+    }
+    return {config.origin.x + x * config.tileWidth, config.origin.y + y * config.tileHeight};
+}
+
+void TileMap::worldToTile(Vector2 position, int& x, int& y) const {
+    float relativeX = (position.x - config.origin.x) / config.tileWidth;
+    float relativeY = (position.y - config.origin.y) / config.tileHeight;
+    if (config.isometric) {
+        x = static_cast<int>(std::lround(relativeY + relativeX));
+        y = static_cast<int>(std::lround(relativeY - relativeX));
+    } else {
+        x = static_cast<int>(std::lround(relativeX));
+        y = static_cast<int>(std::lround(relativeY));
+    }
+}
+
+Rectangle TileMap::tileRect(int x, int y, std::uint32_t region) const {
+    // Same placement as a sprite: the trimmed image sits where it was in the original
+    const AtlasRegion& atlasRegion = atlas.getRegion(region);
+    Vector2 centre = tileToWorld(x, y);
+    float scale = config.tileScale;
+    return {centre.x + (atlasRegion.trimOffset.x - atlasRegion.size.x * config.anchor.x) * scale,
+            centre.y + (atlasRegion.trimOffset.y - atlasRegion.size.y * config.anchor.y) * scale,
+            atlasRegion.source.width * scale, atlasRegion.source.height * scale};
+}
+
+void TileMap::setTile(int x, int y, std::uint32_t region) {
+    if (region != EmptyTile && region >= atlas.getRegionCount()) return;
+
+    int chunkX = FloorDiv(x, config.chunkSize);
+    int chunkY = FloorDiv(y, config.chunkSize);
+    std::uint64_t key = chunkKey(chunkX, chunkY);
+    auto found = chunks.find(key);
+    if (found == chunks.end()) {
+        if (region == EmptyTile) return;
+        auto chunk = std::make_unique<Chunk>();
+        chunk->chunkX = chunkX;
+        chunk->chunkY = chunkY;
+        chunk->tiles.assign(static_cast<std::size_t>(config.chunkSize) * config.chunkSize, EmptyTile);
+        chunk->bounds = tileRect(x, y, region);
+        found = chunks.emplace(key, std::move(chunk)).first;
+    }
+
+    Chunk& chunk = *found->second;
+    std::uint32_t& tile = chunk.tiles[static_cast<std::size_t>(y - chunkY * config.chunkSize) * config.chunkSize +
+                                      (x - chunkX * config.chunkSize)];
+    if (tile == region) return;
+
+    if (tile == EmptyTile) chunk.tileCount++;
+    if (region == EmptyTile) chunk.tileCount--;
+    tile = region;
+    chunk.dirty = true;
+
+    if (chunk.tileCount == 0) {
+        releaseTarget(chunk);
+        chunks.erase(found);
+        return;
+    }
+    // Grow now so culling stays correct until the rebuild recomputes it exactly
+    if (region != EmptyTile) {
+        chunk.bounds = Union(chunk.bounds, tileRect(x, y, region));
+    }
+}
+
+std::uint32_t TileMap::getTile(int x, int y) const {
+    int chunkX = FloorDiv(x, config.chunkSize);
+    int chunkY = FloorDiv(y, config.chunkSize);
+    auto found = chunks.find(chunkKey(chunkX, chunkY));
+    if (found == chunks.end()) return EmptyTile;
+    return found->second->tiles[static_cast<std::size_t>(y - chunkY * config.chunkSize) * config.chunkSize +
+                                (x - chunkX * config.chunkSize)];
+}
+
+void TileMap::fill(int x, int y, int width, int height, std::uint32_t region) {
+    for (int row = y; row < y + height; row++) {
+        for (int column = x; column < x + width; column++) {
+            setTile(column, row, region);
+        }
+    }
+}
+
+void TileMap::clear() {
+    unloadTextures();
+    chunks.clear();
+    visible.clear();
+}
+
+void TileMap::rebuildChunk(Chunk& chunk) {
+    // Exact bounds, snapped to whole pixels so the texture maps 1:1 to the screen
+    int firstX = chunk.chunkX * config.chunkSize;
+    int firstY = chunk.chunkY * config.chunkSize;
+    bool first = true;
+    Rectangle bounds = {0, 0, 0, 0};
+    for (int row = 0; row < config.chunkSize; row++) {
+        for (int column = 0; column < config.chunkSize; column++) {
+            std::uint32_t region = chunk.tiles[static_cast<std::size_t>(row) * config.chunkSize + column];
+            if (region == EmptyTile) continue;
+            Rectangle rect = tileRect(firstX + column, firstY + row, region);
+            bounds = first ? rect : Union(bounds, rect);
+            first = false;
+        }
+    }
+    float left = std::floor(bounds.x);
+    float top = std::floor(bounds.y);
+    chunk.bounds = {left, top, std::ceil(bounds.x + bounds.width) - left, std::ceil(bounds.y + bounds.height) - top};
+
+    int width = std::max(1, static_cast<int>(chunk.bounds.width));
+    int height = std::max(1, static_cast<int>(chunk.bounds.height));
+    if (chunk.hasTarget && (chunk.target.texture.width != width || chunk.target.texture.height != height)) {
+        releaseTarget(chunk);
+    }
+    if (!chunk.hasTarget) {
+        chunk.target = LoadRenderTexture(width, height);
+        chunk.hasTarget = chunk.target.id != 0;
+        if (!chunk.hasTarget) return;
+    }
+
+    // Row by row is back to front for both layouts. Colour is premultiplied
+    // while drawing into the transparent target, so edges blend correctly when
+    // the chunk is composited with BLEND_ALPHA_PREMULTIPLY.
+    BeginTextureMode(chunk.target);
+    ClearBackground(BLANK);
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    for (int row = 0; row < config.chunkSize; row++) {
+        for (int column = 0; column < config.chunkSize; column++) {
+            std::uint32_t region = chunk.tiles[static_cast<std::size_t>(row) * config.chunkSize + column];
+            if (region == EmptyTile) continue;
+            const AtlasRegion& atlasRegion = atlas.getRegion(region);
+            Rectangle rect = tileRect(firstX + column, firstY + row, region);
+            rect.x -= chunk.bounds.x;
+            rect.y -= chunk.bounds.y;
+            DrawTexturePro(atlas.getPageTexture(atlasRegion.page), atlasRegion.source, rect, {0.0f, 0.0f}, 0.0f, WHITE);
+        }
+    }
+    EndBlendMode();
+    EndTextureMode();
+    chunk.dirty = false;
+}
+
+void TileMap::releaseTarget(Chunk& chunk) {
+    if (chunk.hasTarget) {
+        UnloadRenderTexture(chunk.target);
+        chunk.target = RenderTexture2D{};
+        chunk.hasTarget = false;
+    }
+}
+
+void TileMap::render(Vector2 cameraOffset) {
+    frame++;
+    stats.rebuilds = 0;
+    stats.rebuildMicroseconds = 0.0;
+    if (!atlas.hasTextures()) return;
+
+    // Visible chunks in row order, which keeps overhanging tiles back to front
+    Rectangle view = {cameraOffset.x, cameraOffset.y, static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())};
+    visible.clear();
+    stats.tiles = 0;
+    stats.residentTextures = 0;
+    stats.textureBytes = 0;
+    for (auto& entry : chunks) {
+        Chunk& chunk = *entry.second;
+        stats.tiles += chunk.tileCount;
+        if (CheckCollisionRecs(chunk.bounds, view)) {
+            chunk.lastVisibleFrame = frame;
+            visible.push_back(&chunk);
+        } else if (chunk.hasTarget && frame - chunk.lastVisibleFrame > static_cast<std::uint64_t>(config.evictAfterFrames)) {
+            // Rebuilt from the tile data if it comes back into view
+            releaseTarget(chunk);
+            chunk.dirty = true;
+        }
+        if (chunk.hasTarget) {
+            stats.residentTextures++;
+            stats.textureBytes += static_cast<std::size_t>(chunk.target.texture.width) * chunk.target.texture.height * 4;
+        }
+    }
+    std::sort(visible.begin(), visible.end(), [](const Chunk* a, const Chunk* b) {
+        return a->chunkY != b->chunkY ? a->chunkY < b->chunkY : a->chunkX < b->chunkX;
+    });
+    stats.chunks = chunks.size();
+    stats.visibleChunks = visible.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (Chunk* chunk : visible) {
+        if ((chunk->dirty || !chunk->hasTarget) && stats.rebuilds < static_cast<std::size_t>(config.maxRebuildsPerFrame)) {
+            rebuildChunk(*chunk);
+            stats.rebuilds++;
+        }
+    }
+    if (stats.rebuilds > 0) {
+        stats.rebuildMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Render textures are stored bottom-up, hence the negative source height
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    for (const Chunk* chunk : visible) {
+        if (!chunk->hasTarget) continue;
+        const Texture2D& texture = chunk->target.texture;
+        Rectangle source = {0.0f, 0.0f, static_cast<float>(texture.width), -static_cast<float>(texture.height)};
+        Rectangle destination = {chunk->bounds.x - cameraOffset.x, chunk->bounds.y - cameraOffset.y,
+                                 static_cast<float>(texture.width), static_cast<float>(texture.height)};
+        DrawTexturePro(texture, source, destination, {0.0f, 0.0f}, 0.0f, WHITE);
+    }
+    EndBlendMode();
+}
+
+void TileMap::unloadTextures() {
+    for (auto& entry : chunks) {
+        releaseTarget(*entry.second);
+        entry.second->dirty = true;
+    }
+}
@@ -0,0 +1,244 @@
+#include "WorldSerializer.h"
+#include <chrono>
+#include <iostream>
+
+namespace {
+    const char WorldMagic[4] = {'G', 'E', 'W', 'D'};
+    const std::uint32_t ByteOrderMark = 0x01020304;
+    const std::uint32_t EntityChunkId = WorldSerializer::makeChunkId("ENTS");
+
+    // Large stream buffer so bulk pool writes go to disk in big blocks
+    const std::size_t StreamBufferSize = 1 << 20;
+
+    template<typename T>
+    void WriteRaw(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadRaw(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    std::string ChunkName(std::uint32_t id) {
+        std::string name(4, ' ');
+        for (int i = 0; i < 4; i++) {
+            name[i] = static_cast<char>((id >> (i * 8)) & 0xFF);
+        }
+        return name;
+    }
+}
+
+void WorldSerializer::writeChunkHeader(std::ofstream& file, const ChunkHeader& header) {
+    WriteRaw(file, header.id);
+    WriteRaw(file, header.elementSize);
+    WriteRaw(file, header.count);
+    WriteRaw(file, header.payloadBytes);
+}
+
+bool WorldSerializer::readChunkHeader(std::ifstream& file, ChunkHeader& header) {
+    return ReadRaw(file, header.id) && ReadRaw(file, header.elementSize) &&
+           ReadRaw(file, header.count) && ReadRaw(file, header.payloadBytes);
+}
+
+std::uint64_t WorldSerializer::bytesLeft(std::ifstream& file) const {
+    auto position = file.tellg();
+    if (position < 0 || static_cast<std::uint64_t>(position) > fileBytes) return 0;
+    return fileBytes - static_cast<std::uint64_t>(position);
+}
+
+bool WorldSerializer::readEntities(std::ifstream& file, std::uint64_t count) {
+    if (count > bytesLeft(file) / sizeof(entt::entity)) return false;
+    scratchEntities.resize(count);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(scratchEntities.data()), count * sizeof(entt::entity)));
+}
+
+bool WorldSerializer::checkEntities(const entt::registry& registry) {
+    std::size_t checked = 0;
+    for (; checked < scratchEntities.size(); checked++) {
+        entt::entity entity = scratchEntities[checked];
+        if (!registry.valid(entity) || scratchSeen[entt::to_entity(entity)]) break;
+        scratchSeen[entt::to_entity(entity)] = 1;
+    }
+    bool unique = checked == scratchEntities.size();
+    for (std::size_t i = 0; i < checked; i++) {
+        scratchSeen[entt::to_entity(scratchEntities[i])] = 0;
+    }
+    return unique;
+}
+
+bool WorldSerializer::checkRegistered(const entt::registry& registry) const {
+    for (auto [id, storage] : registry.storage()) {
+        if (storage.empty() || id == entt::type_hash<entt::entity>::value()) continue;
+
+        bool registered = false;
+        for (const auto& handler : handlers) {
+            if (handler.typeId == id) {
+                registered = true;
+                break;
+            }
+        }
+        if (!registered) {
+            std::cerr << "WorldSerializer: component pool '" << storage.type().name()
+                      << "' is not registered for saving" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WorldSerializer::save(const entt::registry& registry, const std::string& path) {
+    if (!checkRegistered(registry)) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::ofstream file;
+    streamBuffer.resize(StreamBufferSize);
+    file.rdbuf()->pubsetbuf(streamBuffer.data(), streamBuffer.size());
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to open world file for writing: " << path << std::endl;
+        return false;
+    }
+
+    file.write(WorldMagic, sizeof(WorldMagic));
+    WriteRaw(file, Version);
+    WriteRaw(file, ByteOrderMark);
+    WriteRaw(file, static_cast<std::uint32_t>(handlers.size() + 1));
+
+    // Entity pool, including released ids so versions keep counting up after a load
+    const auto* entities = registry.storage<entt::entity>();
+    ChunkHeader header;
+    header.id = EntityChunkId;
+    header.elementSize = sizeof(entt::entity);
+    header.count = entities ? entities->size() : 0;
+    header.payloadBytes = sizeof(std::uint64_t) + header.count * sizeof(entt::entity);
+    writeChunkHeader(file, header);
+    WriteRaw(file, static_cast<std::uint64_t>(entities ? entities->in_use() : 0));
+    if (header.count > 0) {
+        file.write(reinterpret_cast<const char*>(entities->data()), header.count * sizeof(entt::entity));
+    }
+
+    for (const auto& handler : handlers) {
+        handler.save(registry, file);
+    }
+
+    lastBytes = static_cast<std::uint64_t>(file.tellp());
+    file.close();
+    if (!file) {
+        std::cerr << "Failed to write world file: " << path << std::endl;
+        return false;
+    }
+
+    lastMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+bool WorldSerializer::load(entt::registry& registry, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::ifstream file;
+    streamBuffer.resize(StreamBufferSize);
+    file.rdbuf()->pubsetbuf(streamBuffer.data(), streamBuffer.size());
+    file.open(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open world file: " << path << std::endl;
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    fileBytes = static_cast<std::uint64_t>(std::max<std::streamoff>(file.tellg(), 0));
+    file.seekg(0, std::ios::beg);
+
+    char magic[4];
+    std::uint32_t version = 0;
+    std::uint32_t byteOrder = 0;
+    std::uint32_t chunkCount = 0;
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, WorldMagic) ||
+        !ReadRaw(file, version) || !ReadRaw(file, byteOrder) || !ReadRaw(file, chunkCount)) {
+        std::cerr << "Not a world file: " << path << std::endl;
+        return false;
+    }
+    if (version != Version || byteOrder != ByteOrderMark) {
+        std::cerr << "Unsupported world file version or byte order: " << path << std::endl;
+        return false;
+    }
+
+    // The entity chunk always comes first
+    ChunkHeader header;
+    std::uint64_t inUse = 0;
+    if (!readChunkHeader(file, header) || header.id != EntityChunkId ||
+        header.elementSize != sizeof(entt::entity) || header.payloadBytes > bytesLeft(file) ||
+        !ReadRaw(file, inUse) || inUse > header.count || !readEntities(file, header.count)) {
+        std::cerr << "Corrupt entity chunk in world file: " << path << std::endl;
+        return false;
+    }
+
+    // Each id once, and none the pool would refuse: null's index or the tombstone version
+    using Traits = entt::entt_traits<entt::entity>;
+    scratchSeen.assign(static_cast<std::size_t>(Traits::entity_mask) + 1, 0);
+    for (auto entity : scratchEntities) {
+        std::uint8_t& seen = scratchSeen[entt::to_entity(entity)];
+        if (seen || entt::to_entity(entity) == Traits::entity_mask || entt::to_version(entity) == Traits::version_mask) {
+            std::cerr << "Corrupt entity chunk in world file: " << path << std::endl;
+            return false;
+        }
+        seen = 1;
+    }
+    std::fill(scratchSeen.begin(), scratchSeen.end(), 0);
+
+    // Chunks go into a fresh registry that replaces the caller's only once all of them loaded
+    entt::registry loaded;
+    auto& entities = loaded.storage<entt::entity>();
+    entities.reserve(scratchEntities.size());
+    for (auto entity : scratchEntities) {
+        entities.emplace(entity);
+    }
+    entities.in_use(inUse);
+
+    std::vector<std::uint32_t> loadedChunks;
+    for (std::uint32_t chunk = 1; chunk < chunkCount; chunk++) {
+        if (!readChunkHeader(file, header)) {
+            std::cerr << "Truncated world file: " << path << std::endl;
+            return false;
+        }
+
+        if (header.payloadBytes > bytesLeft(file)) {
+            std::cerr << "World chunk '" << ChunkName(header.id) << "' runs past the end of " << path << std::endl;
+            return false;
+        }
+
+        const PoolHandler* handler = nullptr;
+        for (const auto& candidate : handlers) {
+            if (candidate.chunkId == header.id) {
+                handler = &candidate;
+                break;
+            }
+        }
+
+        // A second chunk for the same pool would be appended to the first
+        if (std::find(loadedChunks.begin(), loadedChunks.end(), header.id) != loadedChunks.end()) {
+            std::cerr << "Duplicate world chunk '" << ChunkName(header.id) << "' in " << path << std::endl;
+            return false;
+        }
+        loadedChunks.push_back(header.id);
+
+        if (!handler) {
+            std::cout << "Skipping unknown world chunk '" << ChunkName(header.id) << "'" << std::endl;
+            file.seekg(static_cast<std::streamoff>(header.payloadBytes), std::ios::cur);
+            continue;
+        }
+
+        if (!handler->load(loaded, file, header)) {
+            std::cerr << "Failed to load world chunk '" << ChunkName(header.id) << "' from " << path << std::endl;
+            return false;
+        }
+    }
+
+    registry = std::move(loaded);
+
+    lastBytes = static_cast<std::uint64_t>(file.tellg());
+    lastMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
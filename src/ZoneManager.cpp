@@ -0,0 +1,382 @@
+#include "ZoneManager.h"
+#include "NetworkManager.h"
+#include "Physics.h"
+#include "RenderFrame.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+    double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::uint64_t GhostKey(std::size_t sourceZone, entt::entity source) {
+        return static_cast<std::uint64_t>(sourceZone) << 32 | entt::to_integral(source);
+    }
+
+    template<typename Component>
+    void copyComponent(entt::registry& from, entt::entity source, entt::registry& to, entt::entity target) {
+        if (const Component* component = from.try_get<Component>(source)) {
+            to.emplace<Component>(target, *component);
+        }
+    }
+
+    // Recreates an entity with all its components in another zone's registry;
+    // sets modelPending if it brings a model the target has not loaded yet
+    entt::entity moveEntity(ECSSystem& fromSystem, entt::entity entity, ECSSystem& toSystem, bool& modelPending) {
+        entt::registry& from = fromSystem.getRegistry();
+        entt::registry& to = toSystem.getRegistry();
+        entt::entity moved = to.create();
+        forEachComponentType([&](auto tag, const char*, const char*) {
+            using Component = typename decltype(tag)::type;
+            if constexpr (!std::is_same_v<Component, Model3D>) {
+                copyComponent<Component>(from, entity, to, moved);
+            }
+        });
+        // Zone bookkeeping, not part of the saved world
+        copyComponent<RemotePlayer>(from, entity, to, moved);
+        // Model handles index the owning system's model table
+        if (const Model3D* model3D = from.try_get<Model3D>(entity)) {
+            Model3D copy = *model3D;
+            if (copy.model != Model3D::InvalidModel) {
+                bool loaded = fromSystem.isModelLoaded(copy.model);
+                copy.model = toSystem.addModel(fromSystem.getModelPath(copy.model));
+                modelPending = modelPending || (loaded && !toSystem.isModelLoaded(copy.model));
+            }
+            to.emplace<Model3D>(moved, copy);
+        }
+        from.destroy(entity);
+        return moved;
+    }
+}
+
+ZoneManager::ZoneManager(const ZoneConfig& zoneConfig)
+    : config(zoneConfig)
+    , stopping(false) {
+    config.zoneCount = std::max<std::size_t>(1, config.zoneCount);
+    config.zoneWidth = std::max(1.0f, config.zoneWidth);
+
+    for (std::size_t i = 0; i < config.zoneCount; i++) {
+        auto zone = std::make_unique<Zone>();
+        zone->index = i;
+        if (config.physics) {
+            PhysicsConfig physicsConfig;
+            physicsConfig.threadCount = 1;
+            zone->physics = std::make_unique<PhysicsWorld>(physicsConfig);
+        }
+        zones.push_back(std::move(zone));
+    }
+
+#ifndef __EMSCRIPTEN__
+    // Without threads (web builds) step() simulates the zones one after another
+    if (zones.size() > 1) {
+        barrier = std::make_unique<boost::barrier>(static_cast<unsigned int>(zones.size()));
+        for (std::size_t i = 1; i < zones.size(); i++) {
+            workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+#endif
+
+    std::cout << "Zones: " << zones.size() << " strips of " << config.zoneWidth << " units, "
+              << workers.size() << " worker threads" << std::endl;
+}
+
+ZoneManager::~ZoneManager() {
+    if (barrier) {
+        // Release the workers from their start barrier; they see the flag and exit
+        stopping = true;
+        barrier->wait();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+std::size_t ZoneManager::zoneAt(Vector2 position) const {
+    float column = std::floor((position.x - config.originX) / config.zoneWidth);
+    if (!(column > 0.0f)) return 0;  // also catches NaN
+    return std::min(zones.size() - 1, static_cast<std::size_t>(column));
+}
+
+std::size_t ZoneManager::getEntityCount(std::size_t index) {
+    // Every ghost has a transform
+    Zone& zone = *zones[index];
+    return zone.ecs.getRegistry().storage<ECSTransform>().size() - zone.ghosts.size();
+}
+
+std::size_t ZoneManager::adoptEntities(ECSSystem& source, entt::entity keep) {
+    entt::registry& registry = source.getRegistry();
+    std::vector<entt::entity> moving;
+    for (auto [entity, transform] : registry.view<ECSTransform>().each()) {
+        if (entity != keep) {
+            moving.push_back(entity);
+        }
+    }
+
+    // Fill each zone's entity storage in one go
+    std::vector<std::size_t> counts(zones.size(), 0);
+    for (entt::entity entity : moving) {
+        counts[zoneAt(registry.get<ECSTransform>(entity).position)]++;
+    }
+    for (std::size_t i = 0; i < zones.size(); i++) {
+        auto& entities = zones[i]->ecs.getRegistry().storage<entt::entity>();
+        entities.reserve(entities.size() + counts[i]);
+    }
+
+    for (entt::entity entity : moving) {
+        std::size_t index = zoneAt(registry.get<ECSTransform>(entity).position);
+        moveEntity(source, entity, zones[index]->ecs, modelsPending);
+    }
+    return moving.size();
+}
+
+std::size_t ZoneManager::loadPendingModels() {
+    if (!modelsPending) return 0;
+    modelsPending = false;
+    std::size_t loaded = 0;
+    for (auto& zone : zones) {
+        loaded += zone->ecs.reloadModels();
+    }
+    return loaded;
+}
+
+void ZoneManager::unloadModels() {
+    for (auto& zone : zones) {
+        zone->ecs.unloadModels();
+    }
+}
+
+void ZoneManager::setPeerPosition(ENetPeer* peer, Vector2 position) {
+    auto found = peers.find(peer);
+    if (found != peers.end()) {
+        // Crossing into another zone is picked up by the next step's handoff
+        zones[found->second.zone]->ecs.getComponent<ECSTransform>(found->second.entity).position = position;
+        return;
+    }
+
+    std::size_t index = zoneAt(position);
+    ECSSystem& ecs = zones[index]->ecs;
+    entt::entity entity = ecs.createEntity();
+    ecs.addComponent(entity, ECSTransform{position});
+    ecs.addComponent(entity, Renderable{SKYBLUE});
+    ecs.addComponent(entity, CircleShape{20.0f});
+    ecs.addComponent(entity, RemotePlayer{peer, peer->connectID});
+    peers[peer] = PeerLocation{index, entity};
+    notifyZone(peer, index);
+}
+
+void ZoneManager::workerLoop(std::size_t index) {
+    while (true) {
+        barrier->wait();
+        if (stopping) return;
+        simulateZone(*zones[index], stepDeltaTime);
+        barrier->wait();
+    }
+}
+
+void ZoneManager::step(float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+
+    // The barrier publishes stepDeltaTime to the workers and, on the way out,
+    // their zone state back to this thread
+    stepDeltaTime = deltaTime;
+    if (barrier) {
+        barrier->wait();
+        simulateZone(*zones[0], deltaTime);
+        barrier->wait();
+    } else {
+        for (auto& zone : zones) {
+            simulateZone(*zone, deltaTime);
+        }
+    }
+
+    stats.parallelMicroseconds = MicrosecondsSince(start);
+    stats.slowestZoneMicroseconds = 0.0;
+    for (const auto& zone : zones) {
+        stats.slowestZoneMicroseconds = std::max(stats.slowestZoneMicroseconds, zone->lastStepMicroseconds);
+    }
+
+    auto serialStart = std::chrono::steady_clock::now();
+    removeDisconnectedPeers();
+    migrate();
+    refreshGhosts();
+    stats.serialMicroseconds = MicrosecondsSince(serialStart);
+}
+
+void ZoneManager::simulateZone(Zone& zone, float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+    entt::registry& registry = zone.ecs.getRegistry();
+
+    zone.ecs.updateMovement(deltaTime);
+    if (zone.physics) {
+        zone.physics->step(registry, deltaTime);
+    }
+
+    // Owned entities that moved out of this strip are handed off afterwards
+    for (auto [entity, transform] : registry.view<ECSTransform>(entt::exclude<Ghost>).each()) {
+        if (zoneAt(transform.position) != zone.index) {
+            zone.leaving.push_back(entity);
+        }
+    }
+
+    // Each client served by this zone gets the other players it can see,
+    // including ghosts of players just across a boundary
+    float viewRadiusSquared = config.viewRadius * config.viewRadius;
+    auto players = registry.view<ECSTransform, RemotePlayer>();
+    auto ghostView = registry.view<ECSTransform, Ghost>();
+    char message[64];
+    for (auto [viewer, viewerTransform, viewerPlayer] : players.each()) {
+        auto visible = [&](const ECSTransform& other, std::int32_t peerId) {
+            float dx = other.position.x - viewerTransform.position.x;
+            float dy = other.position.y - viewerTransform.position.y;
+            if (dx * dx + dy * dy > viewRadiusSquared) return;
+            int length = std::snprintf(message, sizeof(message), "PEER:%d:%.1f,%.1f", peerId, other.position.x, other.position.y);
+            queueMessage(zone, viewerPlayer.peer, message, length, MessageChannel::State);
+        };
+
+        for (auto [other, otherTransform, otherPlayer] : players.each()) {
+            if (other != viewer) {
+                visible(otherTransform, otherPlayer.peer->incomingPeerID);
+            }
+        }
+        for (auto [ghost, ghostTransform, ghostInfo] : ghostView.each()) {
+            if (ghostInfo.peerId >= 0) {
+                visible(ghostTransform, ghostInfo.peerId);
+            }
+        }
+    }
+
+    zone.lastStepMicroseconds = MicrosecondsSince(start);
+}
+
+void ZoneManager::queueMessage(Zone& zone, ENetPeer* peer, const char* message, int length, MessageChannel channel) {
+    if (length <= 0) return;
+
+    OutgoingMessage outgoing;
+    outgoing.peer = peer;
+    outgoing.offset = zone.outboxBuffer.size();
+    outgoing.length = static_cast<std::size_t>(length);
+    outgoing.channel = channel;
+    zone.outboxBuffer.insert(zone.outboxBuffer.end(), message, message + length);
+    zone.outbox.push_back(outgoing);
+}
+
+void ZoneManager::sendUpdates(NetworkManager& network) {
+    for (const auto& zone : zones) {
+        for (const auto& outgoing : zone->outbox) {
+            network.SendMessageTo(outgoing.peer, std::string_view(zone->outboxBuffer.data() + outgoing.offset, outgoing.length),
+                                  outgoing.channel);
+        }
+        zone->outboxBuffer.clear();
+        zone->outbox.clear();
+    }
+}
+
+void ZoneManager::migrate() {
+    stats.migrations = 0;
+    for (auto& zone : zones) {
+        for (entt::entity entity : zone->leaving) {
+            entt::registry& registry = zone->ecs.getRegistry();
+            if (!registry.valid(entity)) continue;
+
+            std::size_t destination = zoneAt(registry.get<ECSTransform>(entity).position);
+            Zone& target = *zones[destination];
+            entt::entity moved = moveEntity(zone->ecs, entity, target.ecs, modelsPending);
+            stats.migrations++;
+
+            // The client is now served by the destination zone
+            if (const RemotePlayer* player = target.ecs.getRegistry().try_get<RemotePlayer>(moved)) {
+                peers[player->peer] = PeerLocation{destination, moved};
+                notifyZone(player->peer, destination);
+            }
+        }
+        zone->leaving.clear();
+    }
+    stats.totalMigrations += stats.migrations;
+}
+
+void ZoneManager::refreshGhosts() {
+    ghostGeneration++;
+
+    for (std::size_t i = 0; i < zones.size(); i++) {
+        entt::registry& registry = zones[i]->ecs.getRegistry();
+        float left = config.originX + static_cast<float>(i) * config.zoneWidth;
+        float right = left + config.zoneWidth;
+
+        for (auto [entity, transform] : registry.view<ECSTransform>(entt::exclude<Ghost>).each()) {
+            const RemotePlayer* player = registry.try_get<RemotePlayer>(entity);
+            std::int32_t peerId = player ? static_cast<std::int32_t>(player->peer->incomingPeerID) : -1;
+            if (i > 0 && transform.position.x < left + config.ghostMargin) {
+                ghostInto(*zones[i - 1], i, entity, transform, peerId);
+            }
+            if (i + 1 < zones.size() && transform.position.x >= right - config.ghostMargin) {
+                ghostInto(*zones[i + 1], i, entity, transform, peerId);
+            }
+        }
+    }
+
+    // Ghosts whose source moved away from the boundary, migrated or died
+    stats.ghosts = 0;
+    for (auto& zone : zones) {
+        entt::registry& registry = zone->ecs.getRegistry();
+        for (auto it = zone->ghosts.begin(); it != zone->ghosts.end();) {
+            if (registry.get<Ghost>(it->second).generation != ghostGeneration) {
+                registry.destroy(it->second);
+                it = zone->ghosts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        stats.ghosts += zone->ghosts.size();
+    }
+}
+
+void ZoneManager::ghostInto(Zone& target, std::size_t sourceZone, entt::entity source, const ECSTransform& transform,
+                            std::int32_t peerId) {
+    entt::registry& registry = target.ecs.getRegistry();
+    auto [it, inserted] = target.ghosts.try_emplace(GhostKey(sourceZone, source), entt::null);
+    if (inserted) {
+        it->second = registry.create();
+        registry.emplace<ECSTransform>(it->second, transform);
+        registry.emplace<Ghost>(it->second, Ghost{static_cast<std::uint32_t>(sourceZone), source, peerId, ghostGeneration});
+        return;
+    }
+
+    registry.get<ECSTransform>(it->second) = transform;
+    Ghost& ghost = registry.get<Ghost>(it->second);
+    ghost.peerId = peerId;
+    ghost.generation = ghostGeneration;
+}
+
+void ZoneManager::removeDisconnectedPeers() {
+    for (auto it = peers.begin(); it != peers.end();) {
+        ENetPeer* peer = it->first;
+        ECSSystem& ecs = zones[it->second.zone]->ecs;
+        // A reused peer slot has a new connect id
+        bool gone = peer->state != ENET_PEER_STATE_CONNECTED ||
+                    ecs.getComponent<RemotePlayer>(it->second.entity).connectId != peer->connectID;
+        if (gone) {
+            ecs.destroyEntity(it->second.entity);
+            it = peers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ZoneManager::notifyZone(ENetPeer* peer, std::size_t zone) {
+    char message[32];
+    int length = std::snprintf(message, sizeof(message), "ZONE:%zu", zone);
+    queueMessage(*zones[zone], peer, message, length, MessageChannel::Reliable);
+}
+
+void ZoneManager::buildRenderCommands(RenderFrame& frame) {
+    // Ghosts carry no Renderable, so each entity is drawn once by its owner
+    for (auto& zone : zones) {
+        zone->ecs.setCameraOffset(frame.cameraOffset);
+        zone->ecs.buildRenderCommands(frame);
+    }
+}
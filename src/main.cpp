@@ -1,4 +1,7 @@
 #include "Game.h"
+#include "Physics.h"
+#include "SpriteAtlas.h"
+#include <cstdint>
 #include <iostream>
 #include <boost/program_options.hpp>
 
@@ -12,11 +15,42 @@ int main(int argc, char* argv[]) {
         ("server,s", "Start in server mode")
         ("client,c", "Start in client mode (default)")
         ("port,p", po::value<int>()->default_value(12345), "Network port (default: 12345)")
+        ("max-clients", po::value<int>()->default_value(32), "Maximum connected clients in server mode (default: 32, up to 4095)")
+        ("net-stats", po::value<std::string>(), "Periodically write network telemetry to <path>.csv and <path>.json")
+        ("net-stats-interval", po::value<double>()->default_value(5.0), "Seconds between network telemetry dumps (default: 5)")
+        ("compression", po::value<std::string>()->default_value("adaptive"), "Packet compression: adaptive or off (default: adaptive)")
+        ("range-coder", "Also compress datagrams with ENet's range coder (server and clients must agree)")
+        ("zones", po::value<int>()->default_value(1), "Server: split the world into this many zones, one thread each (default: 1)")
+        ("zone-width", po::value<float>()->default_value(500.0f), "Width of each zone strip in world units (default: 500)")
+        ("no-physics", "Disable collisions and rigid bodies")
+        ("physics-threads", po::value<int>()->default_value(0), "Threads for the collision narrowphase, 0 = all hardware threads (default: 0)")
+        ("physics-bench", po::value<int>()->implicit_value(10000), "Step this many colliding bodies headless for 10 s of game time, print step times and exit (default: 10000)")
+        ("no-navigation", "Disable flow-field steering of navigation agents")
+        ("nav-threads", po::value<int>()->default_value(0), "Threads for flow-field builds and steering, 0 = all hardware threads (default: 0)")
+        ("no-particles", "Disable particle effects")
+        ("particle-capacity", po::value<int>()->default_value(100000), "Particles in the fountain emitter's pool, 0 = no fountain (default: 100000)")
+        ("compact-interval", po::value<float>()->default_value(10.0f), "Seconds between idle-tick ECS storage compactions, 0 = never (default: 10)")
+        ("no-render-thread", "Simulate and draw on the main thread, one after the other")
         ("host", po::value<std::string>()->default_value("127.0.0.1"), "Server host for client mode (default: 127.0.0.1)")
         ("verbose,v", "Enable verbose output")
         ("fullscreen,f", "Start in fullscreen mode")
         ("width", po::value<int>()->default_value(800), "Window width (default: 800)")
-        ("height", po::value<int>()->default_value(600), "Window height (default: 600)");
+        ("height", po::value<int>()->default_value(600), "Window height (default: 600)")
+        ("headless", "Run without a window (no rendering or keyboard input)")
+        ("deterministic", "Fixed tick simulation with a seeded RNG")
+        ("tick-rate", po::value<float>()->default_value(60.0f), "Simulation ticks per second in deterministic mode (default: 60)")
+        ("seed", po::value<std::uint64_t>()->default_value(1), "Random seed for deterministic mode (default: 1)")
+        ("record", po::value<std::string>(), "Record per-tick inputs and network messages to a replay file")
+        ("replay", po::value<std::string>(), "Replay a recording headless as fast as possible and verify the final state")
+        ("rollback-window", po::value<int>()->default_value(0), "Keep world snapshots for rolling back this many ticks (deterministic mode, F6 to test)")
+        ("world", po::value<std::string>()->default_value("world.sav"), "World file used by quick save (F5) and quick load (F9)")
+        ("load-world", po::value<std::string>(), "Load a saved world at startup instead of the default world")
+        ("atlas", po::value<std::string>()->default_value("sprites"), "Sprite atlas cache, <path>.atlas plus page PNGs (default: sprites)")
+        ("build-atlas", "Pack assets/Side and assets/Isometric into the sprite atlas and exit")
+        ("soak", "Run the scripted soak test as a server and exit non-zero if memory, handles or frame times trend upward")
+        ("soak-duration", po::value<double>()->default_value(3600.0), "Soak test length in seconds (default: 3600)")
+        ("soak-interval", po::value<double>()->default_value(30.0), "Seconds between soak test samples (default: 30)")
+        ("soak-report", po::value<std::string>(), "Also write soak test samples to a CSV file");
     
     po::variables_map vm;
     
@@ -45,6 +79,124 @@ int main(int argc, char* argv[]) {
     int width = vm["width"].as<int>();
     int height = vm["height"].as<int>();
     
+    GameOptions options;
+    options.isServer = isServer;
+    options.port = port;
+    options.host = host;
+    options.width = width;
+    options.height = height;
+    options.fullscreen = fullscreen;
+    options.verbose = verbose;
+    options.headless = vm.count("headless") > 0;
+    options.deterministic = vm.count("deterministic") > 0;
+    options.tickRate = vm["tick-rate"].as<float>();
+    options.seed = vm["seed"].as<std::uint64_t>();
+    if (vm.count("record")) {
+        options.recordPath = vm["record"].as<std::string>();
+    }
+    if (vm.count("replay")) {
+        options.replayPath = vm["replay"].as<std::string>();
+    }
+    options.rollbackWindow = vm["rollback-window"].as<int>();
+    options.maxClients = vm["max-clients"].as<int>();
+    if (vm.count("net-stats")) {
+        options.netStatsPath = vm["net-stats"].as<std::string>();
+    }
+    options.netStatsInterval = vm["net-stats-interval"].as<double>();
+    std::string compression = vm["compression"].as<std::string>();
+    if (compression != "adaptive" && compression != "off") {
+        std::cerr << "Compression must be adaptive or off" << std::endl;
+        return 1;
+    }
+    options.compression = compression == "adaptive";
+    options.rangeCoder = vm.count("range-coder") > 0;
+    options.zones = vm["zones"].as<int>();
+    options.zoneWidth = vm["zone-width"].as<float>();
+    options.physics = vm.count("no-physics") == 0;
+    options.physicsThreads = vm["physics-threads"].as<int>();
+    options.navigation = vm.count("no-navigation") == 0;
+    options.navigationThreads = vm["nav-threads"].as<int>();
+    options.particles = vm.count("no-particles") == 0;
+    options.particleCapacity = vm["particle-capacity"].as<int>();
+    options.compactInterval = vm["compact-interval"].as<float>();
+    options.renderThread = vm.count("no-render-thread") == 0;
+    options.worldPath = vm["world"].as<std::string>();
+    if (vm.count("load-world")) {
+        options.worldPath = vm["load-world"].as<std::string>();
+        options.loadWorld = true;
+    }
+    options.atlasPath = vm["atlas"].as<std::string>();
+    options.soak = vm.count("soak") > 0;
+    options.soakDuration = vm["soak-duration"].as<double>();
+    options.soakInterval = vm["soak-interval"].as<double>();
+    if (vm.count("soak-report")) {
+        options.soakReportPath = vm["soak-report"].as<std::string>();
+    }
+    
+    // Offline atlas packing needs no window: images are packed and written on the CPU
+    if (vm.count("build-atlas")) {
+        SpriteAtlas atlas;
+        if (!atlas.build(SpriteAtlas::getDefaultSources("assets")) || !atlas.save(options.atlasPath)) {
+            std::cerr << "Failed to build sprite atlas " << options.atlasPath << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << options.atlasPath << ".atlas with " << atlas.getPageCount() << " pages" << std::endl;
+        return 0;
+    }
+    
+    if (options.tickRate <= 0.0f) {
+        std::cerr << "Tick rate must be positive" << std::endl;
+        return 1;
+    }
+    
+    if (options.zones < 1 || options.zoneWidth <= 0.0f) {
+        std::cerr << "Zones must be at least 1 and zone width positive" << std::endl;
+        return 1;
+    }
+    
+    if (options.compactInterval < 0.0f) {
+        std::cerr << "Compaction interval must not be negative" << std::endl;
+        return 1;
+    }
+    
+    if (options.physicsThreads < 0) {
+        std::cerr << "Physics threads must not be negative" << std::endl;
+        return 1;
+    }
+    
+    // Measures physics alone, without a window or the rest of the game
+    if (vm.count("physics-bench")) {
+        int bodies = vm["physics-bench"].as<int>();
+        if (bodies <= 0) {
+            std::cerr << "Physics benchmark needs at least one body" << std::endl;
+            return 1;
+        }
+        runPhysicsBenchmark(static_cast<std::size_t>(bodies), static_cast<std::size_t>(options.physicsThreads), 600);
+        return 0;
+    }
+    if (options.navigationThreads < 0) {
+        std::cerr << "Navigation threads must not be negative" << std::endl;
+        return 1;
+    }
+    if (options.particleCapacity < 0) {
+        std::cerr << "Particle capacity must not be negative" << std::endl;
+        return 1;
+    }
+    
+    // The soak test's loopback clients connect to this process's own server
+    if (options.soak) {
+        if (options.deterministic || !options.recordPath.empty() || !options.replayPath.empty()) {
+            std::cerr << "Soak test cannot be combined with deterministic, record or replay mode" << std::endl;
+            return 1;
+        }
+        if (options.soakDuration <= 0.0 || options.soakInterval <= 0.0) {
+            std::cerr << "Soak duration and interval must be positive" << std::endl;
+            return 1;
+        }
+        isServer = true;
+        options.isServer = true;
+    }
+    
     if (verbose) {
         std::cout << "Command line options:" << std::endl;
         std::cout << "  Mode: " << (isServer ? "Server" : "Client") << std::endl;
@@ -53,6 +205,9 @@ int main(int argc, char* argv[]) {
             std::cout << "  Host: " << host << std::endl;
         }
         std::cout << "  Window: " << width << "x" << height << (fullscreen ? " (fullscreen)" : "") << std::endl;
+        if (options.deterministic || !options.recordPath.empty() || !options.replayPath.empty()) {
+            std::cout << "  Deterministic: " << options.tickRate << " Hz, seed " << options.seed << std::endl;
+        }
         std::cout << std::endl;
     }
     
@@ -62,7 +217,7 @@ int main(int argc, char* argv[]) {
     Game game;
     
     try {
-        game.Initialize(isServer, port, host, width, height, fullscreen);
+        game.Initialize(options);
         
         // Main game loop
         while (game.IsRunning()) {
@@ -78,5 +233,5 @@ int main(int argc, char* argv[]) {
     }
     
     std::cout << "Game Engine shutdown complete." << std::endl;
-    return 0;
+    return game.GetExitCode();
 }